@@ -3,6 +3,10 @@ QT       += network
 greaterThan(QT_MAJOR_VERSION, 4): QT += widgets
 
 CONFIG += c++17
+
+# Exported symbols let the stall watchdog name the functions in its stack samples
+linux: QMAKE_LFLAGS += -rdynamic
+
 # You can make your code fail to compile if it uses deprecated APIs.
 # In order to do so, uncomment the following line.
 #DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0x060000    # disables all the APIs deprecated before Qt 6.0.0
@@ -10,28 +14,84 @@ CONFIG += c++17
 SOURCES += \
     addcardwindow.cpp \
     addlistwindow.cpp \
+    backupstore.cpp \
+    backupworker.cpp \
+    catchupplanner.cpp \
+    changebus.cpp \
     database.cpp \
+    diagnosticsdialog.cpp \
+    dialogopentimer.cpp \
+    listpurgeworker.cpp \
     main.cpp \
+    maintenancescheduler.cpp \
     mainwindow.cpp \
+    metrics.cpp \
     spacedrepetitioncalculator.cpp \
+    sqlprofiler.cpp \
+    stallwatchdog.cpp \
     aicreatewindow.cpp \
+    aistreamparser.cpp \
+    aivocabgenerator.cpp \
     sqlite3.c \
     decklistpanel.cpp \
+    decktablemodel.cpp \
+    deckoverviewcache.cpp \
+    deckoverviewloader.cpp \
+    distractorbuilder.cpp \
+    distractorindex.cpp \
+    enrichmentjob.cpp \
+    fsrs.cpp \
+    fsrsfitworker.cpp \
+    fsrsoptimizer.cpp \
+    idlemonitor.cpp \
     modeselectorpanel.cpp \
-    studypanel.cpp
+    orphancollector.cpp \
+    querycache.cpp \
+    studypanel.cpp \
+    tracing.cpp \
+    tracingapplication.cpp
 
 HEADERS += \
     addcardwindow.h \
     addlistwindow.h \
+    backupstore.h \
+    backupworker.h \
+    catchupplanner.h \
+    changebus.h \
     database.h \
+    diagnosticsdialog.h \
+    dialogopentimer.h \
+    listpurgeworker.h \
+    maintenancescheduler.h \
     mainwindow.h \
+    metrics.h \
     spacedrepetitioncalculator.h \
+    sqlprofiler.h \
+    stallwatchdog.h \
     aicreatewindow.h \
+    aistreamparser.h \
+    aivocabgenerator.h \
     sqlite3.h \
     decklistpanel.h \
+    decktablemodel.h \
+    deckoverviewcache.h \
+    deckoverviewloader.h \
+    distractorbuilder.h \
+    distractorindex.h \
+    enrichmentjob.h \
+    fsrs.h \
+    fsrsfitworker.h \
+    fsrsoptimizer.h \
+    idlemonitor.h \
+    loadbalancer.h \
     modeselectorpanel.h \
+    orphancollector.h \
+    querycache.h \
+    schedulerpolicy.h \
     studypanel.h \
-    themeutils.h
+    themeutils.h \
+    tracing.h \
+    tracingapplication.h
 
 FORMS += \
     addcardwindow.ui \
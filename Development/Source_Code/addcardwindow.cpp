@@ -1,6 +1,5 @@
 #include "addcardwindow.h"
 #include "ui_addcardwindow.h"
-#include "themeutils.h"
 #include <QMessageBox>
 #include <QRegularExpression>
 #include <QDebug>
@@ -36,10 +35,6 @@ void AddCardWindow::on_toggleAdditionalOptionsButton_toggled(bool checked) {
     }
 }
 
-void AddCardWindow::applyTheme(bool isDark) {
-    this->setStyleSheet(isDark ? ThemeUtils::getDarkTheme() : ThemeUtils::getLightTheme());
-}
-
 void AddCardWindow::on_cancelAdding_clicked() {
     reject();
 }
@@ -105,6 +100,7 @@ void AddCardWindow::on_addButton_clicked() {
 
     try {
         int wordID = db->addWordAndSetup(listID, word, partOfSpeech, definition, "");
+        emit wordsAdded(listID);
 
         // If additional options checked, create example, notes, and/or relations
         if (ui->additionalOptionsBox->isChecked()) {
@@ -15,7 +15,9 @@ class AddCardWindow : public QDialog
 public:
     explicit AddCardWindow(QWidget *parent = nullptr, DataBase* dataBase = nullptr);
     ~AddCardWindow();
-    void applyTheme(bool isDark);
+
+signals:
+    void wordsAdded(int listID);
 
 private slots:
     void on_cancelAdding_clicked();
@@ -1,6 +1,5 @@
 #include "addlistwindow.h"
 #include "ui_addlistwindow.h"
-#include "themeutils.h"
 
 AddListWindow::AddListWindow(QWidget *parent, DataBase* dataBase)
     : QDialog(parent)
@@ -14,10 +13,6 @@ AddListWindow::~AddListWindow() {
     delete ui;
 }
 
-void AddListWindow::applyTheme(bool isDark) {
-    setStyleSheet(isDark ? ThemeUtils::getDarkTheme() : ThemeUtils::getLightTheme());
-}
-
 void AddListWindow::on_cancelCreation_clicked() {
     reject();
 }
@@ -16,7 +16,6 @@ public:
     explicit AddListWindow(QWidget *parent = nullptr, DataBase* dataBase = nullptr);
     ~AddListWindow();
 
-    void applyTheme(bool isDark);
 
 signals:
     void newAddedList();
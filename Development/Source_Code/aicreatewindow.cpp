@@ -1,18 +1,18 @@
 #include "aicreatewindow.h"
 #include "ui_aicreatewindow.h"
-#include "themeutils.h"
-#include <QNetworkRequest>
-#include <QNetworkReply>
-#include <QJsonDocument>
-#include <QJsonObject>
-#include <QJsonArray>
 #include <QInputDialog>
 #include <QMessageBox>
-#include <QUrl>
-#include <QByteArray>
+#include <QJsonDocument>
+#include <QJsonObject>
 #include <QDebug>
 #include <cstdlib>
 
+namespace {
+// Cached generations are reused for 30 days and the cache is kept under 16 MB
+const long long kCacheMaxAgeSeconds = 30LL * 24 * 3600;
+const long long kCacheMaxBytes = 16LL * 1024 * 1024;
+}
+
 AICreateWindow::AICreateWindow(QWidget* parent, DataBase* db_)
     : QDialog(parent), db(db_) {
     ui = new Ui::AICreateWindow();
@@ -22,21 +22,19 @@ AICreateWindow::AICreateWindow(QWidget* parent, DataBase* db_)
     ui->modelCombo->addItem("gpt-3.5-turbo");
     ui->modelCombo->addItem("gpt-4o-mini");
 
-    manager = new QNetworkAccessManager(this);
-    connect(manager, &QNetworkAccessManager::finished, this, &AICreateWindow::onNetworkReplyFinished);
+    ui->concurrencySpin->setValue(AIVocabGenerator::DEFAULT_MAX_CONCURRENT);
 
-    // explicitly connect generate button to slot
-    connect(ui->generateButton, &QPushButton::clicked, this, &AICreateWindow::on_generateButton_clicked);
+    generator = new AIVocabGenerator(this);
+    connect(generator, &AIVocabGenerator::entriesReady, this, &AICreateWindow::onEntriesReady);
+    connect(generator, &AIVocabGenerator::finished, this, &AICreateWindow::onGenerationFinished);
+
+    // generateButton is already connected by name (on_generateButton_clicked) in setupUi
 }
 
 AICreateWindow::~AICreateWindow() {
     delete ui;
 }
 
-void AICreateWindow::applyTheme(bool isDark) {
-    setStyleSheet(isDark ? ThemeUtils::getDarkTheme() : ThemeUtils::getLightTheme());
-}
-
 static QString fetchApiKeyInteractive(QWidget* parent) {
     // Try environment variable first
     const char* env = std::getenv("OPENAI_API_KEY");
@@ -61,6 +59,25 @@ void AICreateWindow::on_generateButton_clicked() {
     QString customPrompt = ui->promptEdit->toPlainText().trimmed();
     QString model = ui->modelCombo->currentText();
 
+    AIVocabRequest request;
+    request.model = model;
+    request.listName = listName;
+    request.customPrompt = customPrompt;
+    request.wordCount = count;
+    request.stream = ui->streamCheck->isChecked();
+
+    requestedListName = listName;
+    pendingWords.clear();
+    targetListID = -1;
+    addedCount = 0;
+    generatedEntries = QJsonArray();
+    requestCacheKey = AIVocabGenerator::cacheKey(request);
+
+    // An identical earlier generation skips the network (and the API key prompt) entirely
+    if (ui->cacheCheck->isChecked() && addFromCache(requestCacheKey)) {
+        return;
+    }
+
     QString apiKey = fetchApiKeyInteractive(this);
     if (apiKey.isEmpty()) {
         qWarning() << "OpenAI API key not found";
@@ -68,144 +85,130 @@ void AICreateWindow::on_generateButton_clicked() {
         return;
     }
 
-    // Build the system+user messages to request a JSON array of words and definitions.
-    QJsonObject root;
-    root["model"] = model;
-
-    QJsonArray messages;
-    QJsonObject systemMsg;
-    systemMsg["role"] = "system";
-    systemMsg["content"] = "You are a helpful assistant that outputs JSON only."
-                         " When asked, produce a JSON array of objects with keys 'word' and 'definition'.";
-    messages.append(systemMsg);
-
-    QJsonObject userMsg;
-    userMsg["role"] = "user";
-    QString userRequest = QString("Generate %1 vocabulary entries for a list named '%2'. "
-                                  "Return ONLY a JSON array like [{\"word\": \"...\", \"definition\": \"...\"}, ...].\n")
-                          .arg(count).arg(listName);
-    if (!customPrompt.isEmpty()) {
-        userRequest += "Additional instructions: \n" + customPrompt + "\n";
-    }
-    userMsg["content"] = userRequest;
-    messages.append(userMsg);
-
-    QJsonObject body;
-    body["model"] = model;
-    body["messages"] = messages;
-    body["max_tokens"] = 1500;
-    body["temperature"] = 0.8;
-
-    QNetworkRequest request(QUrl("https://api.openai.com/v1/chat/completions"));
-    request.setRawHeader("Authorization", QString("Bearer %1").arg(apiKey).toUtf8());
-    request.setHeader(QNetworkRequest::ContentTypeHeader, "application/json");
-
-    QJsonDocument doc(body);
-    QByteArray payload = doc.toJson();
     ui->generateButton->setEnabled(false);
     ui->statusLabel->setText("Generating...");
+    generationTimer.start();
 
-    manager->post(request, payload);
+    generator->setApiKey(apiKey);
+    generator->setMaxConcurrentRequests(ui->concurrencySpin->value());
+    generator->start(request);
 }
 
-void AICreateWindow::onNetworkReplyFinished(QNetworkReply* reply) {
-    ui->generateButton->setEnabled(true);
-    QByteArray resp = reply->readAll();
-    reply->deleteLater();
-    ui->statusLabel->clear();
-
-    if (reply->error() != QNetworkReply::NoError) {
-        qCritical() << "Network error in AI vocabulary generation:" << reply->errorString();
-        QMessageBox::critical(this, "Network Error", reply->errorString());
-        return;
+void AICreateWindow::onEntriesReady(const QVector<AIVocabEntry>& entries) {
+    for (const auto &e : entries) {
+        QJsonObject o;
+        o["word"] = e.word;
+        o["definition"] = e.definition;
+        generatedEntries.append(o);
+        pendingWords.push_back(DataBase::NewWord{e.word.toStdString(), std::string(""), e.definition.toStdString(), std::string("")});
     }
+    if (pendingWords.size() < static_cast<size_t>(AIVocabGenerator::INSERT_BATCH_SIZE)) return;
 
-    // parse the response JSON and attempt to extract model output
-    QJsonDocument doc = QJsonDocument::fromJson(resp);
-    if (doc.isNull() || !doc.isObject()) {
-        qCritical() << "Invalid JSON response from OpenAI API";
-        QMessageBox::critical(this, "API Error", "Invalid JSON response from API");
-        return;
+    try {
+        flushPendingWords();
+        ui->statusLabel->setText(QString("Generating... %1 words added").arg(addedCount));
+    } catch (const std::exception &ex) {
+        // Stop receiving more words; nothing else will be inserted
+        generator->abort();
+        pendingWords.clear();
+        ui->generateButton->setEnabled(true);
+        ui->statusLabel->clear();
+        if (targetListID >= 0) emit wordsAdded(targetListID);
+        qCritical() << "Database error during AI vocabulary list creation:" << ex.what();
+        QMessageBox::critical(this, "DB Error", QString::fromStdString(ex.what()));
     }
+}
 
-    QJsonObject obj = doc.object();
-    QJsonValue choicesVal = obj.value("choices");
-    QString textContent;
-    if (choicesVal.isArray()) {
-        QJsonArray choices = choicesVal.toArray();
-        if (!choices.isEmpty()) {
-            QJsonObject first = choices.at(0).toObject();
-            // chat completions: message.content
-            if (first.contains("message") && first.value("message").isObject()) {
-                textContent = first.value("message").toObject().value("content").toString();
-            } else if (first.contains("text")) {
-                textContent = first.value("text").toString();
-            }
-        }
-    }
+int AICreateWindow::ensureTargetList() {
+    if (targetListID >= 0) return targetListID;
 
-    if (textContent.isEmpty()) {
-        qCritical() << "OpenAI API returned no content";
-        QMessageBox::critical(this, "API Error", "API returned no content.");
-        return;
+    bool ok = db->createNewList(requestedListName.toStdString(), std::string(""), std::string("Created by AI"));
+    if (!ok) {
+        qCritical() << "Failed to create new list:" << requestedListName;
+        throw std::runtime_error("Failed to create new list.");
     }
-
-    // Try to parse textContent as JSON array
-    QJsonDocument listDoc = QJsonDocument::fromJson(textContent.toUtf8());
-    if (listDoc.isNull()) {
-        // Attempt to extract a JSON substring from the response
-        QByteArray b = textContent.toUtf8();
-        int start = b.indexOf('[');
-        int end = b.lastIndexOf(']');
-        if (start >= 0 && end > start) {
-            QByteArray sub = b.mid(start, end - start + 1);
-            listDoc = QJsonDocument::fromJson(sub);
-        }
+    targetListID = db->getListId(requestedListName.toStdString());
+    if (targetListID < 0) {
+        qCritical() << "Failed to create or retrieve new list id for AI-generated list:" << requestedListName;
+        throw std::runtime_error("Failed to create or retrieve new list id.");
     }
+    return targetListID;
+}
 
-    if (listDoc.isNull() || !listDoc.isArray()) {
-        qCritical() << "Could not parse OpenAI model output as JSON array. Response:" << textContent;
-        QMessageBox::critical(this, "Parse Error", "Could not parse the model output as a JSON array.\nResponse:\n" + textContent);
-        return;
-    }
+void AICreateWindow::flushPendingWords() {
+    if (pendingWords.empty()) return;
 
-    QJsonArray arr = listDoc.array();
-    if (arr.isEmpty()) {
-        QMessageBox::information(this, "No Results", "Model returned empty list.");
-        return;
-    }
+    int listID = ensureTargetList();
+    addedCount += db->addWordsAndSetup(listID, pendingWords);
+    pendingWords.clear();
+}
 
-    // Create the new list in the DB
-    QString listName = ui->listNameEdit->text().trimmed();
+bool AICreateWindow::addFromCache(const QString& cacheKey) {
     try {
-        bool ok = db->createNewList(listName.toStdString(), std::string(""), std::string("Created by AI"));
-        if (!ok) {
-            qCritical() << "Failed to create new list:" << listName;
-            throw std::runtime_error("Failed to create new list.");
-        }
-        int listID = db->getListId(listName.toStdString());
-        if (listID < 0) {
-            qCritical() << "Failed to create or retrieve new list id for AI-generated list:" << listName;
-            throw std::runtime_error("Failed to create or retrieve new list id.");
-        }
+        std::string cached;
+        if (!db->getCachedAIResponse(cacheKey.toStdString(), kCacheMaxAgeSeconds, cached)) return false;
 
-        int added = 0;
+        QJsonArray arr = QJsonDocument::fromJson(QByteArray::fromStdString(cached)).array();
         for (const QJsonValue &v : arr) {
-            if (!v.isObject()) continue;
             QJsonObject o = v.toObject();
-            QString w = o.value("word").toString().trimmed();
-            QString def = o.value("definition").toString().trimmed();
+            QString w = o.value("word").toString();
             if (w.isEmpty()) continue;
-            int wid = db->addWordAndSetup(listID, w.toStdString(), std::string(""), def.toStdString(), std::string(""));
-            if (wid >= 0) added++;
+            pendingWords.push_back(DataBase::NewWord{w.toStdString(), std::string(""), o.value("definition").toString().toStdString(), std::string("")});
         }
+        if (pendingWords.empty()) return false;
+
+        flushPendingWords();
+        emit wordsAdded(targetListID);
+    } catch (const std::exception &ex) {
+        qCritical() << "Database error during cached AI vocabulary list creation:" << ex.what();
+        QMessageBox::critical(this, "DB Error", QString::fromStdString(ex.what()));
+        return true;
+    }
+
+    QMessageBox::information(this, "Done", QString("Added %1 entries to list '%2' (from a previous identical generation).").arg(addedCount).arg(requestedListName));
+    accept();
+    return true;
+}
 
-        QMessageBox::information(this, "Done", QString("Added %1 entries to list '%2'.").arg(added).arg(listName));
-        accept();
+void AICreateWindow::onGenerationFinished(bool success, const QString& errorMessage) {
+    ui->generateButton->setEnabled(true);
+    ui->statusLabel->clear();
+
+    try {
+        flushPendingWords();
     } catch (const std::exception &ex) {
         qCritical() << "Database error during AI vocabulary list creation:" << ex.what();
         QMessageBox::critical(this, "DB Error", QString::fromStdString(ex.what()));
+        return;
+    }
+
+    qInfo() << "AI generation of" << addedCount << "words took" << generationTimer.elapsed() << "ms with"
+            << ui->concurrencySpin->value() << "parallel requests";
+
+    if (targetListID >= 0) emit wordsAdded(targetListID);
+
+    // Only complete generations are cached, so a hit always reproduces the full list
+    if (success && errorMessage.isEmpty() && !generatedEntries.isEmpty()) {
+        try {
+            QByteArray json = QJsonDocument(generatedEntries).toJson(QJsonDocument::Compact);
+            db->putCachedAIResponse(requestCacheKey.toStdString(), json.toStdString(), kCacheMaxBytes);
+        } catch (const std::exception &ex) {
+            qWarning() << "Could not cache AI generation:" << ex.what();
+        }
+    }
+
+    if (!success) {
+        qCritical() << "AI vocabulary generation failed:" << errorMessage;
+        QMessageBox::critical(this, "API Error", errorMessage.isEmpty() ? QString("The model returned no usable entries.") : errorMessage);
+        return;
+    }
+
+    QString message = QString("Added %1 entries to list '%2'.").arg(addedCount).arg(requestedListName);
+    if (!errorMessage.isEmpty()) {
+        message += "\n\nSome requests failed: " + errorMessage;
     }
+    QMessageBox::information(this, "Done", message);
+    accept();
 }
 
 void AICreateWindow::on_pushButton_clicked() {
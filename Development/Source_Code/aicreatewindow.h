@@ -2,9 +2,11 @@
 #define AICREATEWINDOW_H
 
 #include <QDialog>
+#include <QElapsedTimer>
+#include <QJsonArray>
+#include <vector>
 #include "database.h"
-#include <QNetworkAccessManager>
-#include <QNetworkReply>
+#include "aivocabgenerator.h"
 
 namespace Ui {
 class AICreateWindow;
@@ -16,19 +18,37 @@ public:
     explicit AICreateWindow(QWidget* parent = nullptr, DataBase* db = nullptr);
     ~AICreateWindow();
 
-    void applyTheme(bool isDark);
+signals:
+    void wordsAdded(int listID);
 
 private slots:
     void on_generateButton_clicked();
-    void onNetworkReplyFinished(QNetworkReply* reply);
+    void onEntriesReady(const QVector<AIVocabEntry>& entries);
+    void onGenerationFinished(bool success, const QString& errorMessage);
 
     void on_pushButton_clicked();
 
 private:
     Ui::AICreateWindow *ui;
 
+    // Creates the target list on first use; returns its id
+    int ensureTargetList();
+    // Writes queued entries through DataBase::addWordsAndSetup in one transaction
+    void flushPendingWords();
+    // Inserts a previously cached generation; returns false on a cache miss
+    bool addFromCache(const QString& cacheKey);
+
     DataBase* db;
-    QNetworkAccessManager* manager;
+    AIVocabGenerator* generator;
+
+    // State of the generation in flight
+    QString requestedListName;
+    std::vector<DataBase::NewWord> pendingWords;
+    int targetListID = -1;
+    int addedCount = 0;
+    QElapsedTimer generationTimer;
+    QString requestCacheKey;
+    QJsonArray generatedEntries;
 };
 
 #endif // AICREATEWINDOW_H
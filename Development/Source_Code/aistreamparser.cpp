@@ -0,0 +1,75 @@
+#include "aistreamparser.h"
+#include <QJsonDocument>
+
+QList<QByteArray> SseParser::feed(const QByteArray& chunk) {
+    QList<QByteArray> events;
+    buffer.append(chunk);
+
+    int lineEnd;
+    while ((lineEnd = buffer.indexOf('\n')) >= 0) {
+        QByteArray line = buffer.left(lineEnd);
+        buffer.remove(0, lineEnd + 1);
+        if (line.endsWith('\r')) line.chop(1);
+
+        if (line.isEmpty()) {
+            // A blank line dispatches the event
+            if (hasData) events.append(eventData);
+            eventData.clear();
+            hasData = false;
+        } else if (line.startsWith("data:")) {
+            QByteArray value = line.mid(5);
+            if (value.startsWith(' ')) value.remove(0, 1);
+            if (hasData) eventData.append('\n');
+            eventData.append(value);
+            hasData = true;
+        }
+        // Comments (":") and other fields (event, id, retry) are not used by the API
+    }
+
+    return events;
+}
+
+void SseParser::reset() {
+    buffer.clear();
+    eventData.clear();
+    hasData = false;
+}
+
+QList<QJsonObject> JsonObjectStreamExtractor::feed(const QString& text) {
+    QList<QJsonObject> objects;
+
+    for (QChar ch : text) {
+        if (depth > 0) current.append(ch);
+
+        if (inString) {
+            if (escaped) escaped = false;
+            else if (ch == '\\') escaped = true;
+            else if (ch == '"') inString = false;
+            continue;
+        }
+
+        if (ch == '"') {
+            // Strings outside an object (e.g. stray prose) are skipped the same way
+            inString = true;
+        } else if (ch == '{') {
+            if (depth == 0) current = ch;
+            depth++;
+        } else if (ch == '}' && depth > 0) {
+            depth--;
+            if (depth == 0) {
+                QJsonDocument doc = QJsonDocument::fromJson(current.toUtf8());
+                if (doc.isObject()) objects.append(doc.object());
+                current.clear();
+            }
+        }
+    }
+
+    return objects;
+}
+
+void JsonObjectStreamExtractor::reset() {
+    current.clear();
+    depth = 0;
+    inString = false;
+    escaped = false;
+}
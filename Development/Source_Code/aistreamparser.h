@@ -0,0 +1,41 @@
+#ifndef AISTREAMPARSER_H
+#define AISTREAMPARSER_H
+
+#include <QByteArray>
+#include <QJsonObject>
+#include <QList>
+#include <QString>
+
+// Incremental parser for a text/event-stream (server-sent events) body.
+// Bytes can be fed in arbitrary pieces; every complete event's data payload is returned once.
+class SseParser
+{
+public:
+    // Returns the data payloads of all events completed by this chunk
+    QList<QByteArray> feed(const QByteArray& chunk);
+    void reset();
+
+private:
+    QByteArray buffer;
+    QByteArray eventData;
+    bool hasData = false;
+};
+
+// Extracts complete JSON objects from a JSON array that is still being received,
+// e.g. the model output [{"word": "...", "definition": "..."}, ...] arriving token by token.
+// Only top-level objects inside the array are returned; braces inside strings are ignored.
+class JsonObjectStreamExtractor
+{
+public:
+    // Returns every object closed by this piece of text
+    QList<QJsonObject> feed(const QString& text);
+    void reset();
+
+private:
+    QString current;
+    int depth = 0;
+    bool inString = false;
+    bool escaped = false;
+};
+
+#endif // AISTREAMPARSER_H
@@ -0,0 +1,341 @@
+#include "aivocabgenerator.h"
+#include <QNetworkRequest>
+#include <QJsonDocument>
+#include <QJsonArray>
+#include <QCryptographicHash>
+#include <QRandomGenerator>
+#include <QTimer>
+#include <QDebug>
+#include "metrics.h"
+#include <cstdlib>
+
+namespace {
+// Each top-up round asks again for the words lost to duplicates; stop after this many
+const int kMaxTopUpRounds = 2;
+// Words listed in a top-up prompt as "already used"
+const int kMaxAvoidWords = 100;
+
+const int kMaxTokens = 1500;
+const double kTemperature = 0.8;
+
+bool isEventStream(QNetworkReply* reply) {
+    return reply->header(QNetworkRequest::ContentTypeHeader).toString().contains("text/event-stream");
+}
+
+// Extracts the assistant text from a non-streamed chat-completions body
+QString completionText(const QByteArray& body) {
+    QJsonDocument doc = QJsonDocument::fromJson(body);
+    QJsonArray choices = doc.object().value("choices").toArray();
+    if (choices.isEmpty()) return QString();
+    QJsonObject first = choices.at(0).toObject();
+    // chat completions: message.content
+    if (first.value("message").isObject()) {
+        return first.value("message").toObject().value("content").toString();
+    }
+    return first.value("text").toString();
+}
+}
+
+AIVocabGenerator::AIVocabGenerator(QObject *parent)
+    : QObject(parent)
+    , manager(new QNetworkAccessManager(this))
+    , endpoint(defaultEndpoint()) {
+
+}
+
+QUrl AIVocabGenerator::defaultEndpoint() {
+    QString base = "https://api.openai.com/v1";
+    const char* env = std::getenv("OPENAI_BASE_URL");
+    if (env && *env) base = QString::fromUtf8(env);
+    while (base.endsWith('/')) base.chop(1);
+    return QUrl(base + "/chat/completions");
+}
+
+AIVocabGenerator::~AIVocabGenerator() {
+    abort();
+}
+
+QString AIVocabGenerator::normalizeWord(const QString& word) {
+    return word.simplified().toCaseFolded();
+}
+
+QString AIVocabGenerator::cacheKey(const AIVocabRequest& req) {
+    QJsonArray messages;
+    messages.append(systemPrompt());
+    messages.append(userPrompt(req, req.wordCount));
+
+    QJsonObject key;
+    key["model"] = req.model;
+    key["messages"] = messages;
+    key["max_tokens"] = kMaxTokens;
+    key["temperature"] = kTemperature;
+
+    // QJsonObject keeps its keys sorted, so the compact form is canonical
+    QByteArray canonical = QJsonDocument(key).toJson(QJsonDocument::Compact);
+    return QString::fromLatin1(QCryptographicHash::hash(canonical, QCryptographicHash::Sha256).toHex());
+}
+
+QString AIVocabGenerator::systemPrompt() {
+    return "You are a helpful assistant that outputs JSON only."
+           " When asked, produce a JSON array of objects with keys 'word' and 'definition'.";
+}
+
+QString AIVocabGenerator::userPrompt(const AIVocabRequest& req, int count) {
+    QString prompt = QString("Generate %1 vocabulary entries for a list named '%2'. "
+                             "Return ONLY a JSON array like [{\"word\": \"...\", \"definition\": \"...\"}, ...].\n")
+                     .arg(count).arg(req.listName);
+    if (!req.customPrompt.isEmpty()) {
+        prompt += "Additional instructions: \n" + req.customPrompt + "\n";
+    }
+    return prompt;
+}
+
+void AIVocabGenerator::start(const AIVocabRequest& req) {
+    abort();
+
+    request = req;
+    running = true;
+    runId++;
+    pendingRetries = 0;
+    topUpRounds = 0;
+    lastError.clear();
+    seenWords.clear();
+    uniqueWords.clear();
+
+    int remaining = qMax(1, request.wordCount);
+    totalChunks = (remaining + chunkSize - 1) / chunkSize;
+    for (int i = 0; i < totalChunks; ++i) {
+        Chunk chunk;
+        chunk.index = i;
+        chunk.count = qMin(chunkSize, remaining);
+        remaining -= chunk.count;
+        pending.push_back(chunk);
+    }
+
+    launchPending();
+}
+
+void AIVocabGenerator::abort() {
+    runId++;
+    pending.clear();
+    pendingRetries = 0;
+    // abort() emits finished synchronously, so detach the replies first
+    std::map<QNetworkReply*, InFlight> replies;
+    replies.swap(inFlight);
+    for (auto &p : replies) {
+        p.first->disconnect(this);
+        p.first->abort();
+        p.first->deleteLater();
+    }
+    running = false;
+}
+
+QJsonObject AIVocabGenerator::buildBody(const Chunk& chunk) const {
+    QJsonArray messages;
+    QJsonObject systemMsg;
+    systemMsg["role"] = "system";
+    systemMsg["content"] = systemPrompt();
+    messages.append(systemMsg);
+
+    QJsonObject userMsg;
+    userMsg["role"] = "user";
+    QString userRequest = userPrompt(request, chunk.count);
+    if (totalChunks > 1 && chunk.avoidWords.isEmpty()) {
+        // Steer concurrent chunks towards different words; duplicates are still removed afterwards
+        userRequest += QString("This is part %1 of %2 of a larger list, so pick a varied selection.\n")
+                       .arg(chunk.index + 1).arg(totalChunks);
+    }
+    if (!chunk.avoidWords.isEmpty()) {
+        userRequest += "Do not use any of these words: " + chunk.avoidWords.join(", ") + "\n";
+    }
+    userMsg["content"] = userRequest;
+    messages.append(userMsg);
+
+    QJsonObject body;
+    body["model"] = request.model;
+    body["messages"] = messages;
+    body["max_tokens"] = kMaxTokens;
+    body["temperature"] = kTemperature;
+    body["stream"] = request.stream;
+    return body;
+}
+
+void AIVocabGenerator::launchPending() {
+    while (!pending.empty() && static_cast<int>(inFlight.size()) < maxConcurrent) {
+        Chunk chunk = pending.front();
+        pending.pop_front();
+        launch(chunk);
+    }
+    checkCompletion();
+}
+
+void AIVocabGenerator::launch(const Chunk& chunk) {
+    QNetworkRequest netRequest(endpoint);
+    netRequest.setRawHeader("Authorization", QString("Bearer %1").arg(apiKey).toUtf8());
+    netRequest.setHeader(QNetworkRequest::ContentTypeHeader, "application/json");
+
+    QByteArray payload = QJsonDocument(buildBody(chunk)).toJson(QJsonDocument::Compact);
+    QNetworkReply* reply = manager->post(netRequest, payload);
+
+    InFlight state;
+    state.chunk = chunk;
+    state.chunk.attempts++;
+    state.sent.start();
+    inFlight.emplace(reply, std::move(state));
+
+    connect(reply, &QNetworkReply::readyRead, this, &AIVocabGenerator::onReplyReadyRead);
+    connect(reply, &QNetworkReply::finished, this, &AIVocabGenerator::onReplyFinished);
+}
+
+void AIVocabGenerator::takeObjects(const QList<QJsonObject>& objects, InFlight& state) {
+    QVector<AIVocabEntry> fresh;
+    for (const QJsonObject &o : objects) {
+        if (seenWords.size() >= request.wordCount) break;
+        QString w = o.value("word").toString().trimmed();
+        QString def = o.value("definition").toString().trimmed();
+        if (w.isEmpty()) continue;
+        if (state.received++ == 0) {
+            static LatencyHistogram& firstEntry = MetricsRegistry::instance().histogram("ai.vocab.first_entry");
+            firstEntry.record(static_cast<uint64_t>(state.sent.nsecsElapsed() / 1000));
+        }
+
+        QString key = normalizeWord(w);
+        if (seenWords.contains(key)) continue;
+        seenWords.insert(key);
+        uniqueWords.append(w);
+        fresh.append(AIVocabEntry{w, def});
+    }
+
+    if (!fresh.isEmpty()) {
+        int run = runId;
+        emit entriesReady(fresh);
+        if (run != runId) return; // aborted by an entriesReady handler
+        emit progress(seenWords.size(), request.wordCount);
+        // Everything asked for has arrived; the requests still running can only add surplus
+        if (seenWords.size() >= request.wordCount) finishEarly();
+    }
+}
+
+void AIVocabGenerator::onReplyReadyRead() {
+    QNetworkReply* reply = qobject_cast<QNetworkReply*>(sender());
+    auto it = inFlight.find(reply);
+    // A server that ignores stream=true answers with a plain JSON body, handled when the reply finishes
+    if (it == inFlight.end() || !isEventStream(reply)) return;
+
+    InFlight &state = it->second;
+    const QList<QByteArray> events = state.sse.feed(reply->readAll());
+    for (const QByteArray &data : events) {
+        if (data.trimmed() == "[DONE]") continue;
+
+        QJsonArray choices = QJsonDocument::fromJson(data).object().value("choices").toArray();
+        if (choices.isEmpty()) continue;
+        QString delta = choices.at(0).toObject().value("delta").toObject().value("content").toString();
+        if (delta.isEmpty()) continue;
+
+        takeObjects(state.extractor.feed(delta), state);
+        // entriesReady handlers may abort the whole run
+        if (inFlight.find(reply) == inFlight.end()) return;
+    }
+}
+
+void AIVocabGenerator::onReplyFinished() {
+    QNetworkReply* reply = qobject_cast<QNetworkReply*>(sender());
+    auto it = inFlight.find(reply);
+    if (it == inFlight.end()) return;
+    reply->deleteLater();
+
+    if (isEventStream(reply)) {
+        if (reply->bytesAvailable() > 0) onReplyReadyRead();
+        it = inFlight.find(reply);
+        if (it == inFlight.end()) return;
+    } else if (reply->error() == QNetworkReply::NoError) {
+        JsonObjectStreamExtractor extractor;
+        takeObjects(extractor.feed(completionText(reply->readAll())), it->second);
+        it = inFlight.find(reply);
+        if (it == inFlight.end()) return;
+    }
+
+    InFlight state = std::move(it->second);
+    inFlight.erase(it);
+
+    static LatencyHistogram& requestLatency = MetricsRegistry::instance().histogram("ai.vocab.request");
+    requestLatency.record(static_cast<uint64_t>(state.sent.nsecsElapsed() / 1000));
+    if (reply->error() != QNetworkReply::NoError) requestLatency.recordError();
+
+    int status = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+    if (reply->error() != QNetworkReply::NoError) {
+        // Client errors other than rate limiting will not get better by retrying
+        bool retryable = status == 0 || status == 429 || status >= 500;
+        int retryAfterMs = reply->rawHeader("Retry-After").toInt() * 1000;
+        QString error = reply->errorString();
+        qWarning() << "AI generation chunk" << state.chunk.index << "failed (attempt" << state.chunk.attempts << "):" << error;
+        // Ask again only for the entries this attempt did not deliver
+        Chunk retry = state.chunk;
+        retry.count -= state.received;
+        if (!retryable) {
+            lastError = error;
+        } else if (retry.count > 0) {
+            retryOrFail(retry, error, retryAfterMs);
+        }
+    } else if (state.received == 0) {
+        retryOrFail(state.chunk, "Could not parse the model output as a JSON array.", 0);
+    }
+
+    launchPending();
+}
+
+void AIVocabGenerator::retryOrFail(Chunk chunk, const QString& error, int retryAfterMs) {
+    if (chunk.attempts > maxRetries) {
+        lastError = error;
+        return;
+    }
+
+    // Exponential backoff with jitter so concurrent chunks do not retry in lockstep
+    int backoff = baseBackoffMs * (1 << (chunk.attempts - 1));
+    backoff += static_cast<int>(QRandomGenerator::global()->bounded(baseBackoffMs + 1));
+    backoff = qMax(backoff, retryAfterMs);
+
+    static Counter& retries = MetricsRegistry::instance().counter("ai.vocab.retries");
+    retries.add();
+
+    pendingRetries++;
+    int run = runId;
+    QTimer::singleShot(backoff, this, [this, chunk, run]() {
+        if (run != runId) return; // aborted or restarted meanwhile
+        pendingRetries--;
+        pending.push_back(chunk);
+        launchPending();
+    });
+}
+
+void AIVocabGenerator::finishEarly() {
+    abort();
+    qInfo() << "AI generation reached" << request.wordCount << "words; remaining requests cancelled";
+    emit finished(true, QString());
+}
+
+void AIVocabGenerator::checkCompletion() {
+    if (!running || !pending.empty() || !inFlight.empty() || pendingRetries > 0) return;
+
+    int unique = seenWords.size();
+    if (unique < request.wordCount && unique > 0 && topUpRounds < kMaxTopUpRounds) {
+        // Ask again for the words lost to duplicates or failed chunks
+        topUpRounds++;
+        QStringList avoid = uniqueWords.mid(qMax(0, uniqueWords.size() - kMaxAvoidWords));
+        int remaining = request.wordCount - unique;
+        int index = totalChunks;
+        while (remaining > 0) {
+            Chunk chunk;
+            chunk.index = index++;
+            chunk.count = qMin(chunkSize, remaining);
+            chunk.avoidWords = avoid;
+            remaining -= chunk.count;
+            pending.push_back(chunk);
+        }
+        launchPending();
+        return;
+    }
+
+    running = false;
+    emit finished(unique > 0, lastError);
+}
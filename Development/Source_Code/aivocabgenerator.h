@@ -0,0 +1,130 @@
+#ifndef AIVOCABGENERATOR_H
+#define AIVOCABGENERATOR_H
+
+#include <QObject>
+#include <QNetworkAccessManager>
+#include <QNetworkReply>
+#include <QJsonObject>
+#include <QSet>
+#include <QStringList>
+#include <QUrl>
+#include <QVector>
+#include <QElapsedTimer>
+#include <deque>
+#include <map>
+#include "aistreamparser.h"
+
+struct AIVocabEntry {
+    QString word;
+    QString definition;
+};
+
+struct AIVocabRequest {
+    QString model;
+    QString listName;
+    QString customPrompt;
+    int wordCount = 10;
+    bool stream = true;
+};
+
+// Generates vocabulary entries through the chat-completions API.
+// Large word counts are split into chunks that run concurrently (bounded by
+// maxConcurrentRequests); failed chunks are retried with exponential backoff.
+// Entries from all chunks are de-duplicated on their normalized word before
+// being handed out through entriesReady(), so callers can insert them directly.
+// At most request.wordCount entries are handed out; the run finishes as soon as that many arrived.
+class AIVocabGenerator : public QObject
+{
+    Q_OBJECT
+
+public:
+    static constexpr int DEFAULT_CHUNK_SIZE = 40;
+    static constexpr int DEFAULT_MAX_CONCURRENT = 4;
+    // QNetworkAccessManager runs at most 6 requests per host at a time; more would only queue
+    static constexpr int MAX_CONCURRENT = 6;
+    static constexpr int DEFAULT_MAX_RETRIES = 3;
+    // Callers commit entries in transactions of this many words while results are still arriving
+    static constexpr int INSERT_BATCH_SIZE = 10;
+
+    explicit AIVocabGenerator(QObject *parent = nullptr);
+    ~AIVocabGenerator();
+
+    void setEndpoint(const QUrl& url) { endpoint = url; }
+    void setApiKey(const QString& key) { apiKey = key; }
+    void setChunkSize(int size) { chunkSize = qMax(1, size); }
+    void setMaxConcurrentRequests(int limit) { maxConcurrent = qBound(1, limit, MAX_CONCURRENT); }
+    void setMaxRetries(int retries) { maxRetries = qMax(0, retries); }
+    void setBaseBackoffMs(int ms) { baseBackoffMs = qMax(0, ms); }
+
+    void start(const AIVocabRequest& request);
+    void abort();
+    bool isRunning() const { return running; }
+
+    // Key used for de-duplication: case-folded with collapsed whitespace
+    static QString normalizeWord(const QString& word);
+
+    // Content address of a request: SHA-256 over model, messages and sampling parameters.
+    // Chunking and streaming do not change the result, so they are not part of the key.
+    static QString cacheKey(const AIVocabRequest& request);
+
+    // Chat-completions URL: OPENAI_BASE_URL (e.g. http://127.0.0.1:8089/v1 for the mock server
+    // in tools/mock_llm_server) + "/chat/completions", or the OpenAI API by default.
+    static QUrl defaultEndpoint();
+
+signals:
+    void entriesReady(const QVector<AIVocabEntry>& entries);
+    void progress(int uniqueReceived, int requested);
+    void finished(bool success, const QString& errorMessage);
+
+private slots:
+    void onReplyReadyRead();
+    void onReplyFinished();
+
+private:
+    struct Chunk {
+        int index = 0;
+        int count = 0;
+        int attempts = 0;
+        QStringList avoidWords;
+    };
+
+    struct InFlight {
+        Chunk chunk;
+        SseParser sse;
+        JsonObjectStreamExtractor extractor;
+        int received = 0;
+        QElapsedTimer sent;
+    };
+
+    static QString systemPrompt();
+    static QString userPrompt(const AIVocabRequest& request, int count);
+    QJsonObject buildBody(const Chunk& chunk) const;
+    void launchPending();
+    void launch(const Chunk& chunk);
+    void takeObjects(const QList<QJsonObject>& objects, InFlight& state);
+    void retryOrFail(Chunk chunk, const QString& error, int retryAfterMs);
+    void checkCompletion();
+    void finishEarly();
+
+    QNetworkAccessManager* manager;
+    QUrl endpoint;
+    QString apiKey;
+    int chunkSize = DEFAULT_CHUNK_SIZE;
+    int maxConcurrent = DEFAULT_MAX_CONCURRENT;
+    int maxRetries = DEFAULT_MAX_RETRIES;
+    int baseBackoffMs = 500;
+
+    AIVocabRequest request;
+    bool running = false;
+    int runId = 0;
+    int totalChunks = 0;
+    int pendingRetries = 0;
+    int topUpRounds = 0;
+    QString lastError;
+    std::deque<Chunk> pending;
+    std::map<QNetworkReply*, InFlight> inFlight;
+    QSet<QString> seenWords;
+    QStringList uniqueWords;
+};
+
+#endif // AIVOCABGENERATOR_H
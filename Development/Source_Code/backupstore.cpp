@@ -0,0 +1,206 @@
+#include "backupstore.h"
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QDir>
+#include <QDirIterator>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QSet>
+#include <QTextStream>
+#include <array>
+#include <stdexcept>
+
+namespace {
+const char* const kManifestHeader = "vocab-snapshot 1";
+const int kReadBufferSize = 1024 * 1024;
+
+// Random 64-bit values per byte for the gear hash, generated with splitmix64 so that
+// every build cuts identical chunks
+std::array<uint64_t, 256> makeGearTable() {
+    std::array<uint64_t, 256> table{};
+    uint64_t state = 0x2545f4914f6cdd1dULL;
+    for (auto &value : table) {
+        state += 0x9e3779b97f4a7c15ULL;
+        uint64_t z = state;
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+        value = z ^ (z >> 31);
+    }
+    return table;
+}
+
+const std::array<uint64_t, 256>& gearTable() {
+    static const std::array<uint64_t, 256> table = makeGearTable();
+    return table;
+}
+
+// A cut happens where the top bits of the hash are zero; 16 bits give 64 KiB on average past the minimum
+const uint64_t kCutMask = 0xffffULL << 48;
+
+[[noreturn]] void fail(const QString& message) {
+    throw std::runtime_error(message.toStdString());
+}
+}
+
+BackupStore::BackupStore(const QString& rootDir)
+    : rootDir(rootDir) {
+    QDir().mkpath(rootDir + "/chunks");
+    QDir().mkpath(rootDir + "/snapshots");
+}
+
+QString BackupStore::chunkPath(const QString& hash) const {
+    return rootDir + "/chunks/" + hash.left(2) + "/" + hash;
+}
+
+BackupStore::SnapshotStats BackupStore::writeSnapshot(const QString& sourceFile) {
+    QFile in(sourceFile);
+    if (!in.open(QIODevice::ReadOnly)) fail("Cannot read " + sourceFile + ": " + in.errorString());
+
+    SnapshotStats stats;
+    QStringList lines;
+    QCryptographicHash fileHash(QCryptographicHash::Sha256);
+    const auto &gear = gearTable();
+
+    QByteArray chunk;
+    chunk.reserve(MAX_CHUNK_SIZE);
+    uint64_t rolling = 0;
+
+    auto emitChunk = [&]() {
+        if (chunk.isEmpty()) return;
+        QString hash = QString::fromLatin1(QCryptographicHash::hash(chunk, QCryptographicHash::Sha256).toHex());
+        QString path = chunkPath(hash);
+        if (!QFileInfo::exists(path)) {
+            QDir().mkpath(QFileInfo(path).absolutePath());
+            // QSaveFile writes to a temporary file and renames, so a crash never leaves a torn chunk
+            QSaveFile out(path);
+            if (!out.open(QIODevice::WriteOnly) || out.write(chunk) != chunk.size() || !out.commit()) {
+                fail("Cannot write chunk " + path + ": " + out.errorString());
+            }
+            stats.newChunks++;
+            stats.newBytes += chunk.size();
+        }
+        lines << hash + " " + QString::number(chunk.size());
+        stats.chunks++;
+        stats.bytes += chunk.size();
+        chunk.clear();
+        rolling = 0;
+    };
+
+    QByteArray buffer;
+    while (!(buffer = in.read(kReadBufferSize)).isEmpty()) {
+        fileHash.addData(buffer);
+        const char* data = buffer.constData();
+        int start = 0;
+        for (int i = 0; i < buffer.size(); ++i) {
+            rolling = (rolling << 1) + gear[static_cast<unsigned char>(data[i])];
+            int length = chunk.size() + (i - start + 1);
+            if ((length >= MIN_CHUNK_SIZE && (rolling & kCutMask) == 0) || length >= MAX_CHUNK_SIZE) {
+                chunk.append(data + start, i - start + 1);
+                start = i + 1;
+                emitChunk();
+            }
+        }
+        chunk.append(data + start, buffer.size() - start);
+    }
+    if (in.error() != QFileDevice::NoError) fail("Cannot read " + sourceFile + ": " + in.errorString());
+    emitChunk();
+
+    QString name = QDateTime::currentDateTimeUtc().toString("yyyyMMdd-HHmmss") + ".manifest";
+    stats.manifestPath = rootDir + "/snapshots/" + name;
+
+    QSaveFile manifest(stats.manifestPath);
+    if (!manifest.open(QIODevice::WriteOnly | QIODevice::Text)) fail("Cannot write " + stats.manifestPath + ": " + manifest.errorString());
+    QTextStream outStream(&manifest);
+    outStream << kManifestHeader << "\n";
+    outStream << "size " << stats.bytes << "\n";
+    outStream << "sha256 " << QString::fromLatin1(fileHash.result().toHex()) << "\n";
+    for (const QString &line : lines) outStream << line << "\n";
+    outStream.flush();
+    if (!manifest.commit()) fail("Cannot write " + stats.manifestPath + ": " + manifest.errorString());
+
+    return stats;
+}
+
+QStringList BackupStore::readManifestChunks(const QString& manifestPath, QString* fileHash, qint64* fileSize) {
+    QFile file(manifestPath);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) fail("Cannot read " + manifestPath + ": " + file.errorString());
+
+    QTextStream stream(&file);
+    if (stream.readLine() != kManifestHeader) fail(manifestPath + " is not a snapshot manifest");
+
+    QStringList chunks;
+    while (!stream.atEnd()) {
+        QStringList parts = stream.readLine().split(' ');
+        if (parts.size() != 2) continue;
+        if (parts[0] == "size") {
+            if (fileSize) *fileSize = parts[1].toLongLong();
+        } else if (parts[0] == "sha256") {
+            if (fileHash) *fileHash = parts[1];
+        } else {
+            chunks << parts[0];
+        }
+    }
+    return chunks;
+}
+
+void BackupStore::restoreSnapshot(const QString& manifestPath, const QString& destPath) const {
+    QString expectedHash;
+    qint64 expectedSize = -1;
+    QStringList chunks = readManifestChunks(manifestPath, &expectedHash, &expectedSize);
+
+    QSaveFile out(destPath);
+    if (!out.open(QIODevice::WriteOnly)) fail("Cannot write " + destPath + ": " + out.errorString());
+
+    QCryptographicHash hash(QCryptographicHash::Sha256);
+    qint64 written = 0;
+    for (const QString &chunkHash : chunks) {
+        QFile in(chunkPath(chunkHash));
+        if (!in.open(QIODevice::ReadOnly)) fail("Missing chunk " + chunkHash);
+        QByteArray data = in.readAll();
+        if (out.write(data) != data.size()) fail("Cannot write " + destPath + ": " + out.errorString());
+        hash.addData(data);
+        written += data.size();
+    }
+
+    if (written != expectedSize || QString::fromLatin1(hash.result().toHex()) != expectedHash) {
+        out.cancelWriting();
+        fail("Snapshot " + QFileInfo(manifestPath).fileName() + " failed verification");
+    }
+    if (!out.commit()) fail("Cannot write " + destPath + ": " + out.errorString());
+}
+
+QStringList BackupStore::snapshots() const {
+    QDir dir(rootDir + "/snapshots");
+    QStringList names = dir.entryList(QStringList() << "*.manifest", QDir::Files, QDir::Name);
+    QStringList paths;
+    for (const QString &name : names) paths << dir.filePath(name);
+    return paths;
+}
+
+BackupStore::PruneStats BackupStore::prune(int keep) {
+    PruneStats stats;
+    QStringList all = snapshots();
+    int excess = all.size() - qMax(1, keep);
+    for (int i = 0; i < excess; ++i) {
+        if (QFile::remove(all[i])) stats.removedSnapshots++;
+    }
+
+    // Mark and sweep: every chunk referenced by a remaining manifest survives
+    QSet<QString> live;
+    for (const QString &manifest : snapshots()) {
+        for (const QString &chunkHash : readManifestChunks(manifest)) live.insert(chunkHash);
+    }
+
+    QDirIterator it(rootDir + "/chunks", QDir::Files, QDirIterator::Subdirectories);
+    while (it.hasNext()) {
+        QString path = it.next();
+        if (live.contains(it.fileName())) continue;
+        qint64 size = it.fileInfo().size();
+        if (QFile::remove(path)) {
+            stats.removedChunks++;
+            stats.removedBytes += size;
+        }
+    }
+    return stats;
+}
@@ -0,0 +1,58 @@
+#ifndef BACKUPSTORE_H
+#define BACKUPSTORE_H
+
+#include <QString>
+#include <QStringList>
+#include <cstdint>
+
+// Deduplicated snapshot store for database backups.
+// A snapshot file is split into content-defined chunks (a gear rolling hash picks the cut points,
+// so a changed page only changes the chunks around it) and each chunk is stored once under
+// chunks/<first two hex digits>/<sha256>. A snapshot is a small manifest in snapshots/ listing
+// its chunks in order, so hourly snapshots of a large database only store the changed chunks.
+class BackupStore
+{
+public:
+    // Chunk size bounds; the average is about AVERAGE_CHUNK_SIZE
+    static constexpr int MIN_CHUNK_SIZE = 16 * 1024;
+    static constexpr int AVERAGE_CHUNK_SIZE = 64 * 1024;
+    static constexpr int MAX_CHUNK_SIZE = 256 * 1024;
+
+    struct SnapshotStats {
+        QString manifestPath;
+        int chunks = 0;
+        int newChunks = 0;
+        qint64 bytes = 0;
+        qint64 newBytes = 0;
+    };
+
+    struct PruneStats {
+        int removedSnapshots = 0;
+        int removedChunks = 0;
+        qint64 removedBytes = 0;
+    };
+
+    explicit BackupStore(const QString& rootDir);
+
+    const QString& root() const { return rootDir; }
+
+    // Chunks sourceFile and writes a manifest named after the current UTC time (throws on I/O errors)
+    SnapshotStats writeSnapshot(const QString& sourceFile);
+
+    // Reassembles a snapshot into destPath and verifies its checksum (throws on errors)
+    void restoreSnapshot(const QString& manifestPath, const QString& destPath) const;
+
+    // Manifest paths, oldest first
+    QStringList snapshots() const;
+
+    // Keeps the newest `keep` snapshots and deletes chunks no remaining snapshot refers to
+    PruneStats prune(int keep);
+
+private:
+    QString chunkPath(const QString& hash) const;
+    static QStringList readManifestChunks(const QString& manifestPath, QString* fileHash = nullptr, qint64* fileSize = nullptr);
+
+    QString rootDir;
+};
+
+#endif // BACKUPSTORE_H
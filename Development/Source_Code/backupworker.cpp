@@ -0,0 +1,82 @@
+#include "backupworker.h"
+#include "tracing.h"
+#include <QDebug>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <stdexcept>
+
+BackupWorker::BackupWorker(const std::string& dbPath, QObject *parent)
+    : QObject(parent)
+    , dbPath(dbPath)
+    , store(backupDirFor(dbPath)) {
+
+}
+
+BackupWorker::~BackupWorker() {
+}
+
+QString BackupWorker::backupDirFor(const std::string& dbPath) {
+    return QFileInfo(QString::fromStdString(dbPath)).absolutePath() + "/backups";
+}
+
+DataBase* BackupWorker::connection() {
+    // Opened lazily so the connection is created on the worker thread that uses it
+    if (!db) {
+        db = std::make_unique<DataBase>(dbPath);
+    }
+    return db.get();
+}
+
+void BackupWorker::backupNow() {
+    TRACE_SCOPE_CAT("worker", "BackupWorker::backupNow");
+    QString tempCopy = store.root() + "/.snapshot-in-progress.db";
+    QFile::remove(tempCopy);
+
+    try {
+        QElapsedTimer timer;
+        timer.start();
+
+        int lastPercent = -1;
+        connection()->backupTo(tempCopy.toStdString(), PAGES_PER_STEP, PAUSE_BETWEEN_STEPS_MS,
+                               [this, &lastPercent](int remaining, int total) {
+            int percent = total > 0 ? 100 - (remaining * 100) / total : 100;
+            if (percent != lastPercent) {
+                lastPercent = percent;
+                emit backupProgress(percent);
+            }
+        });
+        qint64 copyMs = timer.elapsed();
+
+        BackupStore::SnapshotStats stats = store.writeSnapshot(tempCopy);
+        QFile::remove(tempCopy);
+        BackupStore::PruneStats pruned = store.prune(SNAPSHOTS_TO_KEEP);
+
+        QString summary = QString("Backup %1: %2 MB in %3 chunks, %4 new (%5 MB), %6 ms")
+                          .arg(QFileInfo(stats.manifestPath).baseName())
+                          .arg(stats.bytes / (1024.0 * 1024.0), 0, 'f', 1)
+                          .arg(stats.chunks)
+                          .arg(stats.newChunks)
+                          .arg(stats.newBytes / (1024.0 * 1024.0), 0, 'f', 1)
+                          .arg(timer.elapsed());
+        qInfo() << summary << "(copy" << copyMs << "ms; pruned" << pruned.removedSnapshots << "snapshots,"
+                << pruned.removedChunks << "chunks)";
+        emit backupFinished(true, summary);
+    } catch (const std::exception& ex) {
+        QFile::remove(tempCopy);
+        qCritical() << "Backup failed:" << ex.what();
+        emit backupFinished(false, QString::fromStdString(ex.what()));
+    }
+}
+
+void BackupWorker::restoreSnapshot(const QString& manifestPath, const QString& destPath) {
+    TRACE_SCOPE_CAT("worker", "BackupWorker::restoreSnapshot");
+    try {
+        store.restoreSnapshot(manifestPath, destPath);
+        emit restoreFinished(true, "Restored " + QFileInfo(manifestPath).baseName() + " to " + destPath);
+    } catch (const std::exception& ex) {
+        qCritical() << "Restore failed:" << ex.what();
+        emit restoreFinished(false, QString::fromStdString(ex.what()));
+    }
+}
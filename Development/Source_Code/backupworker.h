@@ -0,0 +1,47 @@
+#ifndef BACKUPWORKER_H
+#define BACKUPWORKER_H
+
+#include <QObject>
+#include <QString>
+#include <memory>
+#include <string>
+#include "backupstore.h"
+#include "database.h"
+
+// Background job that takes hot backups of the database into a BackupStore.
+// Lives on its own QThread with its own DataBase connection: the live database is first copied
+// with sqlite3_backup_step in small page batches (never blocking the UI connection), then the
+// copy is chunked into the deduplicated store and deleted.
+class BackupWorker : public QObject
+{
+    Q_OBJECT
+
+public:
+    static constexpr int PAGES_PER_STEP = 256;
+    static constexpr int PAUSE_BETWEEN_STEPS_MS = 2;
+    static constexpr int SNAPSHOTS_TO_KEEP = 48;
+
+    explicit BackupWorker(const std::string& dbPath, QObject *parent = nullptr);
+    ~BackupWorker();
+
+    // <database directory>/backups
+    static QString backupDirFor(const std::string& dbPath);
+
+public slots:
+    void backupNow();
+    void restoreSnapshot(const QString& manifestPath, const QString& destPath);
+
+signals:
+    void backupProgress(int percent);
+    void backupFinished(bool success, const QString& summary);
+    void restoreFinished(bool success, const QString& message);
+
+private:
+    DataBase* connection();
+
+    std::string dbPath;
+    std::unique_ptr<DataBase> db;
+    BackupStore store;
+};
+
+#endif // BACKUPWORKER_H
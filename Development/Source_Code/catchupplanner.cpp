@@ -0,0 +1,62 @@
+#include "catchupplanner.h"
+#include "fsrs.h"
+#include "schedulerpolicy.h"
+#include <algorithm>
+
+CatchUpPlanner::CatchUpPlanner(int dailyCap, int todayCapacity, int horizonDays)
+    : capacity(static_cast<size_t>(std::max(0, todayCapacity)) + static_cast<size_t>(std::max(1, dailyCap)) * std::max(0, horizonDays - 1)) {
+    plan.dailyCap = std::max(1, dailyCap);
+    plan.todayCapacity = std::max(0, todayCapacity);
+}
+
+double CatchUpPlanner::predictedForgetting(const DataBase::OverdueCard& card) {
+    // An SM-2 interval is taken as the time to 90% recall (the FSRS meaning of stability),
+    // shortened for cards whose low ease factor says they are forgotten faster
+    double stability = card.fsrs_stability;
+    if (stability <= 0.0) {
+        double ease = std::max(Scheduling::Sm2Policy::MIN_EF, std::min(Scheduling::Sm2Policy::MAX_EF, card.ease_factor));
+        stability = std::max(1, card.interval_days) * ease / Scheduling::Sm2Policy::MAX_EF;
+    }
+    double elapsed = std::max(0, card.interval_days) + std::max(0.0, card.days_overdue);
+    return 1.0 - Fsrs::retrievability(elapsed, std::max(Fsrs::MIN_STABILITY, stability));
+}
+
+void CatchUpPlanner::add(const DataBase::OverdueCard& card) {
+    plan.overdueCount++;
+    decks.insert(card.list_id);
+    if (capacity == 0) return;
+
+    Entry entry{card.schedule_id, card.list_id, predictedForgetting(card)};
+    if (kept.size() < capacity) {
+        kept.push(entry);
+    } else if (MoreAtRisk()(entry, kept.top())) {
+        kept.pop();
+        kept.push(entry);
+    }
+}
+
+CatchUpPlanner::Plan CatchUpPlanner::finish() {
+    plan.deckCount = static_cast<int>(decks.size());
+    plan.cards.resize(kept.size());
+    // The heap pops least at risk first, so fill from the back
+    for (size_t i = plan.cards.size(); i-- > 0; kept.pop()) {
+        plan.cards[i] = kept.top();
+    }
+    Plan out = std::move(plan);
+    plan = Plan();
+    decks.clear();
+    return out;
+}
+
+std::vector<CatchUpPlanner::Entry> CatchUpPlanner::Plan::batch(int day) const {
+    size_t first = day <= 0 ? 0 : static_cast<size_t>(todayCapacity) + static_cast<size_t>(dailyCap) * (day - 1);
+    size_t size = day <= 0 ? static_cast<size_t>(todayCapacity) : static_cast<size_t>(dailyCap);
+    if (day < 0 || first >= cards.size()) return {};
+    return std::vector<Entry>(cards.begin() + first, cards.begin() + std::min(cards.size(), first + size));
+}
+
+int CatchUpPlanner::Plan::daysToClear() const {
+    if (overdueCount <= todayCapacity) return overdueCount > 0 ? 1 : 0;
+    long long rest = overdueCount - todayCapacity;
+    return static_cast<int>((todayCapacity > 0 ? 1 : 0) + (rest + dailyCap - 1) / dailyCap);
+}
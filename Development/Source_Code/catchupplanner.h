@@ -0,0 +1,63 @@
+#ifndef CATCHUPPLANNER_H
+#define CATCHUPPLANNER_H
+
+#include <queue>
+#include <unordered_set>
+#include <vector>
+#include "database.h"
+
+// Plans the way back from a large overdue backlog across all decks. Cards are fed once from
+// DataBase::forEachOverdueCard and ranked by predicted forgetting: the probability that the card
+// is no longer recalled, from its FSRS stability or, without one, from its interval and ease factor.
+// Only the cards that fit into the planned days are kept, in a bounded min-heap, so memory stays
+// O(planned cards) however large the backlog is.
+class CatchUpPlanner
+{
+public:
+    static constexpr int DEFAULT_DAILY_CAP = 200;
+    static constexpr int DEFAULT_HORIZON_DAYS = 7;
+
+    struct Entry {
+        int scheduleId;
+        int listId;
+        double forgetting;      // 1 - predicted recall probability now
+    };
+
+    struct Plan {
+        std::vector<Entry> cards;           // most at risk first
+        long long overdueCount = 0;
+        int deckCount = 0;
+        int todayCapacity = 0;
+        int dailyCap = 0;
+
+        // Batch for day 0 (today, after what was already reviewed) up to the planning horizon
+        std::vector<Entry> batch(int day) const;
+        // Days until every overdue card has had a turn at the daily cap
+        int daysToClear() const;
+    };
+
+    // todayCapacity: reviews still allowed today; later days get dailyCap each
+    CatchUpPlanner(int dailyCap, int todayCapacity, int horizonDays = DEFAULT_HORIZON_DAYS);
+
+    void add(const DataBase::OverdueCard& card);
+    Plan finish();
+
+    static double predictedForgetting(const DataBase::OverdueCard& card);
+
+private:
+    // Orders the more at risk first, which leaves the least at risk of the kept cards on top of
+    // the priority queue, the first to give way
+    struct MoreAtRisk {
+        bool operator()(const Entry& a, const Entry& b) const {
+            if (a.forgetting != b.forgetting) return a.forgetting > b.forgetting;
+            return a.scheduleId < b.scheduleId;
+        }
+    };
+
+    size_t capacity;
+    std::priority_queue<Entry, std::vector<Entry>, MoreAtRisk> kept;
+    std::unordered_set<int> decks;
+    Plan plan;
+};
+
+#endif // CATCHUPPLANNER_H
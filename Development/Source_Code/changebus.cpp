@@ -0,0 +1,55 @@
+#include "changebus.h"
+#include "database.h"
+#include "querycache.h"
+#include "metrics.h"
+#include "tracing.h"
+
+ChangeBus::ChangeBus(QObject *parent)
+    : QObject(parent) {
+    debounceTimer.setSingleShot(true);
+    debounceTimer.setInterval(DEBOUNCE_MS);
+    connect(&debounceTimer, &QTimer::timeout, this, [this]() {
+        unsigned tables = collectedTables;
+        collectedTables = 0;
+        TRACE_SCOPE("ChangeBus::changed");
+        static Counter& refreshes = MetricsRegistry::instance().counter("changebus.refreshes");
+        refreshes.add();
+        emit changed(tables);
+    });
+
+    dueTimer.setSingleShot(true);
+    dueTimer.setTimerType(Qt::VeryCoarseTimer);
+    connect(&dueTimer, &QTimer::timeout, this, &ChangeBus::cardsDue);
+
+    DataBase::setChangeObserver([this](unsigned tables) {
+        if (pendingTables.fetch_or(tables) == 0) {
+            QMetaObject::invokeMethod(this, &ChangeBus::takePending, Qt::QueuedConnection);
+        }
+    });
+}
+
+ChangeBus::~ChangeBus() {
+    DataBase::setChangeObserver(nullptr);
+}
+
+void ChangeBus::notifyExternalChange(unsigned tables) {
+    QueryCache::instance().invalidate(tables);
+    collectedTables |= tables;
+    if (!debounceTimer.isActive()) debounceTimer.start();
+}
+
+void ChangeBus::takePending() {
+    // A fixed window from the first change: a long stream of writes still refreshes every DEBOUNCE_MS
+    collectedTables |= pendingTables.exchange(0);
+    if (!debounceTimer.isActive()) debounceTimer.start();
+}
+
+void ChangeBus::setNextDue(const QDateTime& dueUtc) {
+    if (!dueUtc.isValid()) {
+        dueTimer.stop();
+        return;
+    }
+    // next_review_date has whole seconds and is compared with <= now, so fire just after it
+    qint64 waitMs = QDateTime::currentDateTimeUtc().msecsTo(dueUtc) + 1000;
+    dueTimer.start(static_cast<int>(qBound<qint64>(0, waitMs, MAX_DUE_WAIT_MS)));
+}
@@ -0,0 +1,46 @@
+#ifndef CHANGEBUS_H
+#define CHANGEBUS_H
+
+#include <QObject>
+#include <QTimer>
+#include <QDateTime>
+#include <atomic>
+
+// Turns committed writes on any DataBase connection (reported through sqlite3_update_hook) into
+// a single debounced changed() signal on the UI thread, so a burst of inserts or a multi-step
+// delete causes one refresh. It also fires cardsDue() when the next scheduled review comes due,
+// so due counts change on time without polling. Only one bus may exist at a time.
+class ChangeBus : public QObject
+{
+    Q_OBJECT
+
+public:
+    static constexpr int DEBOUNCE_MS = 150;
+    // QTimer intervals are ints; far-off due times re-arm after a refresh instead
+    static constexpr qint64 MAX_DUE_WAIT_MS = 6LL * 60 * 60 * 1000;
+
+    explicit ChangeBus(QObject *parent = nullptr);
+    ~ChangeBus();
+
+    // For writes the hooks cannot see, e.g. another process writing the open database file
+    void notifyExternalChange(unsigned tables);
+
+    // Arms cardsDue() for the given UTC time; an invalid time disarms it
+    void setNextDue(const QDateTime& dueUtc);
+
+signals:
+    // Mask of DataBase::ChangedTable values written since the last signal
+    void changed(unsigned tables);
+    void cardsDue();
+
+private:
+    void takePending();
+
+    QTimer debounceTimer;
+    QTimer dueTimer;
+    // Set from writer threads; the first write of a burst posts takePending() to the UI thread
+    std::atomic<unsigned> pendingTables{0};
+    unsigned collectedTables = 0;
+};
+
+#endif // CHANGEBUS_H
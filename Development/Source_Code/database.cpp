@@ -3,10 +3,80 @@
 #include <vector>
 #include <sstream>
 #include <cmath>
+#include <algorithm>
+#include <iterator>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <mutex>
+#include <cstring>
+#include <unordered_map>
 #include <QDebug>
+#include "metrics.h"
+#include "tracing.h"
 
+// Times every public DataBase method into the "db.<method>" latency histogram and trace span,
+// and flushes queued slow queries when the outermost call returns
+#define DB_SCOPE(name) CallScope dbCallScope(this); METRICS_SCOPE("db." name); TRACE_SCOPE_CAT("db", "db." name)
 
-DataBase::DataBase(const std::string& dbPath) {
+namespace {
+// Fingerprints remembered per connection before the cache starts over
+const size_t kFingerprintCacheSize = 512;
+
+bool hasQueryPlan(const std::string& normalizedSql) {
+    for (const char* verb : {"select", "insert", "update", "delete", "with", "replace"}) {
+        if (normalizedSql.compare(0, std::char_traits<char>::length(verb), verb) == 0) return true;
+    }
+    return false;
+}
+
+std::mutex changeObserverMutex;
+DataBase::ChangeObserver changeObserver;
+
+// Approximate heap footprint of cached results, for the QueryCache budget
+size_t resultBytes(const std::string& s) { return sizeof(s) + s.capacity(); }
+size_t resultBytes(const std::tuple<int, std::string, std::string>& t) {
+    return sizeof(int) + resultBytes(std::get<1>(t)) + resultBytes(std::get<2>(t));
+}
+size_t resultBytes(const DataBase::WordExample& e) { return sizeof(int) + resultBytes(e.example_text) + resultBytes(e.context_notes); }
+size_t resultBytes(const DataBase::WordRelation& r) { return sizeof(int) + resultBytes(r.related_word) + resultBytes(r.relation_type); }
+size_t resultBytes(const DataBase::DeckOverview& d) { return 5 * sizeof(int) + resultBytes(d.list_name) + resultBytes(d.next_review_date); }
+template <typename T>
+size_t resultBytes(const std::vector<T>& v) {
+    size_t bytes = sizeof(v) + (v.capacity() - v.size()) * sizeof(T);
+    for (const T &item : v) bytes += resultBytes(item);
+    return bytes;
+}
+}
+
+template <typename T, typename Query>
+T DataBase::cachedRead(const std::string& key, unsigned tables, Query query) {
+    return cachedRead<T>(key, tables, query, []() { return QueryCache::Clock::time_point::max(); });
+}
+
+template <typename T, typename Query, typename Expiry>
+T DataBase::cachedRead(const std::string& key, unsigned tables, Query query, Expiry expires) {
+    QueryCache &cache = QueryCache::instance();
+    // An open transaction can see its own uncommitted rows, which other connections must not get
+    if (!cache.enabled() || !sqlite3_get_autocommit(db)) return query();
+
+    // Keyed per database file so a second DataBase on another file never shares entries
+    std::string fullKey = dbPath + '|' + key;
+    if (std::shared_ptr<const void> hit = cache.lookup(fullKey)) return *std::static_pointer_cast<const T>(hit);
+
+    uint64_t stamp = cache.stamp(tables);
+    // Before the query, so a card coming due while it runs still expires the entry in time
+    QueryCache::Clock::time_point expiresAt = expires();
+    std::shared_ptr<const T> result = std::make_shared<const T>(query());
+    cache.store(fullKey, tables, stamp, result, resultBytes(*result), expiresAt);
+    return *result;
+}
+
+
+DataBase::DataBase(const std::string& dbPath)
+    : db(nullptr)
+    , dbPath(dbPath) {
+    DB_SCOPE("open");
     int result = sqlite3_open(dbPath.c_str(), &db);    // Opening the sqlite3 DataBase
     if (result != SQLITE_OK) {
         QString errorMsg = "Can't open database: " + QString::fromStdString(std::string(sqlite3_errmsg(db)));
@@ -14,7 +84,11 @@ DataBase::DataBase(const std::string& dbPath) {
         throw std::runtime_error(errorMsg.toStdString());
     }
 
+    enableStatementProfiling();
+    enableChangeHooks();
     enableForeignKeys();
+    enableIncrementalVacuum();
+    enableWriteAheadLog();
     createVocabListTable();
     createWordsTable();
     createListWordTable();
@@ -22,6 +96,13 @@ DataBase::DataBase(const std::string& dbPath) {
     createReviewScheduleTable();
     createExampleTable();
     createWordRelationTable();
+    createDistractorTable();
+    createAIResponseCacheTable();
+    createEnrichmentProgressTable();
+    createMaintenanceStateTable();
+    createDeckCountersTable();
+    createDueHistogramTable();
+    createSchedulerParamsTable();
 }
 
 DataBase::~DataBase() {
@@ -37,6 +118,189 @@ DataBase::~DataBase() {
     }
 }
 
+void DataBase::enableStatementProfiling() {
+    std::filesystem::path logDir = std::filesystem::path(dbPath).parent_path() / "logs";
+    slowQueryLogPath = (logDir / "slow_queries.log").string();
+    sqlite3_trace_v2(db, SQLITE_TRACE_PROFILE | SQLITE_TRACE_ROW, &DataBase::traceCallback, this);
+}
+
+int DataBase::traceCallback(unsigned type, void* self, void* p, void* x) {
+    DataBase* database = static_cast<DataBase*>(self);
+    if (database->profilingSuspended) return 0;
+
+    sqlite3_stmt* stmt = static_cast<sqlite3_stmt*>(p);
+    if (type == SQLITE_TRACE_ROW) {
+        // Loops step one statement at a time, so only a switch of statement touches the map
+        if (stmt != database->lastRowStmt) {
+            if (database->lastRowStmt) database->rowsStepped[database->lastRowStmt] += database->lastRowCount;
+            database->lastRowStmt = stmt;
+            database->lastRowCount = 0;
+        }
+        database->lastRowCount++;
+    } else if (type == SQLITE_TRACE_PROFILE) {
+        database->onStatementProfiled(stmt, *static_cast<sqlite3_int64*>(x));
+    }
+    return 0;
+}
+
+void DataBase::onStatementProfiled(sqlite3_stmt* stmt, long long ns) {
+    uint64_t rows = 0;
+    if (stmt == lastRowStmt) {
+        rows = lastRowCount;
+        lastRowStmt = nullptr;
+        lastRowCount = 0;
+    }
+    auto stepped = rowsStepped.find(stmt);
+    if (stepped != rowsStepped.end()) {
+        rows += stepped->second;
+        rowsStepped.erase(stepped);
+    }
+    uint64_t vmSteps = static_cast<uint64_t>(sqlite3_stmt_status(stmt, SQLITE_STMTSTATUS_VM_STEP, 1));
+
+    const char* text = sqlite3_sql(stmt);
+    if (!text) return;
+    std::string sql(text);
+
+    auto cached = fingerprintCache.find(sql);
+    if (cached == fingerprintCache.end()) {
+        if (fingerprintCache.size() >= kFingerprintCacheSize) fingerprintCache.clear();
+        std::string normalized = SqlProfiler::normalize(sql);
+        std::string fp = SqlProfiler::fingerprint(normalized);
+        cached = fingerprintCache.emplace(sql, std::make_pair(std::move(normalized), std::move(fp))).first;
+    }
+    const std::string &normalized = cached->second.first;
+    const std::string &fp = cached->second.second;
+
+    uint64_t duration = static_cast<uint64_t>(std::max(0LL, ns));
+    SqlProfiler::instance().record(normalized, fp, duration, rows, vmSteps);
+
+    if (duration >= static_cast<uint64_t>(SqlProfiler::slowQueryThresholdMs()) * 1000000ULL) {
+        static Counter& slowQueries = MetricsRegistry::instance().counter("db.slow_queries");
+        slowQueries.add();
+
+        SlowQueryLog::Entry entry;
+        entry.fingerprint = fp;
+        // The unexpanded text: bound values (words, definitions) stay out of the log
+        entry.sql = sql;
+        entry.durationNs = duration;
+        entry.rows = rows;
+        entry.vmSteps = vmSteps;
+        if (!hasQueryPlan(normalized)) entry.queryPlan.push_back("(no query plan for this statement)");
+        pendingSlowQueries.push_back(std::move(entry));
+    }
+}
+
+std::vector<std::string> DataBase::explainQueryPlan(const std::string& sql) {
+    std::vector<std::string> lines;
+    std::string explain = "EXPLAIN QUERY PLAN " + sql;
+    sqlite3_stmt* stmt = nullptr;
+    if (sqlite3_prepare_v2(db, explain.c_str(), -1, &stmt, nullptr) != SQLITE_OK) {
+        lines.push_back(std::string("(no query plan: ") + sqlite3_errmsg(db) + ")");
+        sqlite3_finalize(stmt);
+        return lines;
+    }
+
+    // Rows are (id, parent, notused, detail); nest each detail under its parent
+    std::unordered_map<int, int> depth;
+    while (sqlite3_step(stmt) == SQLITE_ROW) {
+        int id = sqlite3_column_int(stmt, 0);
+        int parent = sqlite3_column_int(stmt, 1);
+        const unsigned char* detail = sqlite3_column_text(stmt, 3);
+        auto p = depth.find(parent);
+        int level = p == depth.end() ? 0 : p->second + 1;
+        depth[id] = level;
+        lines.push_back(std::string(static_cast<size_t>(level) * 2, ' ') + (detail ? reinterpret_cast<const char*>(detail) : ""));
+    }
+    sqlite3_finalize(stmt);
+    return lines;
+}
+
+void DataBase::flushSlowQueries() {
+    std::vector<SlowQueryLog::Entry> entries;
+    entries.swap(pendingSlowQueries);
+
+    profilingSuspended = true;
+    try {
+        for (SlowQueryLog::Entry &entry : entries) {
+            if (entry.queryPlan.empty()) entry.queryPlan = explainQueryPlan(entry.sql);
+            qWarning() << "Slow query" << QString::fromStdString(entry.fingerprint) << entry.durationNs / 1000000 << "ms:"
+                       << QString::fromStdString(entry.sql).simplified().left(200);
+            SlowQueryLog::append(slowQueryLogPath, entry);
+        }
+    } catch (const std::exception &e) {
+        qWarning() << "Failed to write the slow-query log:" << e.what();
+    }
+    profilingSuspended = false;
+}
+
+DataBase::CallScope::~CallScope() {
+    if (--db->publicCallDepth != 0) return;
+    if (!db->pendingSlowQueries.empty()) db->flushSlowQueries();
+    if (db->committedChanges) db->publishChanges();
+}
+
+void DataBase::setChangeObserver(ChangeObserver observer) {
+    std::lock_guard<std::mutex> lock(changeObserverMutex);
+    changeObserver = std::move(observer);
+}
+
+unsigned DataBase::tableMask(const char* table) {
+    static const std::pair<const char*, unsigned> tables[] = {
+        {"review_schedule", ScheduleTable}, {"deck_counters", ScheduleTable}, {"due_histogram", ScheduleTable},
+        {"vocabulary_lists", ListsTable}, {"words", WordsTable}, {"list_words", ListWordsTable},
+        {"study_sessions", SessionsTable}, {"word_examples", ExamplesTable},
+        {"word_relations", RelationsTable}, {"word_distractors", DistractorsTable},
+        {"distractor_sources", DistractorsTable},
+    };
+    for (const auto &t : tables) {
+        if (std::strcmp(table, t.first) == 0) return t.second;
+    }
+    return OtherTables;
+}
+
+void DataBase::enableChangeHooks() {
+    sqlite3_update_hook(db, &DataBase::updateHook, this);
+    sqlite3_commit_hook(db, &DataBase::commitHook, this);
+    sqlite3_rollback_hook(db, &DataBase::rollbackHook, this);
+}
+
+void DataBase::updateHook(void* self, int, const char* dbName, const char* table, sqlite3_int64) {
+    // Attached and temp databases are private to the connection
+    if (std::strcmp(dbName, "main") != 0) return;
+    static_cast<DataBase*>(self)->uncommittedChanges |= tableMask(table);
+}
+
+int DataBase::commitHook(void* self) {
+    DataBase* database = static_cast<DataBase*>(self);
+    // Dropped again by publishChanges(): a reader may cache the pre-commit rows until the commit lands
+    if (database->uncommittedChanges) QueryCache::instance().invalidate(database->uncommittedChanges);
+    database->committedChanges |= database->uncommittedChanges;
+    database->uncommittedChanges = 0;
+    return 0;
+}
+
+void DataBase::rollbackHook(void* self) {
+    static_cast<DataBase*>(self)->uncommittedChanges = 0;
+}
+
+void DataBase::publishChanges() {
+    unsigned tables = committedChanges;
+    committedChanges = 0;
+    QueryCache::instance().invalidate(tables);
+
+    ChangeObserver observer;
+    {
+        std::lock_guard<std::mutex> lock(changeObserverMutex);
+        observer = changeObserver;
+    }
+    if (!observer) return;
+    try {
+        observer(tables);
+    } catch (const std::exception &e) {
+        qWarning() << "Change observer failed:" << e.what();
+    }
+}
+
 sqlite3_stmt* DataBase::prepareStatementOrThrow(const char* sql, const std::string& context) {
     sqlite3_stmt* stmt = nullptr;
     int rc = sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr);
@@ -63,6 +327,7 @@ void DataBase::executeStatementOrThrow(sqlite3_stmt* stmt, const std::string& co
 }
 
 void DataBase::enableForeignKeys() {
+    DB_SCOPE("enableForeignKeys");
     char* errorMessage = nullptr;
 
     int result = sqlite3_exec(db, "PRAGMA foreign_keys = ON;", nullptr, nullptr, &errorMessage);
@@ -74,14 +339,47 @@ void DataBase::enableForeignKeys() {
     }
 }
 
+void DataBase::enableWriteAheadLog() {
+    DB_SCOPE("enableWriteAheadLog");
+    char* errorMessage = nullptr;
+
+    // busy_timeout lets this connection wait briefly for a background writer instead of failing with SQLITE_BUSY.
+    // It goes first: switching the journal mode itself needs a lock another connection may hold.
+    int result = sqlite3_exec(db, "PRAGMA busy_timeout = 5000; PRAGMA journal_mode = WAL;", nullptr, nullptr, &errorMessage);
+    if (result != SQLITE_OK) {
+        QString error = "Failed to enable WAL journal mode: " + QString::fromUtf8(errorMessage ? errorMessage : "");
+        qCritical() << error;
+        sqlite3_free(errorMessage);
+        throw std::runtime_error(error.toStdString());
+    }
+}
+
+void DataBase::enableIncrementalVacuum() {
+    DB_SCOPE("enableIncrementalVacuum");
+    char* errorMessage = nullptr;
+
+    int result = sqlite3_exec(db, "PRAGMA auto_vacuum = INCREMENTAL;", nullptr, nullptr, &errorMessage);
+    if (result != SQLITE_OK) {
+        QString error = "Failed to set auto_vacuum: " + QString::fromUtf8(errorMessage ? errorMessage : "");
+        qCritical() << error;
+        sqlite3_free(errorMessage);
+        throw std::runtime_error(error.toStdString());
+    }
+}
+
 bool DataBase::createVocabListTable() {
+    DB_SCOPE("createVocabListTable");
     const char* sql =
         "CREATE TABLE IF NOT EXISTS vocabulary_lists ("
         "list_id INTEGER PRIMARY KEY AUTOINCREMENT, "
         "list_name TEXT NOT NULL, "
         "description TEXT, "
         "language TEXT, "
-        "date_created DATETIME DEFAULT CURRENT_TIMESTAMP "
+        "date_created DATETIME DEFAULT CURRENT_TIMESTAMP, "
+        "is_deleted INTEGER NOT NULL DEFAULT 0, "
+        "scheduler TEXT NOT NULL DEFAULT 'sm2' CHECK (scheduler IN ('sm2', 'fsrs')), "
+        "sm2_first_interval INTEGER NOT NULL DEFAULT 1 CHECK (sm2_first_interval >= 1), "
+        "sm2_second_interval INTEGER NOT NULL DEFAULT 6 CHECK (sm2_second_interval >= 1) "
         ");";
 
     char* errorMessage = nullptr;
@@ -93,10 +391,16 @@ bool DataBase::createVocabListTable() {
         throw std::runtime_error(error.toStdString());
     }
 
+    addColumnIfMissing("vocabulary_lists", "is_deleted", "INTEGER NOT NULL DEFAULT 0");
+    addColumnIfMissing("vocabulary_lists", "scheduler", "TEXT NOT NULL DEFAULT 'sm2' CHECK (scheduler IN ('sm2', 'fsrs'))");
+    addColumnIfMissing("vocabulary_lists", "sm2_first_interval", "INTEGER NOT NULL DEFAULT 1 CHECK (sm2_first_interval >= 1)");
+    addColumnIfMissing("vocabulary_lists", "sm2_second_interval", "INTEGER NOT NULL DEFAULT 6 CHECK (sm2_second_interval >= 1)");
+
     return true;
 }
 
 bool DataBase::createWordsTable() {
+    DB_SCOPE("createWordsTable");
     const char* sql =
         "CREATE TABLE IF NOT EXISTS words ("
         "word_id INTEGER PRIMARY KEY AUTOINCREMENT, "
@@ -120,6 +424,7 @@ bool DataBase::createWordsTable() {
 }
 
 bool DataBase::createListWordTable() {
+    DB_SCOPE("createListWordTable");
     const char* sql =
         "CREATE TABLE IF NOT EXISTS list_words ("
         "list_word_id INTEGER PRIMARY KEY AUTOINCREMENT, "
@@ -156,6 +461,7 @@ bool DataBase::createListWordTable() {
 }
 
 bool DataBase::createStudySessionTable() {
+    DB_SCOPE("createStudySessionTable");
     const char* sql =
         "CREATE TABLE IF NOT EXISTS study_sessions ( "
         "session_id INTEGER PRIMARY KEY, "
@@ -177,10 +483,27 @@ bool DataBase::createStudySessionTable() {
         throw std::runtime_error(error.toStdString());
     }
 
+    // 0 for random practice: rated, but outside the schedule, so the FSRS fit must not learn from it
+    addColumnIfMissing("study_sessions", "scheduled", "INTEGER NOT NULL DEFAULT 1");
+
+    // word_id: the orphan collector's "no study history" check; list_id: batched list purges
+    const char* indexSql =
+        "CREATE INDEX IF NOT EXISTS idx_study_sessions_word_id ON study_sessions(word_id); "
+        "CREATE INDEX IF NOT EXISTS idx_study_sessions_list_id ON study_sessions(list_id);";
+
+    result = sqlite3_exec(db, indexSql, nullptr, nullptr, &errorMessage);
+    if (result != SQLITE_OK) {
+        QString error = "Failed to create index on study_sessions: " + QString::fromUtf8(errorMessage ? errorMessage : "");
+        qCritical() << error;
+        sqlite3_free(errorMessage);
+        throw std::runtime_error(error.toStdString());
+    }
+
     return true;
 }
 
 bool DataBase::createReviewScheduleTable() {
+    DB_SCOPE("createReviewScheduleTable");
     const char* sql =
         "CREATE TABLE IF NOT EXISTS review_schedule ( "
         "schedule_id INTEGER PRIMARY KEY AUTOINCREMENT, "
@@ -190,6 +513,8 @@ bool DataBase::createReviewScheduleTable() {
         "ease_factor REAL CHECK (ease_factor BETWEEN 1.3 AND 2.5), "
         "interval_days INTEGER NOT NULL DEFAULT 0, "
         "repetition_count INTEGER NOT NULL DEFAULT 0, "
+        "fsrs_stability REAL, "
+        "fsrs_difficulty REAL, "
         "FOREIGN KEY (word_id) REFERENCES words(word_id), "
         "FOREIGN KEY (list_id) REFERENCES vocabulary_lists(list_id) "
         ");";
@@ -203,9 +528,16 @@ bool DataBase::createReviewScheduleTable() {
         throw std::runtime_error(error.toStdString());
     }
 
+    addColumnIfMissing("review_schedule", "fsrs_stability", "REAL");
+    addColumnIfMissing("review_schedule", "fsrs_difficulty", "REAL");
+
+    // Due counts per list are range probes on (list_id, next_review_date); the partial index
+    // answers the same probe for cards that were never reviewed. idx_list_id is a prefix of the former.
      const char* indexSql =
         "CREATE INDEX IF NOT EXISTS idx_next_review_date ON review_schedule(next_review_date); "
-        "CREATE INDEX IF NOT EXISTS idx_list_id ON review_schedule(list_id);";
+        "CREATE INDEX IF NOT EXISTS idx_review_schedule_list_due ON review_schedule(list_id, next_review_date); "
+        "CREATE INDEX IF NOT EXISTS idx_review_schedule_new_due ON review_schedule(list_id, next_review_date) WHERE repetition_count = 0; "
+        "DROP INDEX IF EXISTS idx_list_id;";
 
     result = sqlite3_exec(db,indexSql, nullptr, nullptr, &errorMessage);
     if (result != SQLITE_OK) {
@@ -219,6 +551,7 @@ bool DataBase::createReviewScheduleTable() {
 }
 
 bool DataBase::createExampleTable() {
+    DB_SCOPE("createExampleTable");
     const char* sql =
         "CREATE TABLE IF NOT EXISTS word_examples ( "
         "example_id INTEGER PRIMARY KEY, "
@@ -253,69 +586,73 @@ bool DataBase::createExampleTable() {
 }
 
 std::string DataBase::getStudySessionSummary() {
-    std::ostringstream out;
-
-    const char* totalSql = "SELECT COUNT(*) FROM study_sessions;";
-    sqlite3_stmt* stmt = nullptr;
-    int rc = sqlite3_prepare_v2(db, totalSql, -1, &stmt, nullptr);
-    long long total = 0;
-    if (rc == SQLITE_OK) {
-        if (sqlite3_step(stmt) == SQLITE_ROW) {
-            total = sqlite3_column_int64(stmt, 0);
+    DB_SCOPE("getStudySessionSummary");
+    return cachedRead<std::string>("getStudySessionSummary", SessionsTable, [this]() {
+        std::ostringstream out;
+
+        const char* totalSql = "SELECT COUNT(*) FROM study_sessions;";
+        sqlite3_stmt* stmt = nullptr;
+        int rc = sqlite3_prepare_v2(db, totalSql, -1, &stmt, nullptr);
+        long long total = 0;
+        if (rc == SQLITE_OK) {
+            if (sqlite3_step(stmt) == SQLITE_ROW) {
+                total = sqlite3_column_int64(stmt, 0);
+            }
         }
-    }
-    sqlite3_finalize(stmt);
+        sqlite3_finalize(stmt);
 
-    const char* correctSql = "SELECT COUNT(*) FROM study_sessions WHERE was_correct = 1;";
-    rc = sqlite3_prepare_v2(db, correctSql, -1, &stmt, nullptr);
-    long long correct = 0;
-    if (rc == SQLITE_OK) {
-        if (sqlite3_step(stmt) == SQLITE_ROW) {
-            correct = sqlite3_column_int64(stmt, 0);
+        const char* correctSql = "SELECT COUNT(*) FROM study_sessions WHERE was_correct = 1;";
+        rc = sqlite3_prepare_v2(db, correctSql, -1, &stmt, nullptr);
+        long long correct = 0;
+        if (rc == SQLITE_OK) {
+            if (sqlite3_step(stmt) == SQLITE_ROW) {
+                correct = sqlite3_column_int64(stmt, 0);
+            }
         }
-    }
-    sqlite3_finalize(stmt);
+        sqlite3_finalize(stmt);
 
-    const char* avgConfSql = "SELECT AVG(confidence_score) FROM study_sessions WHERE confidence_score IS NOT NULL;";
-    rc = sqlite3_prepare_v2(db, avgConfSql, -1, &stmt, nullptr);
-    double avgConf = 0.0;
-    bool hasAvgConf = false;
-    if (rc == SQLITE_OK) {
-        if (sqlite3_step(stmt) == SQLITE_ROW) {
-            if (sqlite3_column_type(stmt,0) != SQLITE_NULL) {
-                avgConf = sqlite3_column_double(stmt, 0);
-                hasAvgConf = true;
+        const char* avgConfSql = "SELECT AVG(confidence_score) FROM study_sessions WHERE confidence_score IS NOT NULL;";
+        rc = sqlite3_prepare_v2(db, avgConfSql, -1, &stmt, nullptr);
+        double avgConf = 0.0;
+        bool hasAvgConf = false;
+        if (rc == SQLITE_OK) {
+            if (sqlite3_step(stmt) == SQLITE_ROW) {
+                if (sqlite3_column_type(stmt,0) != SQLITE_NULL) {
+                    avgConf = sqlite3_column_double(stmt, 0);
+                    hasAvgConf = true;
+                }
             }
         }
-    }
-    sqlite3_finalize(stmt);
-
-    out << "Study Sessions Summary:\n";
-    out << "Total sessions: " << total << "\n";
-    out << "Correct responses: " << correct << "\n";
-    if (total > 0) {
-        double pct = (100.0 * static_cast<double>(correct)) / static_cast<double>(total);
-        out << "Percent correct: " << std::round(pct * 100.0) / 100.0 << "%\n";
-    }
-    if (hasAvgConf) out << "Average confidence (1-5): " << std::round(avgConf * 100.0) / 100.0 << "\n";
+        sqlite3_finalize(stmt);
 
-    // breakdown by study_mode
-    const char* modeSql = "SELECT COALESCE(study_mode, 'unknown'), COUNT(*) FROM study_sessions GROUP BY study_mode;";
-    rc = sqlite3_prepare_v2(db, modeSql, -1, &stmt, nullptr);
-    if (rc == SQLITE_OK) {
-        out << "Sessions by mode:\n";
-        while (sqlite3_step(stmt) == SQLITE_ROW) {
-            const unsigned char* mode = sqlite3_column_text(stmt, 0);
-            long long cnt = sqlite3_column_int64(stmt, 1);
-            out << "  " << (mode ? reinterpret_cast<const char*>(mode) : "unknown") << ": " << cnt << "\n";
+        out << "Study Sessions Summary:\n";
+        out << "Total sessions: " << total << "\n";
+        out << "Correct responses: " << correct << "\n";
+        if (total > 0) {
+            double pct = (100.0 * static_cast<double>(correct)) / static_cast<double>(total);
+            out << "Percent correct: " << std::round(pct * 100.0) / 100.0 << "%\n";
         }
-    }
-    sqlite3_finalize(stmt);
+        if (hasAvgConf) out << "Average confidence (1-5): " << std::round(avgConf * 100.0) / 100.0 << "\n";
+
+        // breakdown by study_mode
+        const char* modeSql = "SELECT COALESCE(study_mode, 'unknown'), COUNT(*) FROM study_sessions GROUP BY study_mode;";
+        rc = sqlite3_prepare_v2(db, modeSql, -1, &stmt, nullptr);
+        if (rc == SQLITE_OK) {
+            out << "Sessions by mode:\n";
+            while (sqlite3_step(stmt) == SQLITE_ROW) {
+                const unsigned char* mode = sqlite3_column_text(stmt, 0);
+                long long cnt = sqlite3_column_int64(stmt, 1);
+                out << "  " << (mode ? reinterpret_cast<const char*>(mode) : "unknown") << ": " << cnt << "\n";
+            }
+        }
+        sqlite3_finalize(stmt);
 
-    return out.str();
+        return out.str();
+    });
 }
 
 bool DataBase::createWordRelationTable() {
+    DB_SCOPE("createWordRelationTable");
     const char* sql =
         "CREATE TABLE IF NOT EXISTS word_relations ( "
         "relation_id INTEGER PRIMARY KEY, "
@@ -352,144 +689,484 @@ bool DataBase::createWordRelationTable() {
     return true;
 }
 
-bool DataBase::createNewList(std::string listName, std::string targetLanguage = "", std::string description = "") {
-    const char* sql = "INSERT INTO vocabulary_lists (list_name, description, language, date_created) VALUES (?, ?, ?, datetime('now'));";
+bool DataBase::createDistractorTable() {
+    DB_SCOPE("createDistractorTable");
+    const char* sql =
+        "CREATE TABLE IF NOT EXISTS word_distractors ( "
+        "list_id INTEGER NOT NULL, "
+        "word_id INTEGER NOT NULL, "
+        "rank INTEGER NOT NULL, "
+        "distractor_word_id INTEGER NOT NULL, "
+        "score REAL NOT NULL, "
+        "PRIMARY KEY (list_id, word_id, rank), "
+        "FOREIGN KEY (list_id) REFERENCES vocabulary_lists(list_id) ON DELETE CASCADE, "
+        "FOREIGN KEY (word_id) REFERENCES words(word_id) ON DELETE CASCADE, "
+        "FOREIGN KEY (distractor_word_id) REFERENCES words(word_id) ON DELETE CASCADE "
+        ") WITHOUT ROWID;";
 
-    sqlite3_stmt* stmt;
-    int result = sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr);
+    char* errorMessage = nullptr;
+    int result = sqlite3_exec(db, sql, nullptr, nullptr, &errorMessage);
     if (result != SQLITE_OK) {
-        QString errorMsg = "Failed to prepare statement for createNewList: " + QString::fromStdString(std::string(sqlite3_errmsg(db)));
-        qCritical() << errorMsg;
-        throw std::runtime_error(errorMsg.toStdString());
+        QString error = "Failed to create word_distractors table: " + QString::fromUtf8(errorMessage ? errorMessage : "");
+        qCritical() << error;
+        sqlite3_free(errorMessage);
+        throw std::runtime_error(error.toStdString());
     }
 
-    sqlite3_bind_text(stmt, 1, listName.c_str(), -1, SQLITE_TRANSIENT);
-    sqlite3_bind_text(stmt, 2, description.c_str(), -1, SQLITE_TRANSIENT);
-    sqlite3_bind_text(stmt, 3, targetLanguage.c_str(), -1, SQLITE_TRANSIENT);
+    // Needed so the ON DELETE CASCADE from words does not scan the whole table
+    const char* indexSql =
+        "CREATE INDEX IF NOT EXISTS idx_word_distractors_distractor ON word_distractors(distractor_word_id); ";
 
-    result = sqlite3_step(stmt);
-    if (result != SQLITE_DONE) {
-        sqlite3_finalize(stmt);
-        QString errorMsg = "Execution failed for createNewList: " + QString::fromStdString(std::string(sqlite3_errmsg(db)));
-        qCritical() << errorMsg;
-        throw std::runtime_error(errorMsg.toStdString());
+    result = sqlite3_exec(db, indexSql, nullptr, nullptr, &errorMessage);
+    if (result != SQLITE_OK) {
+        QString error = "Failed to create index on word_distractors: " + QString::fromUtf8(errorMessage ? errorMessage : "");
+        qCritical() << error;
+        sqlite3_free(errorMessage);
+        throw std::runtime_error(error.toStdString());
     }
 
-    sqlite3_finalize(stmt);
+    // Which state of list_words each list's rows were built from, so unchanged lists are skipped on launch
+    const char* sourcesSql =
+        "CREATE TABLE IF NOT EXISTS distractor_sources ( "
+        "list_id INTEGER PRIMARY KEY, "
+        "word_count INTEGER NOT NULL, "
+        "max_list_word_id INTEGER NOT NULL, "
+        "FOREIGN KEY (list_id) REFERENCES vocabulary_lists(list_id) ON DELETE CASCADE "
+        ");";
+
+    result = sqlite3_exec(db, sourcesSql, nullptr, nullptr, &errorMessage);
+    if (result != SQLITE_OK) {
+        QString error = "Failed to create distractor_sources table: " + QString::fromUtf8(errorMessage ? errorMessage : "");
+        qCritical() << error;
+        sqlite3_free(errorMessage);
+        throw std::runtime_error(error.toStdString());
+    }
 
     return true;
 }
 
-bool DataBase::deleteList(int listID) {
-    // Begin transaction
-    if (!beginTransaction()) {
-        QString errorMsg = "Failed to begin transaction for deleteList";
-        qCritical() << errorMsg;
-        throw std::runtime_error(errorMsg.toStdString());
+bool DataBase::createAIResponseCacheTable() {
+    DB_SCOPE("createAIResponseCacheTable");
+    const char* sql =
+        "CREATE TABLE IF NOT EXISTS ai_response_cache ( "
+        "cache_key TEXT PRIMARY KEY, "
+        "entries_json TEXT NOT NULL, "
+        "size_bytes INTEGER NOT NULL, "
+        "created_at INTEGER NOT NULL, "
+        "last_access INTEGER NOT NULL "
+        ");";
+
+    char* errorMessage = nullptr;
+    int result = sqlite3_exec(db, sql, nullptr, nullptr, &errorMessage);
+    if (result != SQLITE_OK) {
+        QString error = "Failed to create ai_response_cache table: " + QString::fromUtf8(errorMessage ? errorMessage : "");
+        qCritical() << error;
+        sqlite3_free(errorMessage);
+        throw std::runtime_error(error.toStdString());
     }
 
-    try {
-        // Delete from review_schedule (no CASCADE)
-        const char* delReviewSql = "DELETE FROM review_schedule WHERE list_id = ?;";
-        sqlite3_stmt* stmt;
-        int result = sqlite3_prepare_v2(db, delReviewSql, -1, &stmt, nullptr);
-        if (result != SQLITE_OK) {
-            rollbackTransaction();
-            QString errorMsg = "Failed to prepare review_schedule delete: " + QString::fromStdString(std::string(sqlite3_errmsg(db)));
-            qCritical() << errorMsg;
-            throw std::runtime_error(errorMsg.toStdString());
-        }
-        sqlite3_bind_int(stmt, 1, listID);
-        result = sqlite3_step(stmt);
-        sqlite3_finalize(stmt);
-        if (result != SQLITE_DONE) {
-            rollbackTransaction();
-            QString errorMsg = "Failed to delete from review_schedule: " + QString::fromStdString(std::string(sqlite3_errmsg(db)));
-            qCritical() << errorMsg;
-            throw std::runtime_error(errorMsg.toStdString());
-        }
+    const char* indexSql =
+        "CREATE INDEX IF NOT EXISTS idx_ai_response_cache_last_access ON ai_response_cache(last_access); ";
 
-        // Delete from study_sessions (no CASCADE on list_id)
-        const char* delSessionsSql = "DELETE FROM study_sessions WHERE list_id = ?;";
-        result = sqlite3_prepare_v2(db, delSessionsSql, -1, &stmt, nullptr);
-        if (result != SQLITE_OK) {
-            rollbackTransaction();
-            QString errorMsg = "Failed to prepare study_sessions delete: " + QString::fromStdString(std::string(sqlite3_errmsg(db)));
-            qCritical() << errorMsg;
-            throw std::runtime_error(errorMsg.toStdString());
-        }
-        sqlite3_bind_int(stmt, 1, listID);
-        result = sqlite3_step(stmt);
-        sqlite3_finalize(stmt);
-        if (result != SQLITE_DONE) {
-            rollbackTransaction();
-            QString errorMsg = "Failed to delete from study_sessions: " + QString::fromStdString(std::string(sqlite3_errmsg(db)));
-            qCritical() << errorMsg;
-            throw std::runtime_error(errorMsg.toStdString());
-        }
+    result = sqlite3_exec(db, indexSql, nullptr, nullptr, &errorMessage);
+    if (result != SQLITE_OK) {
+        QString error = "Failed to create index on ai_response_cache: " + QString::fromUtf8(errorMessage ? errorMessage : "");
+        qCritical() << error;
+        sqlite3_free(errorMessage);
+        throw std::runtime_error(error.toStdString());
+    }
 
-        // Finally, delete the list itself (list_words will CASCADE automatically)
-        const char* delListSql = "DELETE FROM vocabulary_lists WHERE list_id = ?;";
-        result = sqlite3_prepare_v2(db, delListSql, -1, &stmt, nullptr);
-        if (result != SQLITE_OK) {
-            rollbackTransaction();
-            QString errorMsg = "Failed to prepare vocabulary_lists delete: " + QString::fromStdString(std::string(sqlite3_errmsg(db)));
-            qCritical() << errorMsg;
-            throw std::runtime_error(errorMsg.toStdString());
-        }
-        sqlite3_bind_int(stmt, 1, listID);
-        result = sqlite3_step(stmt);
-        sqlite3_finalize(stmt);
-        if (result != SQLITE_DONE) {
-            rollbackTransaction();
-            QString errorMsg = "Failed to delete vocabulary list: " + QString::fromStdString(std::string(sqlite3_errmsg(db)));
-            qCritical() << errorMsg;
-            throw std::runtime_error(errorMsg.toStdString());
-        }
+    return true;
+}
 
-        // Commit transaction
-        if (!commitTransaction()) {
-            rollbackTransaction();
-            QString errorMsg = "Failed to commit transaction for deleteList";
-            qCritical() << errorMsg;
-            throw std::runtime_error(errorMsg.toStdString());
-        }
+bool DataBase::createEnrichmentProgressTable() {
+    DB_SCOPE("createEnrichmentProgressTable");
+    const char* sql =
+        "CREATE TABLE IF NOT EXISTS enrichment_progress ( "
+        "job_name TEXT PRIMARY KEY, "
+        "last_word_id INTEGER NOT NULL DEFAULT 0, "
+        "processed_count INTEGER NOT NULL DEFAULT 0, "
+        "updated_at DATETIME NOT NULL DEFAULT CURRENT_TIMESTAMP "
+        ");";
 
-        return true;
-    } catch (...) {
-        rollbackTransaction();
-        throw;
+    char* errorMessage = nullptr;
+    int result = sqlite3_exec(db, sql, nullptr, nullptr, &errorMessage);
+    if (result != SQLITE_OK) {
+        QString error = "Failed to create enrichment_progress table: " + QString::fromUtf8(errorMessage ? errorMessage : "");
+        qCritical() << error;
+        sqlite3_free(errorMessage);
+        throw std::runtime_error(error.toStdString());
     }
+
+    return true;
 }
 
-std::vector<std::string> DataBase::getVocabLists() {
-    std::vector<std::string> allVocabLists;
-    const char* sql = "SELECT DISTINCT list_name FROM vocabulary_lists ORDER BY list_name";
+bool DataBase::createMaintenanceStateTable() {
+    DB_SCOPE("createMaintenanceStateTable");
+    const char* sql =
+        "CREATE TABLE IF NOT EXISTS maintenance_state ( "
+        "task TEXT PRIMARY KEY, "
+        "last_run DATETIME NOT NULL, "
+        "baseline INTEGER NOT NULL DEFAULT 0 "
+        ");";
 
-    sqlite3_stmt* stmt;
-    int result = sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr);
+    char* errorMessage = nullptr;
+    int result = sqlite3_exec(db, sql, nullptr, nullptr, &errorMessage);
     if (result != SQLITE_OK) {
-        QString errorMsg = "Failed to prepare statement for getVocabLists: " + QString::fromStdString(std::string(sqlite3_errmsg(db)));
-        qCritical() << errorMsg;
-        throw std::runtime_error(errorMsg.toStdString());
+        QString error = "Failed to create maintenance_state table: " + QString::fromUtf8(errorMessage ? errorMessage : "");
+        qCritical() << error;
+        sqlite3_free(errorMessage);
+        throw std::runtime_error(error.toStdString());
     }
 
-    while (sqlite3_step(stmt) == SQLITE_ROW) {
-        const char* listName = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0));
-        if (listName) {
-            allVocabLists.push_back(std::string(listName));
-        }
+    return true;
+}
+
+bool DataBase::createDeckCountersTable() {
+    DB_SCOPE("createDeckCountersTable");
+    const char* tableSql =
+        "CREATE TABLE IF NOT EXISTS deck_counters ( "
+        "list_id INTEGER PRIMARY KEY, "
+        "total_cards INTEGER NOT NULL DEFAULT 0, "
+        "new_cards INTEGER NOT NULL DEFAULT 0 "
+        ");";
+
+    // A card counts as new while repetition_count = 0. Updates only touch the counters when the
+    // list or the new/started state changes, which is once per card for the usual rating flow.
+    const char* triggerSql =
+        "CREATE TRIGGER IF NOT EXISTS trg_deck_counters_insert AFTER INSERT ON review_schedule "
+        "WHEN NEW.list_id IS NOT NULL BEGIN "
+        "  INSERT INTO deck_counters (list_id, total_cards, new_cards) VALUES (NEW.list_id, 1, NEW.repetition_count = 0) "
+        "  ON CONFLICT(list_id) DO UPDATE SET total_cards = total_cards + 1, new_cards = new_cards + (NEW.repetition_count = 0); "
+        "END; "
+        "CREATE TRIGGER IF NOT EXISTS trg_deck_counters_delete AFTER DELETE ON review_schedule "
+        "WHEN OLD.list_id IS NOT NULL BEGIN "
+        "  UPDATE deck_counters SET total_cards = total_cards - 1, new_cards = new_cards - (OLD.repetition_count = 0) "
+        "  WHERE list_id = OLD.list_id; "
+        "END; "
+        "CREATE TRIGGER IF NOT EXISTS trg_deck_counters_update AFTER UPDATE OF list_id, repetition_count ON review_schedule "
+        "WHEN OLD.list_id IS NOT NEW.list_id OR (OLD.repetition_count = 0) IS NOT (NEW.repetition_count = 0) BEGIN "
+        "  UPDATE deck_counters SET total_cards = total_cards - 1, new_cards = new_cards - (OLD.repetition_count = 0) "
+        "  WHERE list_id = OLD.list_id; "
+        "  INSERT INTO deck_counters (list_id, total_cards, new_cards) SELECT NEW.list_id, 1, NEW.repetition_count = 0 "
+        "  WHERE NEW.list_id IS NOT NULL "
+        "  ON CONFLICT(list_id) DO UPDATE SET total_cards = total_cards + 1, new_cards = new_cards + (NEW.repetition_count = 0); "
+        "END; "
+        "CREATE TRIGGER IF NOT EXISTS trg_deck_counters_list_delete AFTER DELETE ON vocabulary_lists BEGIN "
+        "  DELETE FROM deck_counters WHERE list_id = OLD.list_id; "
+        "END;";
+
+    // Counts for rows written before the triggers existed
+    const char* backfillSql =
+        "DELETE FROM deck_counters; "
+        "INSERT INTO deck_counters (list_id, total_cards, new_cards) "
+        "SELECT list_id, COUNT(*), SUM(repetition_count = 0) FROM review_schedule "
+        "WHERE list_id IS NOT NULL GROUP BY list_id;";
+
+    char* errorMessage = nullptr;
+    int result = sqlite3_exec(db, tableSql, nullptr, nullptr, &errorMessage);
+    if (result != SQLITE_OK) {
+        QString error = "Failed to create deck_counters table: " + QString::fromUtf8(errorMessage ? errorMessage : "");
+        qCritical() << error;
+        sqlite3_free(errorMessage);
+        throw std::runtime_error(error.toStdString());
     }
 
+    sqlite3_stmt* stmt = prepareStatementOrThrow(
+        "SELECT COUNT(*) FROM sqlite_master WHERE type = 'trigger' AND name = 'trg_deck_counters_update';",
+        "createDeckCountersTable check");
+    bool installed = sqlite3_step(stmt) == SQLITE_ROW && sqlite3_column_int(stmt, 0) > 0;
     sqlite3_finalize(stmt);
+    if (installed) return true;
+
+    // Triggers and backfill in one transaction so no write slips in between
+    try {
+        beginImmediateTransaction();
+        for (const char* sql : {triggerSql, backfillSql}) {
+            result = sqlite3_exec(db, sql, nullptr, nullptr, &errorMessage);
+            if (result != SQLITE_OK) {
+                QString error = "Failed to set up deck_counters: " + QString::fromUtf8(errorMessage ? errorMessage : "");
+                qCritical() << error;
+                sqlite3_free(errorMessage);
+                throw std::runtime_error(error.toStdString());
+            }
+        }
+        commitTransaction();
+    } catch (...) {
+        try { rollbackTransaction(); } catch (...) {}
+        throw;
+    }
+
+    return true;
+}
+
+bool DataBase::createDueHistogramTable() {
+    DB_SCOPE("createDueHistogramTable");
+    const char* tableSql =
+        "CREATE TABLE IF NOT EXISTS due_histogram ( "
+        "due_day INTEGER PRIMARY KEY, "
+        "card_count INTEGER NOT NULL DEFAULT 0 "
+        ");";
+
+    // due_day is the UTC day of next_review_date counted from the Unix epoch. Ratings move a
+    // card from one day to another; reschedules within the same day leave the histogram alone.
+    const char* triggerSql =
+        "CREATE TRIGGER IF NOT EXISTS trg_due_histogram_insert AFTER INSERT ON review_schedule "
+        "WHEN NEW.next_review_date IS NOT NULL BEGIN "
+        "  INSERT INTO due_histogram (due_day, card_count) VALUES (CAST(strftime('%s', NEW.next_review_date) AS INTEGER) / 86400, 1) "
+        "  ON CONFLICT(due_day) DO UPDATE SET card_count = card_count + 1; "
+        "END; "
+        "CREATE TRIGGER IF NOT EXISTS trg_due_histogram_delete AFTER DELETE ON review_schedule "
+        "WHEN OLD.next_review_date IS NOT NULL BEGIN "
+        "  UPDATE due_histogram SET card_count = card_count - 1 "
+        "  WHERE due_day = CAST(strftime('%s', OLD.next_review_date) AS INTEGER) / 86400; "
+        "END; "
+        "CREATE TRIGGER IF NOT EXISTS trg_due_histogram_update AFTER UPDATE OF next_review_date ON review_schedule "
+        "WHEN CAST(strftime('%s', OLD.next_review_date) AS INTEGER) / 86400 "
+        "  IS NOT CAST(strftime('%s', NEW.next_review_date) AS INTEGER) / 86400 BEGIN "
+        "  UPDATE due_histogram SET card_count = card_count - 1 "
+        "  WHERE due_day = CAST(strftime('%s', OLD.next_review_date) AS INTEGER) / 86400; "
+        "  INSERT INTO due_histogram (due_day, card_count) "
+        "  SELECT CAST(strftime('%s', NEW.next_review_date) AS INTEGER) / 86400, 1 WHERE NEW.next_review_date IS NOT NULL "
+        "  ON CONFLICT(due_day) DO UPDATE SET card_count = card_count + 1; "
+        "END;";
+
+    // Counts for rows written before the triggers existed
+    const char* backfillSql =
+        "DELETE FROM due_histogram; "
+        "INSERT INTO due_histogram (due_day, card_count) "
+        "SELECT CAST(strftime('%s', next_review_date) AS INTEGER) / 86400 AS day, COUNT(*) FROM review_schedule "
+        "WHERE next_review_date IS NOT NULL GROUP BY day;";
+
+    char* errorMessage = nullptr;
+    int result = sqlite3_exec(db, tableSql, nullptr, nullptr, &errorMessage);
+    if (result != SQLITE_OK) {
+        QString error = "Failed to create due_histogram table: " + QString::fromUtf8(errorMessage ? errorMessage : "");
+        qCritical() << error;
+        sqlite3_free(errorMessage);
+        throw std::runtime_error(error.toStdString());
+    }
+
+    sqlite3_stmt* stmt = prepareStatementOrThrow(
+        "SELECT COUNT(*) FROM sqlite_master WHERE type = 'trigger' AND name = 'trg_due_histogram_update';",
+        "createDueHistogramTable check");
+    bool installed = sqlite3_step(stmt) == SQLITE_ROW && sqlite3_column_int(stmt, 0) > 0;
+    sqlite3_finalize(stmt);
+    if (installed) return true;
+
+    // Triggers and backfill in one transaction so no write slips in between
+    try {
+        beginImmediateTransaction();
+        for (const char* sql : {triggerSql, backfillSql}) {
+            result = sqlite3_exec(db, sql, nullptr, nullptr, &errorMessage);
+            if (result != SQLITE_OK) {
+                QString error = "Failed to set up due_histogram: " + QString::fromUtf8(errorMessage ? errorMessage : "");
+                qCritical() << error;
+                sqlite3_free(errorMessage);
+                throw std::runtime_error(error.toStdString());
+            }
+        }
+        commitTransaction();
+    } catch (...) {
+        try { rollbackTransaction(); } catch (...) {}
+        throw;
+    }
+
+    return true;
+}
+
+bool DataBase::createSchedulerParamsTable() {
+    DB_SCOPE("createSchedulerParamsTable");
+    const char* sql =
+        "CREATE TABLE IF NOT EXISTS scheduler_params ( "
+        "scheduler TEXT PRIMARY KEY, "
+        "params TEXT NOT NULL, "
+        "review_count INTEGER NOT NULL DEFAULT 0, "
+        "log_loss REAL, "
+        "fitted_at DATETIME "
+        ");";
+
+    char* errorMessage = nullptr;
+    int result = sqlite3_exec(db, sql, nullptr, nullptr, &errorMessage);
+    if (result != SQLITE_OK) {
+        QString error = "Failed to create scheduler_params table: " + QString::fromUtf8(errorMessage ? errorMessage : "");
+        qCritical() << error;
+        sqlite3_free(errorMessage);
+        throw std::runtime_error(error.toStdString());
+    }
+
+    return true;
+}
+
+bool DataBase::createNewList(std::string listName, std::string targetLanguage = "", std::string description = "") {
+    DB_SCOPE("createNewList");
+    const char* sql = "INSERT INTO vocabulary_lists (list_name, description, language, date_created) VALUES (?, ?, ?, datetime('now'));";
+
+    sqlite3_stmt* stmt;
+    int result = sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr);
+    if (result != SQLITE_OK) {
+        QString errorMsg = "Failed to prepare statement for createNewList: " + QString::fromStdString(std::string(sqlite3_errmsg(db)));
+        qCritical() << errorMsg;
+        throw std::runtime_error(errorMsg.toStdString());
+    }
+
+    sqlite3_bind_text(stmt, 1, listName.c_str(), -1, SQLITE_TRANSIENT);
+    sqlite3_bind_text(stmt, 2, description.c_str(), -1, SQLITE_TRANSIENT);
+    sqlite3_bind_text(stmt, 3, targetLanguage.c_str(), -1, SQLITE_TRANSIENT);
+
+    result = sqlite3_step(stmt);
+    if (result != SQLITE_DONE) {
+        sqlite3_finalize(stmt);
+        QString errorMsg = "Execution failed for createNewList: " + QString::fromStdString(std::string(sqlite3_errmsg(db)));
+        qCritical() << errorMsg;
+        throw std::runtime_error(errorMsg.toStdString());
+    }
+
+    sqlite3_finalize(stmt);
+
+    return true;
+}
+
+bool DataBase::deleteList(int listID) {
+    DB_SCOPE("deleteList");
+    // Purging a large list takes seconds, so only hide it here; ListPurgeWorker removes the rows
+    sqlite3_stmt* stmt = prepareStatementOrThrow("UPDATE vocabulary_lists SET is_deleted = 1 WHERE list_id = ?;", "deleteList");
+    sqlite3_bind_int(stmt, 1, listID);
+    executeStatementOrThrow(stmt, "deleteList");
+    sqlite3_finalize(stmt);
+    return true;
+}
+
+std::vector<int> DataBase::getDeletedListIds() {
+    DB_SCOPE("getDeletedListIds");
+    std::vector<int> ids;
+    sqlite3_stmt* stmt = prepareStatementOrThrow("SELECT list_id FROM vocabulary_lists WHERE is_deleted = 1 ORDER BY list_id;", "getDeletedListIds");
+
+    while (sqlite3_step(stmt) == SQLITE_ROW) {
+        ids.push_back(sqlite3_column_int(stmt, 0));
+    }
+
+    sqlite3_finalize(stmt);
+    return ids;
+}
+
+int DataBase::countListRows(int listID) {
+    DB_SCOPE("countListRows");
+    const char* sql =
+        "SELECT (SELECT COUNT(*) FROM review_schedule WHERE list_id = ?1) "
+        "+ (SELECT COUNT(*) FROM study_sessions WHERE list_id = ?1) "
+        "+ (SELECT COUNT(*) FROM word_distractors WHERE list_id = ?1) "
+        "+ (SELECT COUNT(*) FROM list_words WHERE list_id = ?1);";
+
+    sqlite3_stmt* stmt = prepareStatementOrThrow(sql, "countListRows");
+    sqlite3_bind_int(stmt, 1, listID);
+
+    int count = 0;
+    if (sqlite3_step(stmt) == SQLITE_ROW) {
+        count = sqlite3_column_int(stmt, 0);
+    }
+
+    sqlite3_finalize(stmt);
+    return count;
+}
+
+int DataBase::purgeDeletedListBatch(int listID, int batchSize, bool& finished) {
+    DB_SCOPE("purgeDeletedListBatch");
+    // Every statement is bounded by LIMIT and served by an index on list_id
+    static const char* const batchDeletes[] = {
+        "DELETE FROM review_schedule WHERE rowid IN (SELECT rowid FROM review_schedule WHERE list_id = ?1 LIMIT ?2);",
+        "DELETE FROM study_sessions WHERE rowid IN (SELECT rowid FROM study_sessions WHERE list_id = ?1 LIMIT ?2);",
+        "DELETE FROM word_distractors WHERE list_id = ?1 AND (word_id, rank) IN "
+        "(SELECT word_id, rank FROM word_distractors WHERE list_id = ?1 LIMIT ?2);",
+        "DELETE FROM list_words WHERE rowid IN (SELECT rowid FROM list_words WHERE list_id = ?1 LIMIT ?2);",
+    };
+
+    int deleted = 0;
+    finished = false;
+    try {
+        beginImmediateTransaction();
+
+        // Never purge a list that is still visible
+        sqlite3_stmt* stmt = prepareStatementOrThrow("SELECT is_deleted FROM vocabulary_lists WHERE list_id = ?;", "purgeDeletedListBatch check");
+        sqlite3_bind_int(stmt, 1, listID);
+        bool markedDeleted = sqlite3_step(stmt) == SQLITE_ROW && sqlite3_column_int(stmt, 0) != 0;
+        sqlite3_finalize(stmt);
+
+        if (!markedDeleted) {
+            finished = true;
+        } else {
+            for (const char* sql : batchDeletes) {
+                if (deleted >= batchSize) break;
+                stmt = prepareStatementOrThrow(sql, "purgeDeletedListBatch");
+                sqlite3_bind_int(stmt, 1, listID);
+                sqlite3_bind_int(stmt, 2, batchSize - deleted);
+                executeStatementOrThrow(stmt, "purgeDeletedListBatch");
+                deleted += sqlite3_changes(db);
+                sqlite3_finalize(stmt);
+            }
+
+            if (deleted < batchSize) {
+                // Nothing refers to the list any more
+                stmt = prepareStatementOrThrow("DELETE FROM vocabulary_lists WHERE list_id = ? AND is_deleted = 1;", "purgeDeletedListBatch list");
+                sqlite3_bind_int(stmt, 1, listID);
+                executeStatementOrThrow(stmt, "purgeDeletedListBatch list");
+                sqlite3_finalize(stmt);
+                finished = true;
+            }
+        }
+
+        commitTransaction();
+    } catch (...) {
+        try { rollbackTransaction(); } catch (...) {}
+        throw;
+    }
+
+    return deleted;
+}
+
+std::vector<std::string> DataBase::getVocabLists() {
+    DB_SCOPE("getVocabLists");
+    std::vector<std::string> allVocabLists;
+    const char* sql = "SELECT DISTINCT list_name FROM vocabulary_lists WHERE is_deleted = 0 ORDER BY list_name";
+
+    sqlite3_stmt* stmt;
+    int result = sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr);
+    if (result != SQLITE_OK) {
+        QString errorMsg = "Failed to prepare statement for getVocabLists: " + QString::fromStdString(std::string(sqlite3_errmsg(db)));
+        qCritical() << errorMsg;
+        throw std::runtime_error(errorMsg.toStdString());
+    }
+
+    while (sqlite3_step(stmt) == SQLITE_ROW) {
+        const char* listName = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0));
+        if (listName) {
+            allVocabLists.push_back(std::string(listName));
+        }
+    }
+
+    sqlite3_finalize(stmt);
+
+    return allVocabLists;
+}
+
+std::vector<int> DataBase::getVocabListIds() {
+    DB_SCOPE("getVocabListIds");
+    std::vector<int> ids;
+    sqlite3_stmt* stmt = prepareStatementOrThrow("SELECT list_id FROM vocabulary_lists WHERE is_deleted = 0 ORDER BY list_id;", "getVocabListIds");
+
+    while (sqlite3_step(stmt) == SQLITE_ROW) {
+        ids.push_back(sqlite3_column_int(stmt, 0));
+    }
+
+    sqlite3_finalize(stmt);
+    return ids;
+}
 
-    return allVocabLists;
-}
-
 std::vector<std::pair<std::string, std::string>> DataBase::getVocabListsWithNextReview() {
+    DB_SCOPE("getVocabListsWithNextReview");
     std::vector<std::pair<std::string, std::string>> results;
 
-    const char* sql = "SELECT list_id, list_name FROM vocabulary_lists";
+    const char* sql = "SELECT list_id, list_name FROM vocabulary_lists WHERE is_deleted = 0";
     sqlite3_stmt* stmt = nullptr;
     int rc = sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr);
     if (rc != SQLITE_OK) {
@@ -532,6 +1209,7 @@ std::vector<std::pair<std::string, std::string>> DataBase::getVocabListsWithNext
 }
 
 bool DataBase::createNewExample(int wordID, std::string exampleText, std::string contextNotes) {
+    DB_SCOPE("createNewExample");
     const char* sql = "INSERT INTO word_examples (word_id, example_text, context_notes, date_added) VALUES (?, ? , ?, datetime('now'));";
 
     sqlite3_stmt* stmt;
@@ -560,6 +1238,7 @@ bool DataBase::createNewExample(int wordID, std::string exampleText, std::string
 }
 
 bool DataBase::createNewRelation(int word1ID, int word2ID, std::string relationType) {
+    DB_SCOPE("createNewRelation");
     const char* sql = "INSERT INTO word_relations (word1_id, word2_id, relation_type) VALUES (?, ?, ?);";
 
     sqlite3_stmt* stmt;
@@ -588,72 +1267,79 @@ bool DataBase::createNewRelation(int word1ID, int word2ID, std::string relationT
 }
 
 std::vector<DataBase::WordExample> DataBase::getWordExamples(int wordID) {
-    const char* sql = "SELECT example_id, example_text, context_notes FROM word_examples WHERE word_id = ?;";
+    DB_SCOPE("getWordExamples");
+    return cachedRead<std::vector<WordExample>>("getWordExamples|" + std::to_string(wordID), ExamplesTable, [this, wordID]() {
+        const char* sql = "SELECT example_id, example_text, context_notes FROM word_examples WHERE word_id = ?;";
     
-    sqlite3_stmt* stmt;
-    int result = sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr);
-    if (result != SQLITE_OK) {
-        QString errorMsg = "Failed to prepare statement for getWordExamples: " + QString::fromStdString(std::string(sqlite3_errmsg(db)));
-        qCritical() << errorMsg;
-        throw std::runtime_error(errorMsg.toStdString());
-    }
+        sqlite3_stmt* stmt;
+        int result = sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr);
+        if (result != SQLITE_OK) {
+            QString errorMsg = "Failed to prepare statement for getWordExamples: " + QString::fromStdString(std::string(sqlite3_errmsg(db)));
+            qCritical() << errorMsg;
+            throw std::runtime_error(errorMsg.toStdString());
+        }
     
-    sqlite3_bind_int(stmt, 1, wordID);
+        sqlite3_bind_int(stmt, 1, wordID);
     
-    std::vector<WordExample> examples;
-    while (sqlite3_step(stmt) == SQLITE_ROW) {
-        WordExample ex;
-        ex.example_id = sqlite3_column_int(stmt, 0);
+        std::vector<WordExample> examples;
+        while (sqlite3_step(stmt) == SQLITE_ROW) {
+            WordExample ex;
+            ex.example_id = sqlite3_column_int(stmt, 0);
         
-        const unsigned char* example_text = sqlite3_column_text(stmt, 1);
-        ex.example_text = example_text ? std::string(reinterpret_cast<const char*>(example_text)) : "";
+            const unsigned char* example_text = sqlite3_column_text(stmt, 1);
+            ex.example_text = example_text ? std::string(reinterpret_cast<const char*>(example_text)) : "";
         
-        const unsigned char* context_notes = sqlite3_column_text(stmt, 2);
-        ex.context_notes = context_notes ? std::string(reinterpret_cast<const char*>(context_notes)) : "";
+            const unsigned char* context_notes = sqlite3_column_text(stmt, 2);
+            ex.context_notes = context_notes ? std::string(reinterpret_cast<const char*>(context_notes)) : "";
         
-        examples.push_back(ex);
-    }
+            examples.push_back(ex);
+        }
     
-    sqlite3_finalize(stmt);
-    return examples;
+        sqlite3_finalize(stmt);
+        return examples;
+    });
 }
 
 std::vector<DataBase::WordRelation> DataBase::getWordRelations(int wordID) {
-    const char* sql = 
-        "SELECT w.word_id, w.word, wr.relation_type "
-        "FROM word_relations wr "
-        "JOIN words w ON wr.word2_id = w.word_id "
-        "WHERE wr.word1_id = ?;";
+    DB_SCOPE("getWordRelations");
+    return cachedRead<std::vector<WordRelation>>("getWordRelations|" + std::to_string(wordID), RelationsTable | WordsTable, [this, wordID]() {
+        const char* sql = 
+            "SELECT w.word_id, w.word, wr.relation_type "
+            "FROM word_relations wr "
+            "JOIN words w ON wr.word2_id = w.word_id "
+            "WHERE wr.word1_id = ?;";
     
-    sqlite3_stmt* stmt;
-    int result = sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr);
-    if (result != SQLITE_OK) {
-        QString errorMsg = "Failed to prepare statement for getWordRelations: " + QString::fromStdString(std::string(sqlite3_errmsg(db)));
-        qCritical() << errorMsg;
-        throw std::runtime_error(errorMsg.toStdString());
-    }
+        sqlite3_stmt* stmt;
+        int result = sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr);
+        if (result != SQLITE_OK) {
+            QString errorMsg = "Failed to prepare statement for getWordRelations: " + QString::fromStdString(std::string(sqlite3_errmsg(db)));
+            qCritical() << errorMsg;
+            throw std::runtime_error(errorMsg.toStdString());
+        }
     
-    sqlite3_bind_int(stmt, 1, wordID);
+        sqlite3_bind_int(stmt, 1, wordID);
     
-    std::vector<WordRelation> relations;
-    while (sqlite3_step(stmt) == SQLITE_ROW) {
-        WordRelation rel;
-        rel.related_word_id = sqlite3_column_int(stmt, 0);
+        std::vector<WordRelation> relations;
+        while (sqlite3_step(stmt) == SQLITE_ROW) {
+            WordRelation rel;
+            rel.related_word_id = sqlite3_column_int(stmt, 0);
         
-        const unsigned char* word = sqlite3_column_text(stmt, 1);
-        rel.related_word = word ? std::string(reinterpret_cast<const char*>(word)) : "";
+            const unsigned char* word = sqlite3_column_text(stmt, 1);
+            rel.related_word = word ? std::string(reinterpret_cast<const char*>(word)) : "";
         
-        const unsigned char* relation_type = sqlite3_column_text(stmt, 2);
-        rel.relation_type = relation_type ? std::string(reinterpret_cast<const char*>(relation_type)) : "";
+            const unsigned char* relation_type = sqlite3_column_text(stmt, 2);
+            rel.relation_type = relation_type ? std::string(reinterpret_cast<const char*>(relation_type)) : "";
         
-        relations.push_back(rel);
-    }
+            relations.push_back(rel);
+        }
     
-    sqlite3_finalize(stmt);
-    return relations;
+        sqlite3_finalize(stmt);
+        return relations;
+    });
 }
 
 bool DataBase::beginTransaction() {
+    DB_SCOPE("beginTransaction");
     char* err = nullptr;
     int rc = sqlite3_exec(db, "BEGIN TRANSACTION;", nullptr, nullptr, &err);
     if (rc != SQLITE_OK) {
@@ -666,6 +1352,7 @@ bool DataBase::beginTransaction() {
 }
 
 bool DataBase::commitTransaction() {
+    DB_SCOPE("commitTransaction");
     char* err = nullptr;
     int rc = sqlite3_exec(db, "COMMIT;", nullptr, nullptr, &err);
     if (rc != SQLITE_OK) {
@@ -678,6 +1365,7 @@ bool DataBase::commitTransaction() {
 }
 
 bool DataBase::rollbackTransaction() {
+    DB_SCOPE("rollbackTransaction");
     char* err = nullptr;
     int rc = sqlite3_exec(db, "ROLLBACK;", nullptr, nullptr, &err);
     if (rc != SQLITE_OK) {
@@ -689,7 +1377,71 @@ bool DataBase::rollbackTransaction() {
     return true;
 }
 
+bool DataBase::beginImmediateTransaction() {
+    DB_SCOPE("beginImmediateTransaction");
+    char* err = nullptr;
+    int rc = sqlite3_exec(db, "BEGIN IMMEDIATE;", nullptr, nullptr, &err);
+    if (rc != SQLITE_OK) {
+        QString errorMsg = "Failed to begin immediate transaction: " + QString::fromUtf8(err ? err : "");
+        qCritical() << errorMsg;
+        if (err) sqlite3_free(err);
+        throw std::runtime_error(errorMsg.toStdString());
+    }
+    return true;
+}
+
+void DataBase::backupTo(const std::string& destPath, int pagesPerStep, int pauseMs,
+                        const std::function<void(int, int)>& progress) {
+    DB_SCOPE("backupTo");
+    sqlite3* dest = nullptr;
+    if (sqlite3_open(destPath.c_str(), &dest) != SQLITE_OK) {
+        QString errorMsg = "Can't open backup destination: " + QString::fromStdString(std::string(sqlite3_errmsg(dest)));
+        qCritical() << errorMsg;
+        sqlite3_close(dest);
+        throw std::runtime_error(errorMsg.toStdString());
+    }
+
+    // An open read transaction pins one WAL snapshot for the whole copy, so writes from other
+    // connections neither wait for the backup nor force it to restart between steps
+    char* err = nullptr;
+    int rc = sqlite3_exec(db, "BEGIN; SELECT COUNT(*) FROM sqlite_master;", nullptr, nullptr, &err);
+    if (rc != SQLITE_OK) {
+        QString errorMsg = "Failed to start backup read transaction: " + QString::fromUtf8(err ? err : "");
+        qCritical() << errorMsg;
+        if (err) sqlite3_free(err);
+        sqlite3_close(dest);
+        throw std::runtime_error(errorMsg.toStdString());
+    }
+
+    sqlite3_backup* backup = sqlite3_backup_init(dest, "main", db, "main");
+    if (backup == nullptr) {
+        QString errorMsg = "Failed to start backup: " + QString::fromStdString(std::string(sqlite3_errmsg(dest)));
+        qCritical() << errorMsg;
+        sqlite3_exec(db, "COMMIT;", nullptr, nullptr, nullptr);
+        sqlite3_close(dest);
+        throw std::runtime_error(errorMsg.toStdString());
+    }
+
+    do {
+        rc = sqlite3_backup_step(backup, pagesPerStep);
+        if (progress) progress(sqlite3_backup_remaining(backup), sqlite3_backup_pagecount(backup));
+        if (rc == SQLITE_OK || rc == SQLITE_BUSY || rc == SQLITE_LOCKED) sqlite3_sleep(pauseMs);
+    } while (rc == SQLITE_OK || rc == SQLITE_BUSY || rc == SQLITE_LOCKED);
+
+    sqlite3_backup_finish(backup);
+    QString destError = QString::fromStdString(std::string(sqlite3_errmsg(dest)));
+    sqlite3_exec(db, "COMMIT;", nullptr, nullptr, nullptr);
+    sqlite3_close(dest);
+
+    if (rc != SQLITE_DONE) {
+        QString errorMsg = "Backup failed: " + destError;
+        qCritical() << errorMsg;
+        throw std::runtime_error(errorMsg.toStdString());
+    }
+}
+
 int DataBase::getWordId(const std::string& word, const std::string& language) {
+    DB_SCOPE("getWordId");
     std::string sql;
     if (language.empty()) {
         // If no language specified, find any word matching the text
@@ -722,7 +1474,8 @@ int DataBase::getWordId(const std::string& word, const std::string& language) {
 }
 
 int DataBase::getListId(const std::string& listName) {
-    const char* sql = "SELECT list_id FROM vocabulary_lists WHERE list_name = ? LIMIT 1;";
+    DB_SCOPE("getListId");
+    const char* sql = "SELECT list_id FROM vocabulary_lists WHERE list_name = ? AND is_deleted = 0 LIMIT 1;";
     sqlite3_stmt* stmt = nullptr;
     int rc = sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr);
     if (rc != SQLITE_OK) {
@@ -744,6 +1497,7 @@ int DataBase::getListId(const std::string& listName) {
 }
 
 int DataBase::addOrGetWord(const std::string& word, const std::string& partOfSpeech, const std::string& definition, const std::string& language) {
+    DB_SCOPE("addOrGetWord");
     int existing = getWordId(word, language);
     if (existing != -1) return existing;
 
@@ -775,6 +1529,7 @@ int DataBase::addOrGetWord(const std::string& word, const std::string& partOfSpe
 }
 
 bool DataBase::addWordToList(int listID, int wordID) {
+    DB_SCOPE("addWordToList");
     const char* sql = "INSERT OR IGNORE INTO list_words (list_id, word_id, added_date) VALUES (?, ?, datetime('now'));";
     sqlite3_stmt* stmt = nullptr;
     int rc = sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr);
@@ -803,7 +1558,17 @@ bool DataBase::addWordToList(int listID, int wordID) {
 }
 
 bool DataBase::initReviewSchedule(int wordID, int listID) {
-    const char* sql = "INSERT OR IGNORE INTO review_schedule (word_id, list_id, next_review_date, ease_factor, interval_days, repetition_count) VALUES (?, ?, datetime('now'), 2.5, 0, 0);";
+    DB_SCOPE("initReviewSchedule");
+    // A word keeps its schedule while it belongs to a live list. A row left behind by a deleted list
+    // that the purge has not reached yet is taken over with a fresh schedule, as if the synchronous
+    // delete had already removed it; the purge only deletes rows still pointing at its list.
+    const char* sql =
+        "INSERT INTO review_schedule (word_id, list_id, next_review_date, ease_factor, interval_days, repetition_count) "
+        "VALUES (?, ?, datetime('now'), 2.5, 0, 0) "
+        "ON CONFLICT(word_id) DO UPDATE SET list_id = excluded.list_id, next_review_date = excluded.next_review_date, "
+        "ease_factor = excluded.ease_factor, interval_days = excluded.interval_days, repetition_count = excluded.repetition_count, "
+        "fsrs_stability = NULL, fsrs_difficulty = NULL "
+        "WHERE review_schedule.list_id IN (SELECT list_id FROM vocabulary_lists WHERE is_deleted = 1);";
     sqlite3_stmt* stmt = nullptr;
     int rc = sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr);
     if (rc != SQLITE_OK) {
@@ -828,6 +1593,7 @@ bool DataBase::initReviewSchedule(int wordID, int listID) {
 }
 
 int DataBase::addWordAndSetup(int listID, const std::string& word, const std::string& partOfSpeech, const std::string& definition, const std::string& language) {
+    DB_SCOPE("addWordAndSetup");
     try {
         beginTransaction();
 
@@ -852,16 +1618,72 @@ int DataBase::addWordAndSetup(int listID, const std::string& word, const std::st
     }
 }
 
+int DataBase::addWordsAndSetup(int listID, const std::vector<NewWord>& words) {
+    DB_SCOPE("addWordsAndSetup");
+    if (words.empty()) return 0;
+
+    try {
+        beginTransaction();
+
+        int processed = 0;
+        for (const auto &w : words) {
+            int wordID = addOrGetWord(w.word, w.part_of_speech, w.definition, w.language);
+            if (wordID < 0) {
+                QString errorMsg = "Failed to obtain or create word id in addWordsAndSetup";
+                qCritical() << errorMsg;
+                throw std::runtime_error(errorMsg.toStdString());
+            }
+            addWordToList(listID, wordID);
+            initReviewSchedule(wordID, listID);
+            processed++;
+        }
+
+        commitTransaction();
+        return processed;
+    } catch (...) {
+        try { rollbackTransaction(); } catch (...) {}
+        throw;
+    }
+}
+
+namespace {
+// Columns: schedule_id, word_id, list_id, word, definition, ease_factor, interval_days,
+// repetition_count, next_review_date, fsrs_stability, fsrs_difficulty
+DataBase::DueCard readDueCard(sqlite3_stmt* stmt) {
+    DataBase::DueCard c;
+    c.schedule_id = sqlite3_column_int(stmt, 0);
+    c.word_id = sqlite3_column_int(stmt, 1);
+    c.list_id = sqlite3_column_int(stmt, 2);
+    const unsigned char* wtxt = sqlite3_column_text(stmt, 3);
+    c.word = wtxt ? reinterpret_cast<const char*>(wtxt) : std::string("");
+    const unsigned char* dtxt = sqlite3_column_text(stmt, 4);
+    c.definition = dtxt ? reinterpret_cast<const char*>(dtxt) : std::string("");
+    c.ease_factor = sqlite3_column_double(stmt, 5);
+    c.interval_days = sqlite3_column_int(stmt, 6);
+    c.repetition_count = sqlite3_column_int(stmt, 7);
+    const unsigned char* ndtxt = sqlite3_column_text(stmt, 8);
+    c.next_review_date = ndtxt ? reinterpret_cast<const char*>(ndtxt) : std::string("");
+    c.fsrs_stability = sqlite3_column_double(stmt, 9);
+    c.fsrs_difficulty = sqlite3_column_double(stmt, 10);
+    return c;
+}
+}
+
 std::vector<DataBase::DueCard> DataBase::getDueCards(int listID) {
+    DB_SCOPE("getDueCards");
     std::vector<DueCard> out;
     const char* sqlAll =
-        "SELECT rs.schedule_id, rs.word_id, rs.list_id, w.word, w.definition, rs.ease_factor, rs.interval_days, rs.repetition_count, rs.next_review_date "
+        "SELECT rs.schedule_id, rs.word_id, rs.list_id, w.word, w.definition, rs.ease_factor, rs.interval_days, rs.repetition_count, rs.next_review_date, "
+        "rs.fsrs_stability, rs.fsrs_difficulty "
         "FROM review_schedule rs JOIN words w ON rs.word_id = w.word_id "
         "WHERE rs.next_review_date <= datetime('now') "
+        // NOT EXISTS rather than NOT IN, which would drop every row with a NULL list_id
+        "AND NOT EXISTS (SELECT 1 FROM vocabulary_lists l WHERE l.list_id = rs.list_id AND l.is_deleted = 1) "
         "ORDER BY rs.next_review_date ASC;";
 
     const char* sqlList =
-        "SELECT rs.schedule_id, rs.word_id, rs.list_id, w.word, w.definition, rs.ease_factor, rs.interval_days, rs.repetition_count, rs.next_review_date "
+        "SELECT rs.schedule_id, rs.word_id, rs.list_id, w.word, w.definition, rs.ease_factor, rs.interval_days, rs.repetition_count, rs.next_review_date, "
+        "rs.fsrs_stability, rs.fsrs_difficulty "
         "FROM review_schedule rs JOIN words w ON rs.word_id = w.word_id "
         "WHERE rs.list_id = ? AND rs.next_review_date <= datetime('now') "
         "ORDER BY rs.next_review_date ASC;";
@@ -878,34 +1700,92 @@ std::vector<DataBase::DueCard> DataBase::getDueCards(int listID) {
     if (listID >= 0) sqlite3_bind_int(stmt, 1, listID);
 
     while ((rc = sqlite3_step(stmt)) == SQLITE_ROW) {
-        DueCard c;
-        c.schedule_id = sqlite3_column_int(stmt, 0);
-        c.word_id = sqlite3_column_int(stmt, 1);
-        c.list_id = sqlite3_column_int(stmt, 2);
-        const unsigned char* wtxt = sqlite3_column_text(stmt, 3);
-        c.word = wtxt ? reinterpret_cast<const char*>(wtxt) : std::string("");
-        const unsigned char* dtxt = sqlite3_column_text(stmt, 4);
-        c.definition = dtxt ? reinterpret_cast<const char*>(dtxt) : std::string("");
-        c.ease_factor = sqlite3_column_double(stmt, 5);
-        c.interval_days = sqlite3_column_int(stmt, 6);
-        c.repetition_count = sqlite3_column_int(stmt, 7);
-        const unsigned char* ndtxt = sqlite3_column_text(stmt, 8);
-        c.next_review_date = ndtxt ? reinterpret_cast<const char*>(ndtxt) : std::string("");
-        out.push_back(std::move(c));
+        out.push_back(readDueCard(stmt));
     }
 
     sqlite3_finalize(stmt);
     return out;
 }
 
-bool DataBase::updateReviewScheduleForWord(int wordID, int listID, int repetition_count, int interval_days, double ease_factor, const std::string& next_review_date) {
-    const char* sql = "UPDATE review_schedule SET repetition_count = ?, interval_days = ?, ease_factor = ?, next_review_date = ? WHERE word_id = ? AND list_id = ?;";
-    sqlite3_stmt* stmt = nullptr;
-    int rc = sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr);
-    if (rc != SQLITE_OK) {
-        QString errorMsg = "Failed to prepare statement for updateReviewScheduleForWord: " + QString::fromStdString(std::string(sqlite3_errmsg(db)));
-        qCritical() << errorMsg;
-        throw std::runtime_error(errorMsg.toStdString());
+std::vector<DataBase::DueCard> DataBase::getDueCardsByScheduleIds(const std::vector<int>& scheduleIDs) {
+    DB_SCOPE("getDueCardsByScheduleIds");
+    // Stays under SQLite's default limit on bound parameters
+    const size_t chunk = 500;
+    std::unordered_map<int, DueCard> found;
+    for (size_t first = 0; first < scheduleIDs.size(); first += chunk) {
+        size_t count = std::min(chunk, scheduleIDs.size() - first);
+        std::string sql =
+            "SELECT rs.schedule_id, rs.word_id, rs.list_id, w.word, w.definition, rs.ease_factor, rs.interval_days, rs.repetition_count, rs.next_review_date, "
+            "rs.fsrs_stability, rs.fsrs_difficulty "
+            "FROM review_schedule rs JOIN words w ON rs.word_id = w.word_id WHERE rs.schedule_id IN (";
+        for (size_t i = 0; i < count; ++i) sql += i ? ",?" : "?";
+        sql += ");";
+
+        sqlite3_stmt* stmt = prepareStatementOrThrow(sql.c_str(), "getDueCardsByScheduleIds");
+        for (size_t i = 0; i < count; ++i) sqlite3_bind_int(stmt, static_cast<int>(i + 1), scheduleIDs[first + i]);
+        while (sqlite3_step(stmt) == SQLITE_ROW) {
+            DueCard c = readDueCard(stmt);
+            found.emplace(c.schedule_id, std::move(c));
+        }
+        sqlite3_finalize(stmt);
+    }
+
+    std::vector<DueCard> out;
+    out.reserve(found.size());
+    for (int id : scheduleIDs) {
+        auto it = found.find(id);
+        if (it != found.end()) out.push_back(std::move(it->second));
+    }
+    return out;
+}
+
+void DataBase::forEachOverdueCard(const std::function<void(const OverdueCard&)>& visit) {
+    DB_SCOPE("forEachOverdueCard");
+    sqlite3_stmt* stmt = prepareStatementOrThrow(
+        "SELECT schedule_id, word_id, list_id, interval_days, ease_factor, "
+        "julianday('now') - julianday(next_review_date), COALESCE(fsrs_stability, 0) "
+        "FROM review_schedule rs WHERE repetition_count > 0 AND next_review_date <= datetime('now') "
+        "AND NOT EXISTS (SELECT 1 FROM vocabulary_lists l WHERE l.list_id = rs.list_id AND l.is_deleted = 1);", "forEachOverdueCard");
+    int rc;
+    while ((rc = sqlite3_step(stmt)) == SQLITE_ROW) {
+        OverdueCard c;
+        c.schedule_id = sqlite3_column_int(stmt, 0);
+        c.word_id = sqlite3_column_int(stmt, 1);
+        c.list_id = sqlite3_column_int(stmt, 2);
+        c.interval_days = sqlite3_column_int(stmt, 3);
+        c.ease_factor = sqlite3_column_double(stmt, 4);
+        c.days_overdue = sqlite3_column_double(stmt, 5);
+        c.fsrs_stability = sqlite3_column_double(stmt, 6);
+        visit(c);
+    }
+    sqlite3_finalize(stmt);
+    if (rc != SQLITE_DONE) {
+        QString errorMsg = "Execution failed for forEachOverdueCard: " + QString::fromStdString(std::string(sqlite3_errmsg(db)));
+        qCritical() << errorMsg;
+        throw std::runtime_error(errorMsg.toStdString());
+    }
+}
+
+int DataBase::countReviewsToday() {
+    DB_SCOPE("countReviewsToday");
+    // review_date is stored in UTC, so compare against the UTC instant of local midnight
+    return static_cast<int>(pragmaInt("SELECT COUNT(*) FROM study_sessions WHERE scheduled = 1 "
+                                      "AND review_date >= datetime('now', 'localtime', 'start of day', 'utc');", "countReviewsToday"));
+}
+
+bool DataBase::updateReviewScheduleForWord(int wordID, int listID, int repetition_count, int interval_days, double ease_factor, const std::string& next_review_date,
+                                           double fsrs_stability, double fsrs_difficulty) {
+    DB_SCOPE("updateReviewScheduleForWord");
+    const char* sql =
+        "UPDATE review_schedule SET repetition_count = ?1, interval_days = ?2, ease_factor = ?3, next_review_date = ?4, "
+        "fsrs_stability = COALESCE(?7, fsrs_stability), fsrs_difficulty = COALESCE(?8, fsrs_difficulty) "
+        "WHERE word_id = ?5 AND list_id = ?6;";
+    sqlite3_stmt* stmt = nullptr;
+    int rc = sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr);
+    if (rc != SQLITE_OK) {
+        QString errorMsg = "Failed to prepare statement for updateReviewScheduleForWord: " + QString::fromStdString(std::string(sqlite3_errmsg(db)));
+        qCritical() << errorMsg;
+        throw std::runtime_error(errorMsg.toStdString());
     }
 
     sqlite3_bind_int(stmt, 1, repetition_count);
@@ -918,6 +1798,10 @@ bool DataBase::updateReviewScheduleForWord(int wordID, int listID, int repetitio
     sqlite3_bind_text(stmt, 4, next_review_date.c_str(), -1, SQLITE_TRANSIENT);
     sqlite3_bind_int(stmt, 5, wordID);
     sqlite3_bind_int(stmt, 6, listID);
+    if (fsrs_stability > 0.0) {
+        sqlite3_bind_double(stmt, 7, fsrs_stability);
+        sqlite3_bind_double(stmt, 8, fsrs_difficulty);
+    }
 
     rc = sqlite3_step(stmt);
     if (rc != SQLITE_DONE) {
@@ -931,8 +1815,9 @@ bool DataBase::updateReviewScheduleForWord(int wordID, int listID, int repetitio
     return true;
 }
 
-bool DataBase::recordStudySession(int wordID, int listID, bool was_correct, int quality, const std::string& study_mode) {
-    const char* sql = "INSERT INTO study_sessions (word_id, review_date, was_correct, confidence_score, study_mode, list_id) VALUES (?, datetime('now'), ?, ?, ?, ?);"; 
+bool DataBase::recordStudySession(int wordID, int listID, bool was_correct, int quality, const std::string& study_mode, bool scheduled) {
+    DB_SCOPE("recordStudySession");
+    const char* sql = "INSERT INTO study_sessions (word_id, review_date, was_correct, confidence_score, study_mode, list_id, scheduled) VALUES (?, datetime('now'), ?, ?, ?, ?, ?);"; 
     sqlite3_stmt* stmt = nullptr;
     int rc = sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr);
     if (rc != SQLITE_OK) {
@@ -950,6 +1835,7 @@ bool DataBase::recordStudySession(int wordID, int listID, bool was_correct, int
     sqlite3_bind_int(stmt, 3, confScore);
     sqlite3_bind_text(stmt, 4, study_mode.c_str(), -1, SQLITE_TRANSIENT);
     sqlite3_bind_int(stmt, 5, listID);
+    sqlite3_bind_int(stmt, 6, scheduled ? 1 : 0);
 
     rc = sqlite3_step(stmt);
     if (rc != SQLITE_DONE) {
@@ -969,15 +1855,21 @@ bool DataBase::recordStudySession(int wordID, int listID, bool was_correct, int
 }
 
 std::vector<std::pair<int, std::string>> DataBase::getRandomWordsInList(int listID, int excludeWordID, int count) {
+    DB_SCOPE("getRandomWordsInList");
     std::vector<std::pair<int, std::string>> out;
     const char* sql_with_exclude =
         "SELECT w.word_id, w.definition FROM list_words lw JOIN words w ON lw.word_id = w.word_id WHERE lw.list_id = ? AND w.word_id != ? ORDER BY RANDOM() LIMIT ?;";
     const char* sql_no_exclude =
         "SELECT w.word_id, w.definition FROM list_words lw JOIN words w ON lw.word_id = w.word_id WHERE lw.list_id = ? ORDER BY RANDOM() LIMIT ?;";
+    // Global picks only come from visible lists; a deleted list's words stay until its purge
     const char* sql_global_with_exclude =
-        "SELECT w.word_id, w.definition FROM words w WHERE w.word_id != ? ORDER BY RANDOM() LIMIT ?;";
+        "SELECT w.word_id, w.definition FROM words w WHERE w.word_id != ? AND EXISTS "
+        "(SELECT 1 FROM list_words lw JOIN vocabulary_lists l ON l.list_id = lw.list_id WHERE lw.word_id = w.word_id AND l.is_deleted = 0) "
+        "ORDER BY RANDOM() LIMIT ?;";
     const char* sql_global_no_exclude =
-        "SELECT w.word_id, w.definition FROM words w ORDER BY RANDOM() LIMIT ?;";
+        "SELECT w.word_id, w.definition FROM words w WHERE EXISTS "
+        "(SELECT 1 FROM list_words lw JOIN vocabulary_lists l ON l.list_id = lw.list_id WHERE lw.word_id = w.word_id AND l.is_deleted = 0) "
+        "ORDER BY RANDOM() LIMIT ?;";
 
     sqlite3_stmt* stmt = nullptr;
     int rc;
@@ -1035,71 +1927,1008 @@ std::vector<std::pair<int, std::string>> DataBase::getRandomWordsInList(int list
     return out;
 }
 
-std::vector<std::tuple<int, std::string, std::string>> DataBase::getWordsInList(int listID) {
-    std::vector<std::tuple<int, std::string, std::string>> out;
-    const char* sql_in_list =
-        "SELECT w.word_id, w.word, w.definition FROM list_words lw JOIN words w ON lw.word_id = w.word_id WHERE lw.list_id = ? ORDER BY lw.added_date ASC;";
-    const char* sql_all =
-        "SELECT w.word_id, w.word, w.definition FROM words w ORDER BY w.word ASC;";
+DataBase::ListWordsStamp DataBase::getListWordsStamp(int listID) {
+    DB_SCOPE("getListWordsStamp");
+    // Both aggregates are answered from the UNIQUE(list_id, word_id) index, which carries the row id
+    sqlite3_stmt* stmt = prepareStatementOrThrow(
+        "SELECT COUNT(*), COALESCE(MAX(list_word_id), 0) FROM list_words WHERE list_id = ?;", "getListWordsStamp");
+    sqlite3_bind_int(stmt, 1, listID);
 
-    sqlite3_stmt* stmt = nullptr;
-    int rc;
-    if (listID >= 0) {
-        rc = sqlite3_prepare_v2(db, sql_in_list, -1, &stmt, nullptr);
-        if (rc != SQLITE_OK) {
-            QString errorMsg = "Failed to prepare statement for getWordsInList (in list): " + QString::fromStdString(std::string(sqlite3_errmsg(db)));
+    ListWordsStamp stamp;
+    if (sqlite3_step(stmt) == SQLITE_ROW) {
+        stamp.wordCount = sqlite3_column_int64(stmt, 0);
+        stamp.maxListWordID = sqlite3_column_int64(stmt, 1);
+    }
+    sqlite3_finalize(stmt);
+    return stamp;
+}
+
+bool DataBase::getDistractorStamp(int listID, ListWordsStamp& stamp) {
+    DB_SCOPE("getDistractorStamp");
+    sqlite3_stmt* stmt = prepareStatementOrThrow(
+        "SELECT word_count, max_list_word_id FROM distractor_sources WHERE list_id = ?;", "getDistractorStamp");
+    sqlite3_bind_int(stmt, 1, listID);
+
+    bool found = false;
+    if (sqlite3_step(stmt) == SQLITE_ROW) {
+        stamp.wordCount = sqlite3_column_int64(stmt, 0);
+        stamp.maxListWordID = sqlite3_column_int64(stmt, 1);
+        found = true;
+    }
+    sqlite3_finalize(stmt);
+    return found;
+}
+
+std::unordered_map<int, std::vector<int>> DataBase::getStoredDistractorIds(int listID) {
+    DB_SCOPE("getStoredDistractorIds");
+    sqlite3_stmt* stmt = prepareStatementOrThrow(
+        "SELECT word_id, distractor_word_id FROM word_distractors WHERE list_id = ? ORDER BY word_id, rank;",
+        "getStoredDistractorIds");
+    sqlite3_bind_int(stmt, 1, listID);
+
+    std::unordered_map<int, std::vector<int>> out;
+    while (sqlite3_step(stmt) == SQLITE_ROW) {
+        out[sqlite3_column_int(stmt, 0)].push_back(sqlite3_column_int(stmt, 1));
+    }
+    sqlite3_finalize(stmt);
+    return out;
+}
+
+bool DataBase::replaceDistractors(int listID, const std::vector<DistractorEntry>& entries, const ListWordsStamp& stamp) {
+    DB_SCOPE("replaceDistractors");
+
+    sqlite3_stmt* delStmt = prepareStatementOrThrow("DELETE FROM word_distractors WHERE list_id = ? AND word_id = ?;", "replaceDistractors (delete)");
+    sqlite3_stmt* insStmt = nullptr;
+    try {
+        insStmt = prepareStatementOrThrow(
+            "INSERT INTO word_distractors (list_id, word_id, rank, distractor_word_id, score) VALUES (?, ?, ?, ?, ?);",
+            "replaceDistractors (insert)");
+    } catch (...) {
+        sqlite3_finalize(delStmt);
+        throw;
+    }
+
+    auto stepOrThrow = [this](sqlite3_stmt* stmt) {
+        int rc = sqlite3_step(stmt);
+        sqlite3_reset(stmt);
+        if (rc != SQLITE_DONE) {
+            QString errorMsg = "Execution failed for replaceDistractors: " + QString::fromStdString(std::string(sqlite3_errmsg(db)));
             qCritical() << errorMsg;
             throw std::runtime_error(errorMsg.toStdString());
         }
-        sqlite3_bind_int(stmt, 1, listID);
-    } else {
-        rc = sqlite3_prepare_v2(db, sql_all, -1, &stmt, nullptr);
-        if (rc != SQLITE_OK) {
-            QString errorMsg = "Failed to prepare statement for getWordsInList (all): " + QString::fromStdString(std::string(sqlite3_errmsg(db)));
-            qCritical() << errorMsg;
-            throw std::runtime_error(errorMsg.toStdString());
+    };
+
+    try {
+        beginTransaction();
+
+        for (const auto &entry : entries) {
+            sqlite3_bind_int(delStmt, 1, listID);
+            sqlite3_bind_int(delStmt, 2, entry.word_id);
+            stepOrThrow(delStmt);
+
+            int rank = 0;
+            for (const auto &d : entry.distractors) {
+                sqlite3_bind_int(insStmt, 1, listID);
+                sqlite3_bind_int(insStmt, 2, entry.word_id);
+                sqlite3_bind_int(insStmt, 3, rank++);
+                sqlite3_bind_int(insStmt, 4, d.first);
+                sqlite3_bind_double(insStmt, 5, d.second);
+                stepOrThrow(insStmt);
+            }
         }
+
+        sqlite3_stmt* stampStmt = prepareStatementOrThrow(
+            "INSERT INTO distractor_sources (list_id, word_count, max_list_word_id) VALUES (?, ?, ?) "
+            "ON CONFLICT(list_id) DO UPDATE SET word_count = excluded.word_count, max_list_word_id = excluded.max_list_word_id;",
+            "replaceDistractors (stamp)");
+        sqlite3_bind_int(stampStmt, 1, listID);
+        sqlite3_bind_int64(stampStmt, 2, stamp.wordCount);
+        sqlite3_bind_int64(stampStmt, 3, stamp.maxListWordID);
+        executeStatementOrThrow(stampStmt, "replaceDistractors (stamp)");
+        sqlite3_finalize(stampStmt);
+
+        commitTransaction();
+    } catch (...) {
+        sqlite3_finalize(delStmt);
+        sqlite3_finalize(insStmt);
+        try { rollbackTransaction(); } catch (...) {}
+        throw;
     }
 
-    while ((rc = sqlite3_step(stmt)) == SQLITE_ROW) {
+    sqlite3_finalize(delStmt);
+    sqlite3_finalize(insStmt);
+    return true;
+}
+
+std::vector<std::pair<int, std::string>> DataBase::getDistractors(int listID, int wordID, int count) {
+    DB_SCOPE("getDistractors");
+    std::vector<std::pair<int, std::string>> out;
+    const char* sql =
+        "SELECT w.word_id, w.definition FROM word_distractors wd JOIN words w ON wd.distractor_word_id = w.word_id "
+        "WHERE wd.list_id = ? AND wd.word_id = ? ORDER BY wd.rank ASC LIMIT ?;";
+
+    sqlite3_stmt* stmt = prepareStatementOrThrow(sql, "getDistractors");
+    sqlite3_bind_int(stmt, 1, listID);
+    sqlite3_bind_int(stmt, 2, wordID);
+    sqlite3_bind_int(stmt, 3, count);
+
+    while (sqlite3_step(stmt) == SQLITE_ROW) {
         int wid = sqlite3_column_int(stmt, 0);
+        const unsigned char* dtxt = sqlite3_column_text(stmt, 1);
+        out.emplace_back(wid, dtxt ? reinterpret_cast<const char*>(dtxt) : std::string(""));
+    }
+
+    sqlite3_finalize(stmt);
+    return out;
+}
+
+bool DataBase::getCachedAIResponse(const std::string& cacheKey, long long maxAgeSeconds, std::string& entriesJson) {
+    DB_SCOPE("getCachedAIResponse");
+    sqlite3_stmt* stmt = prepareStatementOrThrow(
+        "SELECT entries_json, CAST(strftime('%s','now') AS INTEGER) - created_at FROM ai_response_cache WHERE cache_key = ?;",
+        "getCachedAIResponse");
+    sqlite3_bind_text(stmt, 1, cacheKey.c_str(), -1, SQLITE_TRANSIENT);
+
+    bool found = false;
+    bool expired = false;
+    if (sqlite3_step(stmt) == SQLITE_ROW) {
+        long long age = sqlite3_column_int64(stmt, 1);
+        if (age > maxAgeSeconds) {
+            expired = true;
+        } else {
+            const unsigned char* txt = sqlite3_column_text(stmt, 0);
+            entriesJson = txt ? reinterpret_cast<const char*>(txt) : std::string("");
+            found = true;
+        }
+    }
+    sqlite3_finalize(stmt);
+
+    // Expired entries are dropped; hits refresh their LRU position
+    const char* followUpSql = expired
+        ? "DELETE FROM ai_response_cache WHERE cache_key = ?;"
+        : "UPDATE ai_response_cache SET last_access = CAST(strftime('%s','now') AS INTEGER) WHERE cache_key = ?;";
+    if (found || expired) {
+        stmt = prepareStatementOrThrow(followUpSql, "getCachedAIResponse (touch)");
+        sqlite3_bind_text(stmt, 1, cacheKey.c_str(), -1, SQLITE_TRANSIENT);
+        executeStatementOrThrow(stmt, "getCachedAIResponse (touch)");
+        sqlite3_finalize(stmt);
+    }
+
+    return found;
+}
+
+bool DataBase::putCachedAIResponse(const std::string& cacheKey, const std::string& entriesJson, long long maxTotalBytes) {
+    DB_SCOPE("putCachedAIResponse");
+    const char* sql =
+        "INSERT OR REPLACE INTO ai_response_cache (cache_key, entries_json, size_bytes, created_at, last_access) "
+        "VALUES (?, ?, ?, CAST(strftime('%s','now') AS INTEGER), CAST(strftime('%s','now') AS INTEGER));";
+    sqlite3_stmt* stmt = prepareStatementOrThrow(sql, "putCachedAIResponse");
+    sqlite3_bind_text(stmt, 1, cacheKey.c_str(), -1, SQLITE_TRANSIENT);
+    sqlite3_bind_text(stmt, 2, entriesJson.c_str(), -1, SQLITE_TRANSIENT);
+    sqlite3_bind_int64(stmt, 3, static_cast<sqlite3_int64>(cacheKey.size() + entriesJson.size()));
+    executeStatementOrThrow(stmt, "putCachedAIResponse");
+    sqlite3_finalize(stmt);
+
+    // Keep the most recently used entries whose running size fits the budget, drop the rest
+    const char* evictSql =
+        "DELETE FROM ai_response_cache WHERE cache_key IN ("
+        "  SELECT cache_key FROM ("
+        "    SELECT cache_key, SUM(size_bytes) OVER (ORDER BY last_access DESC, created_at DESC, cache_key) AS running "
+        "    FROM ai_response_cache"
+        "  ) WHERE running > ?"
+        ");";
+    stmt = prepareStatementOrThrow(evictSql, "putCachedAIResponse (evict)");
+    sqlite3_bind_int64(stmt, 1, static_cast<sqlite3_int64>(maxTotalBytes));
+    executeStatementOrThrow(stmt, "putCachedAIResponse (evict)");
+    sqlite3_finalize(stmt);
+
+    return true;
+}
+
+std::vector<std::tuple<int, std::string, std::string>> DataBase::getWordsInList(int listID) {
+    DB_SCOPE("getWordsInList");
+    return cachedRead<std::vector<std::tuple<int, std::string, std::string>>>("getWordsInList|" + std::to_string(listID), ListWordsTable | WordsTable | ListsTable, [this, listID]() {
+        std::vector<std::tuple<int, std::string, std::string>> out;
+        const char* sql_in_list =
+            "SELECT w.word_id, w.word, w.definition FROM list_words lw JOIN words w ON lw.word_id = w.word_id WHERE lw.list_id = ? ORDER BY lw.added_date ASC;";
+        // Every word of a visible list; a deleted list's words stay until its purge
+        const char* sql_all =
+            "SELECT w.word_id, w.word, w.definition FROM words w WHERE EXISTS "
+            "(SELECT 1 FROM list_words lw JOIN vocabulary_lists l ON l.list_id = lw.list_id WHERE lw.word_id = w.word_id AND l.is_deleted = 0) "
+            "ORDER BY w.word ASC;";
+
+        sqlite3_stmt* stmt = nullptr;
+        int rc;
+        if (listID >= 0) {
+            rc = sqlite3_prepare_v2(db, sql_in_list, -1, &stmt, nullptr);
+            if (rc != SQLITE_OK) {
+                QString errorMsg = "Failed to prepare statement for getWordsInList (in list): " + QString::fromStdString(std::string(sqlite3_errmsg(db)));
+                qCritical() << errorMsg;
+                throw std::runtime_error(errorMsg.toStdString());
+            }
+            sqlite3_bind_int(stmt, 1, listID);
+        } else {
+            rc = sqlite3_prepare_v2(db, sql_all, -1, &stmt, nullptr);
+            if (rc != SQLITE_OK) {
+                QString errorMsg = "Failed to prepare statement for getWordsInList (all): " + QString::fromStdString(std::string(sqlite3_errmsg(db)));
+                qCritical() << errorMsg;
+                throw std::runtime_error(errorMsg.toStdString());
+            }
+        }
+
+        while ((rc = sqlite3_step(stmt)) == SQLITE_ROW) {
+            int wid = sqlite3_column_int(stmt, 0);
+            const unsigned char* wtxt = sqlite3_column_text(stmt, 1);
+            const unsigned char* dtxt = sqlite3_column_text(stmt, 2);
+            std::string word = wtxt ? reinterpret_cast<const char*>(wtxt) : std::string("");
+            std::string def = dtxt ? reinterpret_cast<const char*>(dtxt) : std::string("");
+            out.emplace_back(wid, word, def);
+        }
+
+        sqlite3_finalize(stmt);
+        return out;
+    });
+}
+
+std::vector<DataBase::EnrichmentCandidate> DataBase::getWordsMissingEnrichment(int afterWordID, int limit) {
+    DB_SCOPE("getWordsMissingEnrichment");
+    const char* sql =
+        "SELECT word_id, word, definition, needs_examples, needs_relations FROM ("
+        "  SELECT w.word_id, w.word, w.definition, "
+        "  NOT EXISTS (SELECT 1 FROM word_examples e WHERE e.word_id = w.word_id) AS needs_examples, "
+        "  NOT EXISTS (SELECT 1 FROM word_relations r WHERE r.word1_id = w.word_id) AS needs_relations "
+        "  FROM words w WHERE w.word_id > ? ORDER BY w.word_id ASC"
+        ") WHERE needs_examples OR needs_relations LIMIT ?;";
+
+    sqlite3_stmt* stmt = prepareStatementOrThrow(sql, "getWordsMissingEnrichment");
+    sqlite3_bind_int(stmt, 1, afterWordID);
+    sqlite3_bind_int(stmt, 2, limit);
+
+    std::vector<EnrichmentCandidate> out;
+    while (sqlite3_step(stmt) == SQLITE_ROW) {
+        EnrichmentCandidate c;
+        c.word_id = sqlite3_column_int(stmt, 0);
         const unsigned char* wtxt = sqlite3_column_text(stmt, 1);
+        c.word = wtxt ? reinterpret_cast<const char*>(wtxt) : std::string("");
         const unsigned char* dtxt = sqlite3_column_text(stmt, 2);
-        std::string word = wtxt ? reinterpret_cast<const char*>(wtxt) : std::string("");
-        std::string def = dtxt ? reinterpret_cast<const char*>(dtxt) : std::string("");
-        out.emplace_back(wid, word, def);
+        c.definition = dtxt ? reinterpret_cast<const char*>(dtxt) : std::string("");
+        c.needs_examples = sqlite3_column_int(stmt, 3) != 0;
+        c.needs_relations = sqlite3_column_int(stmt, 4) != 0;
+        out.push_back(std::move(c));
     }
 
     sqlite3_finalize(stmt);
     return out;
 }
 
-// Helper method for card count queries
-int DataBase::getCardCount(int listID, const std::string& whereClause, const std::string& context) {
-    std::string sql = "SELECT COUNT(*) FROM review_schedule WHERE list_id = ? AND " + whereClause + ";";
-    sqlite3_stmt* stmt = prepareStatementOrThrow(sql.c_str(), context);
+int DataBase::countWordsMissingEnrichment(int afterWordID) {
+    DB_SCOPE("countWordsMissingEnrichment");
+    const char* sql =
+        "SELECT COUNT(*) FROM words w WHERE w.word_id > ? AND ("
+        "NOT EXISTS (SELECT 1 FROM word_examples e WHERE e.word_id = w.word_id) OR "
+        "NOT EXISTS (SELECT 1 FROM word_relations r WHERE r.word1_id = w.word_id));";
+
+    sqlite3_stmt* stmt = prepareStatementOrThrow(sql, "countWordsMissingEnrichment");
+    sqlite3_bind_int(stmt, 1, afterWordID);
+
+    int count = 0;
+    if (sqlite3_step(stmt) == SQLITE_ROW) {
+        count = sqlite3_column_int(stmt, 0);
+    }
+
+    sqlite3_finalize(stmt);
+    return count;
+}
+
+int DataBase::addEnrichmentBatch(const std::vector<EnrichmentResult>& results) {
+    DB_SCOPE("addEnrichmentBatch");
+    static const char* const validTypes[] = {"synonym", "antonym", "related", "derived_from"};
+
+    int written = 0;
+    try {
+        beginTransaction();
+
+        for (const auto &r : results) {
+            for (const auto &ex : r.examples) {
+                if (ex.first.empty()) continue;
+                createNewExample(r.word_id, ex.first, ex.second);
+                written++;
+            }
+
+            std::vector<std::pair<int, std::string>> seen;
+            for (const auto &rel : r.relations) {
+                bool validType = std::any_of(std::begin(validTypes), std::end(validTypes),
+                                             [&rel](const char* t) { return rel.second == t; });
+                if (!validType) continue;
+
+                int relatedID = getWordId(rel.first, "");
+                if (relatedID < 0 || relatedID == r.word_id) continue;
+
+                std::pair<int, std::string> key(relatedID, rel.second);
+                if (std::find(seen.begin(), seen.end(), key) != seen.end()) continue;
+                seen.push_back(key);
+
+                createNewRelation(r.word_id, relatedID, rel.second);
+                written++;
+            }
+        }
+
+        commitTransaction();
+    } catch (...) {
+        try { rollbackTransaction(); } catch (...) {}
+        throw;
+    }
+
+    return written;
+}
+
+bool DataBase::getEnrichmentCheckpoint(const std::string& jobName, int& lastWordID, long long& processed) {
+    DB_SCOPE("getEnrichmentCheckpoint");
+    sqlite3_stmt* stmt = prepareStatementOrThrow(
+        "SELECT last_word_id, processed_count FROM enrichment_progress WHERE job_name = ?;", "getEnrichmentCheckpoint");
+    sqlite3_bind_text(stmt, 1, jobName.c_str(), -1, SQLITE_TRANSIENT);
+
+    bool found = false;
+    if (sqlite3_step(stmt) == SQLITE_ROW) {
+        lastWordID = sqlite3_column_int(stmt, 0);
+        processed = sqlite3_column_int64(stmt, 1);
+        found = true;
+    }
+
+    sqlite3_finalize(stmt);
+    return found;
+}
+
+bool DataBase::saveEnrichmentCheckpoint(const std::string& jobName, int lastWordID, long long processed) {
+    DB_SCOPE("saveEnrichmentCheckpoint");
+    const char* sql =
+        "INSERT INTO enrichment_progress (job_name, last_word_id, processed_count, updated_at) VALUES (?, ?, ?, datetime('now')) "
+        "ON CONFLICT(job_name) DO UPDATE SET last_word_id = excluded.last_word_id, "
+        "processed_count = excluded.processed_count, updated_at = excluded.updated_at;";
+
+    sqlite3_stmt* stmt = prepareStatementOrThrow(sql, "saveEnrichmentCheckpoint");
+    sqlite3_bind_text(stmt, 1, jobName.c_str(), -1, SQLITE_TRANSIENT);
+    sqlite3_bind_int(stmt, 2, lastWordID);
+    sqlite3_bind_int64(stmt, 3, static_cast<sqlite3_int64>(processed));
+    executeStatementOrThrow(stmt, "saveEnrichmentCheckpoint");
+    sqlite3_finalize(stmt);
+    return true;
+}
+
+std::vector<int> DataBase::getDueLoad(long long firstDay, int days) {
+    DB_SCOPE("getDueLoad");
+    std::vector<int> load(static_cast<size_t>(std::max(0, days)), 0);
+    if (load.empty()) return load;
+
+    sqlite3_stmt* stmt = prepareStatementOrThrow(
+        "SELECT due_day, card_count FROM due_histogram WHERE due_day >= ? AND due_day < ?;", "getDueLoad");
+    sqlite3_bind_int64(stmt, 1, static_cast<sqlite3_int64>(firstDay));
+    sqlite3_bind_int64(stmt, 2, static_cast<sqlite3_int64>(firstDay + days));
+    while (sqlite3_step(stmt) == SQLITE_ROW) {
+        load[static_cast<size_t>(sqlite3_column_int64(stmt, 0) - firstDay)] = sqlite3_column_int(stmt, 1);
+    }
+    sqlite3_finalize(stmt);
+    return load;
+}
+
+std::string DataBase::getListScheduler(int listID) {
+    DB_SCOPE("getListScheduler");
+    sqlite3_stmt* stmt = prepareStatementOrThrow("SELECT scheduler FROM vocabulary_lists WHERE list_id = ?;", "getListScheduler");
     sqlite3_bind_int(stmt, 1, listID);
-    
+    std::string scheduler = "sm2";
+    if (sqlite3_step(stmt) == SQLITE_ROW && sqlite3_column_type(stmt, 0) != SQLITE_NULL) {
+        scheduler = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0));
+    }
+    sqlite3_finalize(stmt);
+    return scheduler;
+}
+
+bool DataBase::setListScheduler(int listID, const std::string& scheduler) {
+    DB_SCOPE("setListScheduler");
+    sqlite3_stmt* stmt = prepareStatementOrThrow("UPDATE vocabulary_lists SET scheduler = ? WHERE list_id = ?;", "setListScheduler");
+    sqlite3_bind_text(stmt, 1, scheduler.c_str(), -1, SQLITE_TRANSIENT);
+    sqlite3_bind_int(stmt, 2, listID);
+    executeStatementOrThrow(stmt, "setListScheduler");
+    sqlite3_finalize(stmt);
+    return sqlite3_changes(db) > 0;
+}
+
+bool DataBase::getListSm2Steps(int listID, int& firstIntervalDays, int& secondIntervalDays) {
+    DB_SCOPE("getListSm2Steps");
+    sqlite3_stmt* stmt = prepareStatementOrThrow(
+        "SELECT sm2_first_interval, sm2_second_interval FROM vocabulary_lists WHERE list_id = ?;", "getListSm2Steps");
+    sqlite3_bind_int(stmt, 1, listID);
+    bool found = false;
+    if (sqlite3_step(stmt) == SQLITE_ROW) {
+        firstIntervalDays = sqlite3_column_int(stmt, 0);
+        secondIntervalDays = sqlite3_column_int(stmt, 1);
+        found = true;
+    }
+    sqlite3_finalize(stmt);
+    return found;
+}
+
+bool DataBase::setListSm2Steps(int listID, int firstIntervalDays, int secondIntervalDays) {
+    DB_SCOPE("setListSm2Steps");
+    sqlite3_stmt* stmt = prepareStatementOrThrow(
+        "UPDATE vocabulary_lists SET sm2_first_interval = ?, sm2_second_interval = ? WHERE list_id = ?;", "setListSm2Steps");
+    sqlite3_bind_int(stmt, 1, firstIntervalDays);
+    sqlite3_bind_int(stmt, 2, secondIntervalDays);
+    sqlite3_bind_int(stmt, 3, listID);
+    executeStatementOrThrow(stmt, "setListSm2Steps");
+    sqlite3_finalize(stmt);
+    return sqlite3_changes(db) > 0;
+}
+
+bool DataBase::getSchedulerParams(const std::string& scheduler, SchedulerParams& out) {
+    DB_SCOPE("getSchedulerParams");
+    sqlite3_stmt* stmt = prepareStatementOrThrow(
+        "SELECT params, review_count, COALESCE(log_loss, 0), "
+        "COALESCE(CAST(strftime('%s', 'now') AS INTEGER) - CAST(strftime('%s', fitted_at) AS INTEGER), 0) "
+        "FROM scheduler_params WHERE scheduler = ?;", "getSchedulerParams");
+    sqlite3_bind_text(stmt, 1, scheduler.c_str(), -1, SQLITE_TRANSIENT);
+
+    bool found = false;
+    if (sqlite3_step(stmt) == SQLITE_ROW) {
+        const unsigned char* text = sqlite3_column_text(stmt, 0);
+        out.params = text ? reinterpret_cast<const char*>(text) : std::string("");
+        out.reviewCount = sqlite3_column_int64(stmt, 1);
+        out.logLoss = sqlite3_column_double(stmt, 2);
+        out.secondsSinceFit = sqlite3_column_int64(stmt, 3);
+        found = true;
+    }
+
+    sqlite3_finalize(stmt);
+    return found;
+}
+
+void DataBase::saveSchedulerParams(const std::string& scheduler, const std::string& params, long long reviewCount, double logLoss) {
+    DB_SCOPE("saveSchedulerParams");
+    sqlite3_stmt* stmt = prepareStatementOrThrow(
+        "INSERT INTO scheduler_params (scheduler, params, review_count, log_loss, fitted_at) VALUES (?, ?, ?, ?, datetime('now')) "
+        "ON CONFLICT(scheduler) DO UPDATE SET params = excluded.params, review_count = excluded.review_count, "
+        "log_loss = excluded.log_loss, fitted_at = excluded.fitted_at;",
+        "saveSchedulerParams");
+    sqlite3_bind_text(stmt, 1, scheduler.c_str(), -1, SQLITE_TRANSIENT);
+    sqlite3_bind_text(stmt, 2, params.c_str(), -1, SQLITE_TRANSIENT);
+    sqlite3_bind_int64(stmt, 3, static_cast<sqlite3_int64>(reviewCount));
+    sqlite3_bind_double(stmt, 4, logLoss);
+    executeStatementOrThrow(stmt, "saveSchedulerParams");
+    sqlite3_finalize(stmt);
+}
+
+long long DataBase::countReviewLogs() {
+    DB_SCOPE("countReviewLogs");
+    return pragmaInt("SELECT COUNT(*) FROM study_sessions WHERE confidence_score IS NOT NULL AND scheduled = 1;", "countReviewLogs");
+}
+
+// Reviews are grouped by word rather than by (word, list): older study_sessions rows have no list_id,
+// and the same word studied in two decks is still one memory
+void DataBase::forEachReviewLog(const std::function<void(int wordID, long long reviewedAt, int confidence)>& visit) {
+    DB_SCOPE("forEachReviewLog");
+    sqlite3_stmt* stmt = prepareStatementOrThrow(
+        "SELECT word_id, CAST(strftime('%s', review_date) AS INTEGER), confidence_score FROM study_sessions "
+        "WHERE confidence_score IS NOT NULL AND scheduled = 1 ORDER BY word_id, review_date, session_id;", "forEachReviewLog");
+    int rc;
+    while ((rc = sqlite3_step(stmt)) == SQLITE_ROW) {
+        visit(sqlite3_column_int(stmt, 0), sqlite3_column_int64(stmt, 1), sqlite3_column_int(stmt, 2));
+    }
+    sqlite3_finalize(stmt);
+    if (rc != SQLITE_DONE) {
+        QString errorMsg = "Execution failed for forEachReviewLog: " + QString::fromStdString(std::string(sqlite3_errmsg(db)));
+        qCritical() << errorMsg;
+        throw std::runtime_error(errorMsg.toStdString());
+    }
+}
+
+int DataBase::updateMemoryStates(const std::vector<MemoryStateUpdate>& states) {
+    DB_SCOPE("updateMemoryStates");
+    int updated = 0;
+    try {
+        beginTransaction();
+        sqlite3_stmt* stmt = prepareStatementOrThrow(
+            "UPDATE review_schedule SET fsrs_stability = ?, fsrs_difficulty = ? WHERE word_id = ?;", "updateMemoryStates");
+        for (const auto &s : states) {
+            sqlite3_bind_double(stmt, 1, s.stability);
+            sqlite3_bind_double(stmt, 2, s.difficulty);
+            sqlite3_bind_int(stmt, 3, s.word_id);
+            executeStatementOrThrow(stmt, "updateMemoryStates");
+            updated += sqlite3_changes(db);
+            sqlite3_reset(stmt);
+        }
+        sqlite3_finalize(stmt);
+        commitTransaction();
+    } catch (...) {
+        // executeStatementOrThrow has already finalized the statement when it throws
+        try { rollbackTransaction(); } catch (...) {}
+        throw;
+    }
+    return updated;
+}
+
+namespace {
+const char* const kOrphanWordCondition =
+    "NOT EXISTS (SELECT 1 FROM list_words lw WHERE lw.word_id = w.word_id) "
+    "AND NOT EXISTS (SELECT 1 FROM review_schedule rs WHERE rs.word_id = w.word_id) "
+    "AND NOT EXISTS (SELECT 1 FROM study_sessions ss WHERE ss.word_id = w.word_id)";
+
+// Numbered parameters (?1,?2,...) so the same id list can appear twice in one statement
+std::string placeholders(size_t count) {
+    std::string out;
+    for (size_t i = 0; i < count; ++i) {
+        if (i > 0) out += ",";
+        out += "?" + std::to_string(i + 1);
+    }
+    return out;
+}
+}
+
+DataBase::OrphanReport DataBase::collectOrphanWords(int& cursor, int scanLimit, bool& reachedEnd) {
+    DB_SCOPE("collectOrphanWords");
+    OrphanReport report;
+
+    // The scan only reads, so it runs outside the write transaction
+    std::string scanSql = std::string("SELECT w.word_id, (") + kOrphanWordCondition + ") "
+                          "FROM words w WHERE w.word_id > ? ORDER BY w.word_id LIMIT ?;";
+    sqlite3_stmt* stmt = prepareStatementOrThrow(scanSql.c_str(), "collectOrphanWords scan");
+    sqlite3_bind_int(stmt, 1, cursor);
+    sqlite3_bind_int(stmt, 2, scanLimit);
+
+    std::vector<int> candidates;
+    int scanned = 0;
+    while (sqlite3_step(stmt) == SQLITE_ROW) {
+        cursor = sqlite3_column_int(stmt, 0);
+        if (sqlite3_column_int(stmt, 1) != 0) candidates.push_back(cursor);
+        scanned++;
+    }
+    sqlite3_finalize(stmt);
+    reachedEnd = scanned < scanLimit;
+
+    if (candidates.empty()) return report;
+
+    auto bindIds = [](sqlite3_stmt* s, const std::vector<int>& ids) {
+        for (size_t i = 0; i < ids.size(); ++i) sqlite3_bind_int(s, static_cast<int>(i) + 1, ids[i]);
+    };
+
+    try {
+        beginImmediateTransaction();
+
+        // Words may have been added back to a list since the scan, so recheck under the write lock
+        std::string recheckSql = "SELECT w.word_id FROM words w WHERE w.word_id IN (" + placeholders(candidates.size()) +
+                                 ") AND " + kOrphanWordCondition + ";";
+        stmt = prepareStatementOrThrow(recheckSql.c_str(), "collectOrphanWords recheck");
+        bindIds(stmt, candidates);
+        std::vector<int> doomed;
+        while (sqlite3_step(stmt) == SQLITE_ROW) {
+            doomed.push_back(sqlite3_column_int(stmt, 0));
+        }
+        sqlite3_finalize(stmt);
+
+        if (!doomed.empty()) {
+            std::string ids = placeholders(doomed.size());
+            const std::pair<std::string, int*> deletes[] = {
+                {"DELETE FROM word_relations WHERE word1_id IN (" + ids + ") OR word2_id IN (" + ids + ");", &report.relations},
+                {"DELETE FROM word_examples WHERE word_id IN (" + ids + ");", &report.examples},
+                {"DELETE FROM words WHERE word_id IN (" + ids + ");", &report.words},
+            };
+            for (const auto &d : deletes) {
+                stmt = prepareStatementOrThrow(d.first.c_str(), "collectOrphanWords delete");
+                bindIds(stmt, doomed);
+                executeStatementOrThrow(stmt, "collectOrphanWords delete");
+                *d.second += sqlite3_changes(db);
+                sqlite3_finalize(stmt);
+            }
+        }
+
+        commitTransaction();
+    } catch (...) {
+        try { rollbackTransaction(); } catch (...) {}
+        throw;
+    }
+
+    return report;
+}
+
+DataBase::OrphanReport DataBase::collectDanglingRows(int limit) {
+    DB_SCOPE("collectDanglingRows");
+    OrphanReport report;
+
+    sqlite3_stmt* stmt = prepareStatementOrThrow(
+        "DELETE FROM word_examples WHERE example_id IN ("
+        "SELECT e.example_id FROM word_examples e "
+        "WHERE NOT EXISTS (SELECT 1 FROM words w WHERE w.word_id = e.word_id) LIMIT ?);",
+        "collectDanglingRows examples");
+    sqlite3_bind_int(stmt, 1, limit);
+    executeStatementOrThrow(stmt, "collectDanglingRows examples");
+    report.examples = sqlite3_changes(db);
+    sqlite3_finalize(stmt);
+
+    stmt = prepareStatementOrThrow(
+        "DELETE FROM word_relations WHERE relation_id IN ("
+        "SELECT r.relation_id FROM word_relations r "
+        "WHERE NOT EXISTS (SELECT 1 FROM words w WHERE w.word_id = r.word1_id) "
+        "OR NOT EXISTS (SELECT 1 FROM words w WHERE w.word_id = r.word2_id) LIMIT ?);",
+        "collectDanglingRows relations");
+    sqlite3_bind_int(stmt, 1, limit);
+    executeStatementOrThrow(stmt, "collectDanglingRows relations");
+    report.relations = sqlite3_changes(db);
+    sqlite3_finalize(stmt);
+
+    return report;
+}
+
+namespace {
+// Virtual machine instructions between two checks of the maintenance deadline
+const int kProgressHandlerOps = 1000;
+
+long long steadyNowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+}
+
+const char* DataBase::maintenanceTaskName(MaintenanceTask task) {
+    switch (task) {
+    case MaintenanceTask::Analyze: return "analyze";
+    case MaintenanceTask::Optimize: return "optimize";
+    case MaintenanceTask::IncrementalVacuum: return "incremental_vacuum";
+    case MaintenanceTask::WalCheckpoint: return "wal_checkpoint";
+    }
+    return "unknown";
+}
+
+int DataBase::progressDeadlineHandler(void* self) {
+    // A non-zero return interrupts the running statement with SQLITE_INTERRUPT
+    return steadyNowNs() > static_cast<DataBase*>(self)->maintenanceDeadlineNs ? 1 : 0;
+}
+
+void DataBase::setStatementDeadline(int budgetMs) {
+    maintenanceDeadlineNs = steadyNowNs() + static_cast<long long>(budgetMs) * 1000000LL;
+    sqlite3_progress_handler(db, kProgressHandlerOps, &DataBase::progressDeadlineHandler, this);
+}
+
+void DataBase::clearStatementDeadline() {
+    sqlite3_progress_handler(db, 0, nullptr, nullptr);
+}
+
+void DataBase::addColumnIfMissing(const std::string& table, const std::string& column, const std::string& definition) {
+    std::string infoSql = "PRAGMA table_info(" + table + ");";
+    sqlite3_stmt* stmt = prepareStatementOrThrow(infoSql.c_str(), "addColumnIfMissing");
+
+    bool exists = false;
+    while (sqlite3_step(stmt) == SQLITE_ROW) {
+        const unsigned char* name = sqlite3_column_text(stmt, 1);
+        if (name && column == reinterpret_cast<const char*>(name)) {
+            exists = true;
+            break;
+        }
+    }
+    sqlite3_finalize(stmt);
+    if (exists) return;
+
+    std::string alterSql = "ALTER TABLE " + table + " ADD COLUMN " + column + " " + definition + ";";
+    char* errorMessage = nullptr;
+    int result = sqlite3_exec(db, alterSql.c_str(), nullptr, nullptr, &errorMessage);
+    if (result != SQLITE_OK) {
+        QString error = QString("Failed to add column %1.%2: %3")
+            .arg(QString::fromStdString(table))
+            .arg(QString::fromStdString(column))
+            .arg(QString::fromUtf8(errorMessage ? errorMessage : ""));
+        qCritical() << error;
+        sqlite3_free(errorMessage);
+        throw std::runtime_error(error.toStdString());
+    }
+    qInfo() << "Added column" << QString::fromStdString(table + "." + column);
+}
+
+long long DataBase::pragmaInt(const char* sql, const std::string& context) {
+    sqlite3_stmt* stmt = prepareStatementOrThrow(sql, context);
+    long long value = 0;
+    if (sqlite3_step(stmt) == SQLITE_ROW) {
+        value = sqlite3_column_int64(stmt, 0);
+    }
+    sqlite3_finalize(stmt);
+    return value;
+}
+
+long long DataBase::trackedRowCount() {
+    return pragmaInt(
+        "SELECT (SELECT COUNT(*) FROM words) + (SELECT COUNT(*) FROM list_words) "
+        "+ (SELECT COUNT(*) FROM review_schedule) + (SELECT COUNT(*) FROM study_sessions);",
+        "trackedRowCount");
+}
+
+bool DataBase::getMaintenanceState(MaintenanceTask task, long long& secondsSinceRun, long long& baseline) {
+    sqlite3_stmt* stmt = prepareStatementOrThrow(
+        "SELECT CAST(strftime('%s', 'now') AS INTEGER) - CAST(strftime('%s', last_run) AS INTEGER), baseline "
+        "FROM maintenance_state WHERE task = ?;", "getMaintenanceState");
+    sqlite3_bind_text(stmt, 1, maintenanceTaskName(task), -1, SQLITE_STATIC);
+
+    bool found = false;
+    if (sqlite3_step(stmt) == SQLITE_ROW) {
+        secondsSinceRun = sqlite3_column_int64(stmt, 0);
+        baseline = sqlite3_column_int64(stmt, 1);
+        found = true;
+    }
+
+    sqlite3_finalize(stmt);
+    return found;
+}
+
+void DataBase::saveMaintenanceState(MaintenanceTask task, long long baseline) {
+    sqlite3_stmt* stmt = prepareStatementOrThrow(
+        "INSERT INTO maintenance_state (task, last_run, baseline) VALUES (?, datetime('now'), ?) "
+        "ON CONFLICT(task) DO UPDATE SET last_run = excluded.last_run, baseline = excluded.baseline;",
+        "saveMaintenanceState");
+    sqlite3_bind_text(stmt, 1, maintenanceTaskName(task), -1, SQLITE_STATIC);
+    sqlite3_bind_int64(stmt, 2, static_cast<sqlite3_int64>(baseline));
+    executeStatementOrThrow(stmt, "saveMaintenanceState");
+    sqlite3_finalize(stmt);
+}
+
+bool DataBase::isMaintenanceDue(MaintenanceTask task, const MaintenanceThresholds& thresholds) {
+    DB_SCOPE("isMaintenanceDue");
+    long long secondsSinceRun = 0;
+    long long baseline = 0;
+
+    switch (task) {
+    case MaintenanceTask::Analyze: {
+        long long rows = trackedRowCount();
+        if (!getMaintenanceState(task, secondsSinceRun, baseline)) {
+            return rows >= thresholds.analyzeMinRows;
+        }
+        long long drift = std::llabs(rows - baseline);
+        return drift >= thresholds.analyzeMinRows && drift >= thresholds.analyzeGrowthRatio * static_cast<double>(baseline);
+    }
+    case MaintenanceTask::Optimize:
+        return !getMaintenanceState(task, secondsSinceRun, baseline)
+               || secondsSinceRun >= thresholds.optimizeIntervalHours * 3600LL;
+    case MaintenanceTask::IncrementalVacuum: {
+        // 2 = INCREMENTAL. Older databases only switch over through a full VACUUM, which rewrites the
+        // whole file under the write lock and cannot be time-sliced, so they are left alone here.
+        return pragmaInt("PRAGMA auto_vacuum;", "auto_vacuum") == 2
+               && pragmaInt("PRAGMA freelist_count;", "freelist_count") >= thresholds.vacuumMinFreePages;
+    }
+    case MaintenanceTask::WalCheckpoint: {
+        std::error_code ec;
+        auto walBytes = std::filesystem::file_size(dbPath + "-wal", ec);
+        if (ec) return false;
+        long long pageSize = pragmaInt("PRAGMA page_size;", "page_size");
+        return pageSize > 0 && static_cast<long long>(walBytes) / pageSize >= thresholds.checkpointMinWalPages;
+    }
+    }
+    return false;
+}
+
+DataBase::MaintenanceOutcome DataBase::runMaintenanceTask(MaintenanceTask task, const MaintenanceThresholds& thresholds, int budgetMs) {
+    DB_SCOPE("runMaintenanceTask");
+    MaintenanceOutcome outcome;
+    auto started = std::chrono::steady_clock::now();
+
+    // Returns false if the statement was cut off by the deadline
+    auto execWithinBudget = [this](const char* sql) {
+        char* err = nullptr;
+        int rc = sqlite3_exec(db, sql, nullptr, nullptr, &err);
+        if (rc == SQLITE_INTERRUPT) {
+            if (err) sqlite3_free(err);
+            return false;
+        }
+        if (rc != SQLITE_OK) {
+            QString errorMsg = QString("Maintenance statement failed (%1): %2").arg(sql).arg(QString::fromUtf8(err ? err : ""));
+            qCritical() << errorMsg;
+            if (err) sqlite3_free(err);
+            throw std::runtime_error(errorMsg.toStdString());
+        }
+        return true;
+    };
+
+    setStatementDeadline(budgetMs);
+    try {
+        switch (task) {
+        case MaintenanceTask::Analyze: {
+            long long rows = trackedRowCount();
+            std::vector<std::string> tables;
+            sqlite3_stmt* stmt = prepareStatementOrThrow(
+                "SELECT name FROM sqlite_master WHERE type = 'table' AND name NOT LIKE 'sqlite_%' AND name > ? ORDER BY name;",
+                "runMaintenanceTask tables");
+            sqlite3_bind_text(stmt, 1, analyzeResumeAfter.c_str(), -1, SQLITE_TRANSIENT);
+            while (sqlite3_step(stmt) == SQLITE_ROW) {
+                tables.push_back(reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0)));
+            }
+            sqlite3_finalize(stmt);
+
+            // One table per statement, so an interruption only loses the table it was on.
+            // analysis_limit samples large indexes instead of reading them fully.
+            execWithinBudget("PRAGMA analysis_limit = 1000;");
+            size_t done = 0;
+            for (; done < tables.size(); ++done) {
+                std::string sql = "ANALYZE \"" + tables[done] + "\";";
+                if (!execWithinBudget(sql.c_str())) break;
+                analyzeResumeAfter = tables[done];
+            }
+            if (done == tables.size()) {
+                analyzeResumeAfter.clear();
+                saveMaintenanceState(task, rows);
+                outcome.effect = "statistics refreshed (" + std::to_string(rows) + " tracked rows)";
+            } else {
+                outcome.interrupted = true;
+                outcome.progressed = done > 0;
+                outcome.effect = "analyzed " + std::to_string(done) + " tables, " + std::to_string(tables.size() - done) + " left";
+            }
+            break;
+        }
+        case MaintenanceTask::Optimize:
+            if (execWithinBudget("PRAGMA optimize;")) {
+                saveMaintenanceState(task, 0);
+                outcome.effect = "planner statistics checked";
+            } else {
+                outcome.interrupted = true;
+            }
+            break;
+        case MaintenanceTask::IncrementalVacuum: {
+            long long before = pragmaInt("PRAGMA freelist_count;", "freelist_count");
+            if (pragmaInt("PRAGMA auto_vacuum;", "auto_vacuum") != 2) {
+                // incremental_vacuum is a no-op here; see isMaintenanceDue
+                outcome.effect = "skipped, database predates incremental vacuum";
+                break;
+            }
+            long long remaining = before;
+            std::string step = "PRAGMA incremental_vacuum(" + std::to_string(thresholds.vacuumPagesPerStep) + ");";
+            // Small steps keep every write transaction short; stop when the budget runs out
+            while (remaining > 0 && steadyNowNs() < maintenanceDeadlineNs) {
+                if (!execWithinBudget(step.c_str())) break;
+                remaining = pragmaInt("PRAGMA freelist_count;", "freelist_count");
+            }
+            outcome.interrupted = remaining > 0;
+            outcome.progressed = remaining < before;
+            outcome.effect = "freed " + std::to_string(before - remaining) + " pages, " + std::to_string(remaining) + " free pages left";
+            break;
+        }
+        case MaintenanceTask::WalCheckpoint: {
+            int logFrames = 0;
+            int checkpointed = 0;
+            // PASSIVE never waits for readers or writers; frames still in use are left for the next run
+            int rc = sqlite3_wal_checkpoint_v2(db, nullptr, SQLITE_CHECKPOINT_PASSIVE, &logFrames, &checkpointed);
+            if (rc != SQLITE_OK && rc != SQLITE_BUSY) {
+                QString errorMsg = "WAL checkpoint failed: " + QString::fromStdString(std::string(sqlite3_errmsg(db)));
+                qCritical() << errorMsg;
+                throw std::runtime_error(errorMsg.toStdString());
+            }
+            outcome.interrupted = checkpointed < logFrames;
+            outcome.progressed = checkpointed > 0;
+            outcome.effect = "checkpointed " + std::to_string(checkpointed) + " of " + std::to_string(logFrames) + " WAL frames";
+            break;
+        }
+        }
+        outcome.ran = true;
+    } catch (...) {
+        clearStatementDeadline();
+        throw;
+    }
+    clearStatementDeadline();
+
+    outcome.elapsedMs = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - started).count();
+    qInfo() << "Maintenance" << maintenanceTaskName(task) << "took" << outcome.elapsedMs << "ms:"
+            << QString::fromStdString(outcome.interrupted && outcome.effect.empty() ? "interrupted by time budget" : outcome.effect);
+    return outcome;
+}
+
+std::vector<DataBase::DeckOverview> DataBase::getDeckOverview() {
+    DB_SCOPE("getDeckOverview");
+    // Due counts change when the next review comes due without any write, so the entry expires then.
+    // Only looked up when the overview is actually queried.
+    auto expires = [this]() {
+        long long untilDue = secondsUntilNextReview();
+        return untilDue < 0 ? QueryCache::Clock::time_point::max()
+                            : QueryCache::Clock::now() + std::chrono::seconds(untilDue);
+    };
+    return cachedRead<std::vector<DeckOverview>>("getDeckOverview", ListsTable | ScheduleTable, [this]() {
+        // New and total counts come from deck_counters; the rest are index probes on (list_id, next_review_date),
+        // so the cost grows with the number of due cards rather than the size of each deck
+        const char* sql =
+            "SELECT l.list_id, l.list_name, "
+            "       (SELECT MIN(next_review_date) FROM review_schedule WHERE list_id = l.list_id) AS next_review, "
+            "       COALESCE(c.new_cards, 0), "
+            "       (SELECT COUNT(*) FROM review_schedule "
+            "        WHERE list_id = l.list_id AND next_review_date <= datetime('now')) AS due, "
+            "       (SELECT COUNT(*) FROM review_schedule "
+            "        WHERE list_id = l.list_id AND repetition_count = 0 AND next_review_date <= datetime('now')) AS new_due, "
+            "       COALESCE(c.total_cards, 0) "
+            "FROM vocabulary_lists l "
+            "LEFT JOIN deck_counters c ON c.list_id = l.list_id "
+            "WHERE l.is_deleted = 0 "
+            "ORDER BY next_review IS NULL, next_review, l.list_name;";
+        sqlite3_stmt* stmt = prepareStatementOrThrow(sql, "getDeckOverview");
+
+        std::vector<DeckOverview> decks;
+        int rc;
+        while ((rc = sqlite3_step(stmt)) == SQLITE_ROW) {
+            DeckOverview d;
+            d.list_id = sqlite3_column_int(stmt, 0);
+            const unsigned char* name = sqlite3_column_text(stmt, 1);
+            if (name) d.list_name = reinterpret_cast<const char*>(name);
+            const unsigned char* next = sqlite3_column_text(stmt, 2);
+            if (next) d.next_review_date = reinterpret_cast<const char*>(next);
+            d.new_count = sqlite3_column_int(stmt, 3);
+            d.review_count = sqlite3_column_int(stmt, 4);
+            d.continuing_count = d.review_count - sqlite3_column_int(stmt, 5);
+            d.total_count = sqlite3_column_int(stmt, 6);
+            decks.push_back(std::move(d));
+        }
+        sqlite3_finalize(stmt);
+
+        if (rc != SQLITE_DONE) {
+            QString errorMsg = "Failed to read deck overview: " + QString::fromStdString(std::string(sqlite3_errmsg(db)));
+            qCritical() << errorMsg;
+            throw std::runtime_error(errorMsg.toStdString());
+        }
+        return decks;
+    }, expires);
+}
+
+int DataBase::countDueCards(int listID, bool newOnly) {
+    // The new-only form matches the partial index idx_review_schedule_new_due
+    const char* sql = newOnly
+        ? "SELECT COUNT(*) FROM review_schedule WHERE list_id = ? AND repetition_count = 0 AND next_review_date <= datetime('now');"
+        : "SELECT COUNT(*) FROM review_schedule WHERE list_id = ? AND next_review_date <= datetime('now');";
+    sqlite3_stmt* stmt = prepareStatementOrThrow(sql, "countDueCards");
+    sqlite3_bind_int(stmt, 1, listID);
+
     int count = 0;
     if (sqlite3_step(stmt) == SQLITE_ROW) {
         count = sqlite3_column_int(stmt, 0);
     }
-    
+
     sqlite3_finalize(stmt);
     return count;
 }
 
+std::string DataBase::getNextReviewDate() {
+    DB_SCOPE("getNextReviewDate");
+    sqlite3_stmt* stmt = prepareStatementOrThrow(
+        "SELECT MIN(next_review_date) FROM review_schedule rs WHERE next_review_date > datetime('now') "
+        "AND NOT EXISTS (SELECT 1 FROM vocabulary_lists l WHERE l.list_id = rs.list_id AND l.is_deleted = 1);", "getNextReviewDate");
+    std::string next;
+    if (sqlite3_step(stmt) == SQLITE_ROW && sqlite3_column_type(stmt, 0) != SQLITE_NULL) {
+        next = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0));
+    }
+    sqlite3_finalize(stmt);
+    return next;
+}
+
+long long DataBase::secondsUntilNextReview() {
+    sqlite3_stmt* stmt = prepareStatementOrThrow(
+        "SELECT CAST(strftime('%s', MIN(next_review_date)) AS INTEGER) - CAST(strftime('%s', 'now') AS INTEGER) "
+        "FROM review_schedule rs WHERE next_review_date > datetime('now') "
+        // Cards of deleted lists waiting for the purge must not drive the due timer or cache expiry
+        "AND NOT EXISTS (SELECT 1 FROM vocabulary_lists l WHERE l.list_id = rs.list_id AND l.is_deleted = 1);", "secondsUntilNextReview");
+    long long seconds = -1;
+    if (sqlite3_step(stmt) == SQLITE_ROW && sqlite3_column_type(stmt, 0) != SQLITE_NULL) {
+        seconds = std::max(0LL, static_cast<long long>(sqlite3_column_int64(stmt, 0)));
+    }
+    sqlite3_finalize(stmt);
+    return seconds;
+}
+
 // Get count of new cards (never reviewed) for a list
 int DataBase::getNewCardCount(int listID) {
-    return getCardCount(listID, "repetition_count = 0", "getNewCardCount");
+    DB_SCOPE("getNewCardCount");
+    sqlite3_stmt* stmt = prepareStatementOrThrow("SELECT new_cards FROM deck_counters WHERE list_id = ?;", "getNewCardCount");
+    sqlite3_bind_int(stmt, 1, listID);
+    int count = sqlite3_step(stmt) == SQLITE_ROW ? sqlite3_column_int(stmt, 0) : 0;
+    sqlite3_finalize(stmt);
+    return count;
 }
 
 // Get count of continuing cards (already started but due for review)
 int DataBase::getContinuingCardCount(int listID) {
-    return getCardCount(listID, "repetition_count > 0 AND next_review_date <= datetime('now')", "getContinuingCardCount");
+    DB_SCOPE("getContinuingCardCount");
+    // Due minus new due, as in getDeckOverview
+    return countDueCards(listID, false) - countDueCards(listID, true);
 }
 
 // Get count of all cards due for review (new + continuing)
 int DataBase::getReviewCardCount(int listID) {
-    return getCardCount(listID, "next_review_date <= datetime('now')", "getReviewCardCount");
+    DB_SCOPE("getReviewCardCount");
+    return countDueCards(listID, false);
 }
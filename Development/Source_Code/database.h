@@ -8,6 +8,10 @@ extern "C" {
 #include <vector>
 #include <utility>
 #include <tuple>
+#include <functional>
+#include <unordered_map>
+#include "sqlprofiler.h"
+#include "querycache.h"
 
 class DataBase
 {
@@ -17,6 +21,14 @@ public:
 
     void enableForeignKeys();
 
+    // Switches the connection to WAL so background connections can read while the UI writes
+    void enableWriteAheadLog();
+
+    // Requests auto_vacuum = INCREMENTAL; only takes effect on a database without tables
+    void enableIncrementalVacuum();
+
+    const std::string& getPath() const { return dbPath; }
+
     bool createVocabListTable();
 
     bool createWordsTable();
@@ -31,10 +43,35 @@ public:
 
     bool createWordRelationTable();
 
+    bool createDistractorTable();
+
+    bool createAIResponseCacheTable();
+
+    bool createEnrichmentProgressTable();
+
+    bool createMaintenanceStateTable();
+
+    // Per-list total and new-card counts kept current by triggers on review_schedule
+    bool createDeckCountersTable();
+
+    // Cards due per UTC day, kept current by triggers on review_schedule
+    bool createDueHistogramTable();
+
+    // Scheduler weights fitted from the review history, one row per scheduler (see fsrs.h)
+    bool createSchedulerParamsTable();
+
     // Transaction helpers
     bool beginTransaction();
     bool commitTransaction();
     bool rollbackTransaction();
+    // Takes the write lock up front instead of on the first write
+    bool beginImmediateTransaction();
+
+    // Online copy of the whole database into destPath (which must not exist) with sqlite3_backup_step,
+    // pagesPerStep pages at a time with a pause in between. The copy is one consistent snapshot;
+    // other connections keep reading and writing meanwhile. progress gets (remaining, total) pages.
+    void backupTo(const std::string& destPath, int pagesPerStep, int pauseMs,
+                  const std::function<void(int, int)>& progress = nullptr);
 
     // Lookup / CRUD helpers for adding words to lists
     int getWordId(const std::string& word, const std::string& language);
@@ -48,14 +85,49 @@ public:
     // Returns the word_id on success, or -1 on error (throws on DB errors).
     int addWordAndSetup(int listID, const std::string& word, const std::string& partOfSpeech = "", const std::string& definition = "", const std::string& language = "");
 
+    struct NewWord {
+        std::string word;
+        std::string part_of_speech;
+        std::string definition;
+        std::string language;
+    };
+
+    // Batched variant of addWordAndSetup: all words are added in one transaction.
+    // Returns the number of words processed (throws on DB errors, nothing is kept in that case).
+    int addWordsAndSetup(int listID, const std::vector<NewWord>& words);
+
     bool createNewList(std::string listName, std::string targetLanguage, std::string description);
 
+    // Hides the list immediately; its rows are removed afterwards by purgeDeletedListBatch
     bool deleteList(int listID);
 
+    // Lists marked deleted whose rows have not been purged yet (e.g. the app quit mid-purge)
+    std::vector<int> getDeletedListIds();
+    // Rows still to be purged for a deleted list
+    int countListRows(int listID);
+    // Deletes at most batchSize rows of a deleted list in one short transaction and removes the
+    // list itself once nothing else refers to it. Returns the number of rows deleted.
+    int purgeDeletedListBatch(int listID, int batchSize, bool& finished);
+
     std::vector<std::string> getVocabLists();
+    std::vector<int> getVocabListIds();
     // Returns a vector of pairs (list_name, next_review_date_string or empty if none)
     std::vector<std::pair<std::string, std::string>> getVocabListsWithNextReview();
 
+    struct DeckOverview {
+        int list_id = 0;
+        std::string list_name;
+        std::string next_review_date;   // empty if the list has no cards
+        int new_count = 0;
+        int continuing_count = 0;
+        int review_count = 0;
+        int total_count = 0;            // every card in the list, due or not
+    };
+
+    // Every list with its card counts in one query, earliest next review first and lists
+    // without cards last (alphabetically)
+    std::vector<DeckOverview> getDeckOverview();
+
     struct DueCard {
         int schedule_id;
         int word_id;
@@ -66,19 +138,74 @@ public:
         int interval_days;
         int repetition_count;
         std::string next_review_date;
+        double fsrs_stability = 0.0;    // 0 until the card has an FSRS memory state
+        double fsrs_difficulty = 0.0;
     };
 
     // Get due cards (next_review_date <= now). If listID < 0, return for all lists.
     std::vector<DueCard> getDueCards(int listID = -1);
+    // Due cards by schedule_id in the order given; ids that no longer exist are skipped
+    std::vector<DueCard> getDueCardsByScheduleIds(const std::vector<int>& scheduleIDs);
 
-    // Update review schedule for a given word/list
-    bool updateReviewScheduleForWord(int wordID, int listID, int repetition_count, int interval_days, double ease_factor, const std::string& next_review_date);
+    // An overdue review without its text, for planners that look at every overdue card once
+    struct OverdueCard {
+        int schedule_id;
+        int word_id;
+        int list_id;
+        int interval_days;
+        double ease_factor;
+        double days_overdue;
+        double fsrs_stability;          // 0 without an FSRS memory state
+    };
+    // Streams the started cards (repetition_count > 0) that are past due in lists not marked
+    // deleted, in no particular order, without building the DueCard list
+    void forEachOverdueCard(const std::function<void(const OverdueCard&)>& visit);
+    // Scheduled ratings recorded since local midnight; random practice is not counted
+    int countReviewsToday();
+
+    // Update review schedule for a given word/list. An FSRS stability of 0 leaves the stored memory state as it is.
+    bool updateReviewScheduleForWord(int wordID, int listID, int repetition_count, int interval_days, double ease_factor, const std::string& next_review_date,
+                                     double fsrs_stability = 0.0, double fsrs_difficulty = 0.0);
+
+    // Cards due on each of the UTC days [firstDay, firstDay + days), days counted from the Unix epoch.
+    // Reads the trigger-maintained histogram, so the cost is proportional to days.
+    std::vector<int> getDueLoad(long long firstDay, int days);
+
+    // Scheduler used for a list's reviews: "sm2" (the default) or "fsrs"
+    std::string getListScheduler(int listID);
+    bool setListScheduler(int listID, const std::string& scheduler);
+    // Intervals in days after a list's first and second successful SM-2 reviews (classic SM-2: 1 and 6)
+    bool getListSm2Steps(int listID, int& firstIntervalDays, int& secondIntervalDays);
+    bool setListSm2Steps(int listID, int firstIntervalDays, int secondIntervalDays);
+
+    struct SchedulerParams {
+        std::string params;             // space-separated weights
+        long long reviewCount = 0;      // review logs the fit was based on
+        double logLoss = 0.0;
+        long long secondsSinceFit = 0;
+    };
+    bool getSchedulerParams(const std::string& scheduler, SchedulerParams& out);
+    void saveSchedulerParams(const std::string& scheduler, const std::string& params, long long reviewCount, double logLoss);
+
+    // Rated scheduled reviews in study_sessions. forEachReviewLog visits them grouped by word, oldest first,
+    // as (word_id, unix time, confidence 1..5).
+    long long countReviewLogs();
+    void forEachReviewLog(const std::function<void(int wordID, long long reviewedAt, int confidence)>& visit);
+
+    struct MemoryStateUpdate {
+        int word_id;
+        double stability;
+        double difficulty;
+    };
+    // Stores FSRS memory states in one transaction; returns the number of cards updated
+    int updateMemoryStates(const std::vector<MemoryStateUpdate>& states);
 
     // Record a study session entry
     bool recordStudySession(int wordID, int listID, bool was_correct, int quality);
 
-    // Record a study session with an explicit study mode (e.g. "flashcard", "multiple_choice")
-    bool recordStudySession(int wordID, int listID, bool was_correct, int quality, const std::string& study_mode);
+    // Record a study session with an explicit study mode (e.g. "flashcard", "multiple_choice").
+    // scheduled = false marks a review that did not update the schedule (random practice).
+    bool recordStudySession(int wordID, int listID, bool was_correct, int quality, const std::string& study_mode, bool scheduled = true);
 
     // Returns a human-readable summary string of study sessions (counts, averages, breakdowns)
     std::string getStudySessionSummary();
@@ -87,6 +214,39 @@ public:
     // excludeWordID may be -1 to not exclude anything.
     std::vector<std::pair<int, std::string>> getRandomWordsInList(int listID, int excludeWordID, int count);
 
+    // Precomputed confusable distractors for multiple-choice questions (see DistractorBuilder).
+    struct DistractorEntry {
+        int word_id;
+        std::vector<std::pair<int, double>> distractors; // (distractor word_id, similarity), best first
+    };
+
+    // Identifies the word set of a list: any insert raises the highest list_words id, any delete lowers the count
+    struct ListWordsStamp {
+        long long wordCount = 0;
+        long long maxListWordID = 0;
+        bool operator==(const ListWordsStamp& other) const {
+            return wordCount == other.wordCount && maxListWordID == other.maxListWordID;
+        }
+    };
+    ListWordsStamp getListWordsStamp(int listID);
+    // The stamp the list's distractor rows were built from; false if they were never built
+    bool getDistractorStamp(int listID, ListWordsStamp& stamp);
+    // Stored distractor ids of every word in the list, best first
+    std::unordered_map<int, std::vector<int>> getStoredDistractorIds(int listID);
+
+    // Replaces the stored distractors of every word in `entries` and records the stamp they were
+    // built from, in a single transaction.
+    bool replaceDistractors(int listID, const std::vector<DistractorEntry>& entries, const ListWordsStamp& stamp);
+
+    // Returns up to `count` (word_id, definition) pairs from the distractor table, most similar first.
+    std::vector<std::pair<int, std::string>> getDistractors(int listID, int wordID, int count);
+
+    // Content-addressed cache of parsed AI generations (key = hash of model, messages and parameters).
+    // Returns false on a miss or when the entry is older than maxAgeSeconds (expired entries are removed).
+    bool getCachedAIResponse(const std::string& cacheKey, long long maxAgeSeconds, std::string& entriesJson);
+    // Stores an entry and evicts least recently used entries until the cache fits in maxTotalBytes.
+    bool putCachedAIResponse(const std::string& cacheKey, const std::string& entriesJson, long long maxTotalBytes);
+
     // Return all words in a list (word_id, word_text, definition). If listID < 0 return all words.
     std::vector<std::tuple<int, std::string, std::string>> getWordsInList(int listID);
 
@@ -113,20 +273,179 @@ public:
     // Get all word relations (returns related words and their relationship types)
     std::vector<WordRelation> getWordRelations(int wordID);
 
+    // Batch AI enrichment (see EnrichmentJob)
+    struct EnrichmentCandidate {
+        int word_id;
+        std::string word;
+        std::string definition;
+        bool needs_examples;
+        bool needs_relations;
+    };
+
+    struct EnrichmentResult {
+        int word_id;
+        std::vector<std::pair<std::string, std::string>> examples;   // (example_text, context_notes)
+        std::vector<std::pair<std::string, std::string>> relations;  // (related word text, relation_type)
+    };
+
+    // Words after afterWordID (ascending) that have no examples or no relations yet
+    std::vector<EnrichmentCandidate> getWordsMissingEnrichment(int afterWordID, int limit);
+    int countWordsMissingEnrichment(int afterWordID);
+
+    // Writes one batch of results in a single transaction. Related words that are not in the
+    // database and invalid relation types are skipped. Returns the number of rows written.
+    int addEnrichmentBatch(const std::vector<EnrichmentResult>& results);
+
+    // Resumable progress of a named enrichment job
+    bool getEnrichmentCheckpoint(const std::string& jobName, int& lastWordID, long long& processed);
+    bool saveEnrichmentCheckpoint(const std::string& jobName, int lastWordID, long long processed);
+
+    // Orphan collection: words that are in no list and have no schedule or study history,
+    // together with their examples and relations
+    struct OrphanReport {
+        int words = 0;
+        int examples = 0;
+        int relations = 0;
+    };
+
+    // Scans at most scanLimit words after cursor and deletes the orphans among them in one
+    // short write transaction. Advances cursor; reachedEnd is set once the scan passes the last word.
+    OrphanReport collectOrphanWords(int& cursor, int scanLimit, bool& reachedEnd);
+
+    // Deletes at most limit examples and relations that point at words which no longer exist
+    // (left behind by databases written before foreign keys were enforced)
+    OrphanReport collectDanglingRows(int limit);
+
+    // Idle-time maintenance (see MaintenanceScheduler)
+    enum class MaintenanceTask {
+        Analyze,
+        Optimize,
+        IncrementalVacuum,
+        WalCheckpoint
+    };
+
+    // When each task is worth running
+    struct MaintenanceThresholds {
+        double analyzeGrowthRatio = 0.10;   // row count change since the last ANALYZE, as a fraction
+        int analyzeMinRows = 1000;          // ignore growth below this many rows
+        int optimizeIntervalHours = 24;
+        int vacuumMinFreePages = 256;
+        int vacuumPagesPerStep = 64;
+        int checkpointMinWalPages = 1000;
+    };
+
+    struct MaintenanceOutcome {
+        bool ran = false;
+        bool interrupted = false;           // stopped by the time budget, will continue next time
+        bool progressed = false;            // an interrupted task still got some of its work done
+        long long elapsedMs = 0;
+        std::string effect;
+    };
+
+    static const char* maintenanceTaskName(MaintenanceTask task);
+    bool isMaintenanceDue(MaintenanceTask task, const MaintenanceThresholds& thresholds);
+    // Runs one task for at most budgetMs. Long statements are cut off through the progress handler.
+    // ANALYZE goes table by table and resumes where it stopped.
+    MaintenanceOutcome runMaintenanceTask(MaintenanceTask task, const MaintenanceThresholds& thresholds, int budgetMs);
+
     // Get card counts for a list
     int getNewCardCount(int listID);           // Cards never reviewed (repetition_count = 0)
     int getContinuingCardCount(int listID);     // Cards with repetition_count > 0 and due now
     int getReviewCardCount(int listID);         // All cards due for review now
 
+    // Earliest next_review_date still in the future ("YYYY-MM-DD HH:MM:SS" UTC), empty when nothing is scheduled
+    std::string getNextReviewDate();
+
+    // Change notification. After a transaction that wrote rows commits on any DataBase connection,
+    // the observer receives a mask of the tables it touched. It runs on the thread that wrote,
+    // once the outermost public call has returned.
+    enum ChangedTable : unsigned {
+        ListsTable = 1u << 0,           // vocabulary_lists
+        WordsTable = 1u << 1,           // words
+        ListWordsTable = 1u << 2,       // list_words
+        ScheduleTable = 1u << 3,        // review_schedule, deck_counters, due_histogram
+        SessionsTable = 1u << 4,        // study_sessions
+        ExamplesTable = 1u << 5,        // word_examples
+        RelationsTable = 1u << 6,       // word_relations
+        DistractorsTable = 1u << 7,     // word_distractors
+        OtherTables = 1u << 31,
+        AllTables = ~0u
+    };
+    using ChangeObserver = std::function<void(unsigned tables)>;
+    static void setChangeObserver(ChangeObserver observer);
+    static unsigned tableMask(const char* table);
+
 private:
     sqlite3* db;
+    std::string dbPath;
     
     // Helper methods for error handling
     sqlite3_stmt* prepareStatementOrThrow(const char* sql, const std::string& context);
     void executeStatementOrThrow(sqlite3_stmt* stmt, const std::string& context);
     
-    // Helper for card count queries
-    int getCardCount(int listID, const std::string& whereClause, const std::string& context);
+    // Time budget enforced by the progress handler while maintenance runs
+    static int progressDeadlineHandler(void* self);
+    void setStatementDeadline(int budgetMs);
+    void clearStatementDeadline();
+    long long maintenanceDeadlineNs = 0;
+    // ANALYZE goes one table at a time; an interrupted pass resumes after the last table finished
+    std::string analyzeResumeAfter;
+
+    // Statement profiling through sqlite3_trace_v2: every statement feeds SqlProfiler, and the ones
+    // over the slow-query threshold are queued here. EXPLAIN QUERY PLAN cannot run inside the trace
+    // callback, so the queue is written to the slow-query log when the outermost public call returns.
+    static int traceCallback(unsigned type, void* self, void* p, void* x);
+    void enableStatementProfiling();
+    void onStatementProfiled(sqlite3_stmt* stmt, long long ns);
+    void flushSlowQueries();
+    std::vector<std::string> explainQueryPlan(const std::string& sql);
+    std::string slowQueryLogPath;
+    std::vector<SlowQueryLog::Entry> pendingSlowQueries;
+    std::unordered_map<sqlite3_stmt*, uint64_t> rowsStepped;
+    sqlite3_stmt* lastRowStmt = nullptr;
+    uint64_t lastRowCount = 0;
+    std::unordered_map<std::string, std::pair<std::string, std::string>> fingerprintCache;  // sql -> (normalized, fingerprint)
+    bool profilingSuspended = false;
+    int publicCallDepth = 0;
+
+    // Rows written by the open transaction (sqlite3_update_hook) and by committed ones not yet reported.
+    // Reporting waits for CallScope so the observer never runs inside a statement.
+    static void updateHook(void* self, int op, const char* dbName, const char* table, sqlite3_int64 rowid);
+    static int commitHook(void* self);
+    static void rollbackHook(void* self);
+    void enableChangeHooks();
+    void publishChanges();
+    unsigned uncommittedChanges = 0;
+    unsigned committedChanges = 0;
+
+    // Serves a read from QueryCache, or runs query and caches its result under key until one of
+    // tables is written (or until the time point returned by expires(), which only runs on a miss).
+    // Bypassed inside an explicit transaction.
+    template <typename T, typename Query, typename Expiry>
+    T cachedRead(const std::string& key, unsigned tables, Query query, Expiry expires);
+    template <typename T, typename Query>
+    T cachedRead(const std::string& key, unsigned tables, Query query);
+    // Seconds until the earliest future next_review_date, or -1 if none
+    long long secondsUntilNextReview();
+
+    // Tracks public-call nesting so slow queries are explained and changes reported once no statement of the call is running
+    struct CallScope {
+        explicit CallScope(DataBase* database) : db(database) { db->publicCallDepth++; }
+        ~CallScope();
+        DataBase* db;
+    };
+
+    // Schema migration helper for databases created by older versions
+    void addColumnIfMissing(const std::string& table, const std::string& column, const std::string& definition);
+
+    long long pragmaInt(const char* sql, const std::string& context);
+    long long trackedRowCount();
+    bool getMaintenanceState(MaintenanceTask task, long long& secondsSinceRun, long long& baseline);
+    void saveMaintenanceState(MaintenanceTask task, long long baseline);
+
+    // Cards of a list due now (only never-reviewed ones if newOnly), counted on the same
+    // (list_id, next_review_date) indexes getDeckOverview probes
+    int countDueCards(int listID, bool newOnly);
 };
 
 #endif // DATABASE_H
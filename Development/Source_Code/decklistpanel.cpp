@@ -1,16 +1,18 @@
 #include "decklistpanel.h"
 #include "ui_decklistpanel.h"
-#include <algorithm>
+#include "metrics.h"
+#include "tracing.h"
 #include <QHeaderView>
 
-DeckListPanel::DeckListPanel(DataBase* database, QWidget *parent)
+DeckListPanel::DeckListPanel(QWidget *parent)
     : QWidget(parent)
     , ui(new Ui::DeckListPanel)
-    , db(database)
+    , model(new DeckTableModel(this))
 {
     ui->setupUi(this);
+    ui->deckList->setModel(model);
     
-    // Configure table widget
+    // Configure table view
     ui->deckList->horizontalHeader()->setStretchLastSection(false);
     ui->deckList->horizontalHeader()->setSectionResizeMode(0, QHeaderView::Stretch);
     ui->deckList->horizontalHeader()->setSectionResizeMode(1, QHeaderView::ResizeToContents);
@@ -20,15 +22,15 @@ DeckListPanel::DeckListPanel(DataBase* database, QWidget *parent)
     
     // Apply styling
     ui->deckList->setStyleSheet(
-        "QTableWidget { "
+        "QTableView { "
         "   border: none; "
         "   background-color: transparent; "
         "} "
-        "QTableWidget::item { "
+        "QTableView::item { "
         "   border: none; "
         "   padding: 8px; "
         "} "
-        "QTableWidget::item:selected { "
+        "QTableView::item:selected { "
         "   background-color: palette(highlight); "
         "   color: palette(highlighted-text); "
         "} "
@@ -41,9 +43,7 @@ DeckListPanel::DeckListPanel(DataBase* database, QWidget *parent)
         "}"
     );
     
-    connect(ui->deckList, &QTableWidget::itemDoubleClicked, this, &DeckListPanel::onDeckItemDoubleClicked);
-    
-    updateDeckList();
+    connect(ui->deckList, &QTableView::doubleClicked, this, &DeckListPanel::onDeckDoubleClicked);
 }
 
 DeckListPanel::~DeckListPanel()
@@ -53,52 +53,56 @@ DeckListPanel::~DeckListPanel()
 
 void DeckListPanel::updateDeckList()
 {
-    ui->deckList->setRowCount(0);
-    
-    // Get lists with their next review date and sort by earliest review first
-    auto lists = db->getVocabListsWithNextReview();
-    
-    // Sort: empty dates (no reviews) go to the end; otherwise sort by datetime string ascending
-    std::sort(lists.begin(), lists.end(), [](const auto &a, const auto &b) {
-        const std::string &da = a.second;
-        const std::string &dbs = b.second;
-        if (da.empty() && dbs.empty()) return a.first < b.first; // both empty -> alphabetical
-        if (da.empty()) return false; // a goes after b
-        if (dbs.empty()) return true;  // a goes before b
-        return da < dbs; // ISO-like datetime textual compare works for 'YYYY-MM-DD HH:MM:SS'
-    });
-    
-    for (const auto &p : lists) {
-        QString deckName = QString::fromStdString(p.first);
-        
-        // Get card counts for this list
-        int listID = db->getListId(p.first);
-        int newCount = db->getNewCardCount(listID);
-        int continuingCount = db->getContinuingCardCount(listID);
-        int reviewCount = db->getReviewCardCount(listID);
-        
-        // Add row to table
-        int row = ui->deckList->rowCount();
-        ui->deckList->insertRow(row);
-        ui->deckList->setItem(row, 0, new QTableWidgetItem(deckName));
-        ui->deckList->setItem(row, 1, new QTableWidgetItem(QString::number(newCount)));
-        ui->deckList->setItem(row, 2, new QTableWidgetItem(QString::number(continuingCount)));
-        ui->deckList->setItem(row, 3, new QTableWidgetItem(QString::number(reviewCount)));
-        
-        // Center align the numeric columns
-        ui->deckList->item(row, 1)->setTextAlignment(Qt::AlignCenter);
-        ui->deckList->item(row, 2)->setTextAlignment(Qt::AlignCenter);
-        ui->deckList->item(row, 3)->setTextAlignment(Qt::AlignCenter);
+    if (loadInFlight) {
+        reloadQueued = true;
+        return;
+    }
+    loadInFlight = true;
+    emit reloadRequested();
+}
+
+void DeckListPanel::onLoadFailed()
+{
+    loadInFlight = false;
+    reloadQueued = false;
+}
+
+void DeckListPanel::showCachedOverview(const QVector<DataBase::DeckOverview>& overview, const QDateTime& savedAt)
+{
+    TRACE_SCOPE("DeckListPanel::showCachedOverview");
+    stale = true;
+    ui->staleLabel->setText("Updating deck list... (counts from " + savedAt.toLocalTime().toString("dd MMM HH:mm") + ")");
+    ui->staleLabel->setVisible(true);
+    model->setDecks(overview);
+}
+
+void DeckListPanel::setDeckOverview(const QVector<DataBase::DeckOverview>& overview)
+{
+    METRICS_SCOPE("ui.decklist.update");
+    TRACE_SCOPE("DeckListPanel::setDeckOverview");
+    loadInFlight = false;
+    live = true;
+    if (stale) {
+        stale = false;
+        ui->staleLabel->setVisible(false);
+    }
+    model->setDecks(overview);
+
+    emit deckListUpdated();
+    if (reloadQueued) {
+        reloadQueued = false;
+        updateDeckList();
     }
 }
 
-void DeckListPanel::onDeckItemDoubleClicked(QTableWidgetItem* item)
+void DeckListPanel::onDeckDoubleClicked(const QModelIndex& index)
 {
-    if (!item) return;
+    TRACE_SCOPE("DeckListPanel::onDeckDoubleClicked");
+    if (!index.isValid()) return;
     
-    int row = item->row();
-    QString deckName = ui->deckList->item(row, 0)->text();
-    int listID = db->getListId(deckName.toStdString());
+    QModelIndex nameIndex = model->index(index.row(), DeckTableModel::NameColumn);
+    QString deckName = nameIndex.data().toString();
+    int listID = nameIndex.data(DeckTableModel::ListIdRole).toInt();
     
     emit deckDoubleClicked(deckName, listID);
 }
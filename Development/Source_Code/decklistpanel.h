@@ -2,33 +2,56 @@
 #define DECKLISTPANEL_H
 
 #include <QWidget>
-#include <QTableWidgetItem>
+#include <QModelIndex>
+#include <QVector>
+#include <QDateTime>
 #include "database.h"
+#include "decktablemodel.h"
 
 namespace Ui {
 class DeckListPanel;
 }
 
+// Shows the decks with their card counts. The rows are loaded off the UI thread: updateDeckList()
+// asks for a reload through reloadRequested() and setDeckOverview() fills the table with the result.
+// At launch showCachedOverview() paints the last session's rows, marked stale until the first load lands.
 class DeckListPanel : public QWidget
 {
     Q_OBJECT
 
 public:
-    explicit DeckListPanel(DataBase* database, QWidget *parent = nullptr);
+    explicit DeckListPanel(QWidget *parent = nullptr);
     ~DeckListPanel();
 
+    // Requests a reload; calls made while one is running are folded into a single follow-up
     void updateDeckList();
     void applyTheme(bool isDarkMode);
 
+    void showCachedOverview(const QVector<DataBase::DeckOverview>& decks, const QDateTime& savedAt);
+    // Rows currently shown (live or cached)
+    const QVector<DataBase::DeckOverview>& deckOverview() const { return model->decks(); }
+    // True once rows from the database (not the cache) have been shown
+    bool hasLiveOverview() const { return live; }
+
+public slots:
+    void setDeckOverview(const QVector<DataBase::DeckOverview>& overview);
+    void onLoadFailed();
+
 signals:
     void deckDoubleClicked(const QString& deckName, int listID);
+    void reloadRequested();
+    void deckListUpdated();
 
 private slots:
-    void onDeckItemDoubleClicked(QTableWidgetItem* item);
+    void onDeckDoubleClicked(const QModelIndex& index);
 
 private:
     Ui::DeckListPanel *ui;
-    DataBase* db;
+    DeckTableModel* model;
+    bool stale = false;
+    bool live = false;
+    bool loadInFlight = false;
+    bool reloadQueued = false;
 };
 
 #endif // DECKLISTPANEL_H
@@ -0,0 +1,71 @@
+#include "deckoverviewcache.h"
+#include <QDataStream>
+#include <QDebug>
+#include <QFile>
+#include <QSaveFile>
+
+QString DeckOverviewCache::pathFor(const std::string& dbPath) {
+    return QString::fromStdString(dbPath) + ".overview";
+}
+
+bool DeckOverviewCache::save(const QString& path, const QVector<DataBase::DeckOverview>& decks) {
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qWarning() << "Cannot write deck overview cache" << path << ":" << file.errorString();
+        return false;
+    }
+
+    QDataStream out(&file);
+    out.setVersion(QDataStream::Qt_5_12);
+    out << MAGIC << VERSION << QDateTime::currentDateTimeUtc() << static_cast<quint32>(decks.size());
+    for (const auto &d : decks) {
+        out << static_cast<qint32>(d.list_id)
+            << QString::fromStdString(d.list_name)
+            << QString::fromStdString(d.next_review_date)
+            << static_cast<qint32>(d.new_count)
+            << static_cast<qint32>(d.continuing_count)
+            << static_cast<qint32>(d.review_count)
+            << static_cast<qint32>(d.total_count);
+    }
+
+    if (out.status() != QDataStream::Ok || !file.commit()) {
+        qWarning() << "Cannot write deck overview cache" << path << ":" << file.errorString();
+        return false;
+    }
+    return true;
+}
+
+bool DeckOverviewCache::load(const QString& path, QVector<DataBase::DeckOverview>& decks, QDateTime& savedAt) {
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) return false;
+
+    QDataStream in(&file);
+    in.setVersion(QDataStream::Qt_5_12);
+    quint32 magic = 0;
+    quint16 version = 0;
+    quint32 count = 0;
+    in >> magic >> version >> savedAt >> count;
+    if (in.status() != QDataStream::Ok || magic != MAGIC || version != VERSION || count > MAX_DECKS) return false;
+
+    QVector<DataBase::DeckOverview> loaded;
+    loaded.reserve(static_cast<int>(count));
+    for (quint32 i = 0; i < count; ++i) {
+        qint32 listID, newCount, continuingCount, reviewCount, totalCount;
+        QString name, nextReview;
+        in >> listID >> name >> nextReview >> newCount >> continuingCount >> reviewCount >> totalCount;
+        if (in.status() != QDataStream::Ok) return false;
+
+        DataBase::DeckOverview d;
+        d.list_id = listID;
+        d.list_name = name.toStdString();
+        d.next_review_date = nextReview.toStdString();
+        d.new_count = newCount;
+        d.continuing_count = continuingCount;
+        d.review_count = reviewCount;
+        d.total_count = totalCount;
+        loaded.append(d);
+    }
+
+    decks = loaded;
+    return true;
+}
@@ -0,0 +1,27 @@
+#ifndef DECKOVERVIEWCACHE_H
+#define DECKOVERVIEWCACHE_H
+
+#include <QDateTime>
+#include <QString>
+#include <QVector>
+#include "database.h"
+
+// Sidecar file (<database>.overview) holding the last deck overview shown, so the deck list
+// can be painted at launch before the first query against the database has answered.
+class DeckOverviewCache
+{
+public:
+    static QString pathFor(const std::string& dbPath);
+
+    // Both return false instead of throwing: the cache is only ever a hint
+    static bool save(const QString& path, const QVector<DataBase::DeckOverview>& decks);
+    static bool load(const QString& path, QVector<DataBase::DeckOverview>& decks, QDateTime& savedAt);
+
+private:
+    static constexpr quint32 MAGIC = 0x564f5643;  // "VOVC"
+    static constexpr quint16 VERSION = 2;
+    // Refuse files claiming more decks than this (a corrupt count would allocate forever)
+    static constexpr quint32 MAX_DECKS = 100000;
+};
+
+#endif // DECKOVERVIEWCACHE_H
@@ -0,0 +1,36 @@
+#include "deckoverviewloader.h"
+#include "tracing.h"
+#include <QDebug>
+#include <stdexcept>
+
+DeckOverviewLoader::DeckOverviewLoader(const std::string& dbPath, QObject *parent)
+    : QObject(parent)
+    , dbPath(dbPath) {
+    qRegisterMetaType<QVector<DataBase::DeckOverview>>("QVector<DataBase::DeckOverview>");
+}
+
+DeckOverviewLoader::~DeckOverviewLoader() {
+}
+
+DataBase* DeckOverviewLoader::connection() {
+    // Opened lazily so the connection is created on the worker thread that uses it
+    if (!db) {
+        db = std::make_unique<DataBase>(dbPath);
+    }
+    return db.get();
+}
+
+void DeckOverviewLoader::load() {
+    TRACE_SCOPE_CAT("worker", "DeckOverviewLoader::load");
+    try {
+        std::vector<DataBase::DeckOverview> decks = connection()->getDeckOverview();
+        std::string next = connection()->getNextReviewDate();
+        emit loaded(QVector<DataBase::DeckOverview>(decks.begin(), decks.end()));
+        // Stored as "YYYY-MM-DD HH:MM:SS" in UTC
+        emit nextReviewDue(next.empty() ? QDateTime()
+                                        : QDateTime::fromString(QString::fromStdString(next).replace(' ', 'T') + 'Z', Qt::ISODate));
+    } catch (const std::exception &e) {
+        qWarning() << "Loading the deck overview failed:" << e.what();
+        emit loadFailed(QString::fromStdString(e.what()));
+    }
+}
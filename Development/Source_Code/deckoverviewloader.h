@@ -0,0 +1,40 @@
+#ifndef DECKOVERVIEWLOADER_H
+#define DECKOVERVIEWLOADER_H
+
+#include <QObject>
+#include <QMetaType>
+#include <QVector>
+#include <QDateTime>
+#include <memory>
+#include <string>
+#include "database.h"
+
+Q_DECLARE_METATYPE(DataBase::DeckOverview)
+
+// Reads the deck list with its card counts on a worker thread (own DataBase connection)
+// so neither startup nor a refresh blocks the UI on the per-deck queries.
+class DeckOverviewLoader : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit DeckOverviewLoader(const std::string& dbPath, QObject *parent = nullptr);
+    ~DeckOverviewLoader();
+
+public slots:
+    void load();
+
+signals:
+    void loaded(const QVector<DataBase::DeckOverview>& decks);
+    void loadFailed(const QString& error);
+    // Earliest future review in UTC (invalid when nothing is scheduled), sent after each load
+    void nextReviewDue(const QDateTime& dueUtc);
+
+private:
+    DataBase* connection();
+
+    std::string dbPath;
+    std::unique_ptr<DataBase> db;
+};
+
+#endif // DECKOVERVIEWLOADER_H
@@ -0,0 +1,112 @@
+#include "decktablemodel.h"
+#include <QSet>
+
+DeckTableModel::DeckTableModel(QObject *parent)
+    : QAbstractTableModel(parent) {
+
+}
+
+int DeckTableModel::rowCount(const QModelIndex &parent) const {
+    return parent.isValid() ? 0 : rows.size();
+}
+
+int DeckTableModel::columnCount(const QModelIndex &parent) const {
+    return parent.isValid() ? 0 : ColumnCount;
+}
+
+QVariant DeckTableModel::data(const QModelIndex &index, int role) const {
+    if (!index.isValid() || index.row() >= rows.size()) return QVariant();
+    const DataBase::DeckOverview &d = rows.at(index.row());
+
+    switch (role) {
+    case Qt::DisplayRole:
+        switch (index.column()) {
+        case NameColumn: return QString::fromStdString(d.list_name);
+        case NewColumn: return d.new_count;
+        case DueColumn: return d.continuing_count;
+        case ReviewColumn: return d.review_count;
+        }
+        break;
+    case Qt::ToolTipRole:
+        if (index.column() == NameColumn) return QString("%1 cards").arg(d.total_count);
+        break;
+    case Qt::TextAlignmentRole:
+        // Center align the numeric columns
+        if (index.column() != NameColumn) return int(Qt::AlignCenter);
+        break;
+    case ListIdRole:
+        return d.list_id;
+    }
+    return QVariant();
+}
+
+QVariant DeckTableModel::headerData(int section, Qt::Orientation orientation, int role) const {
+    if (orientation != Qt::Horizontal || role != Qt::DisplayRole) return QVariant();
+    switch (section) {
+    case NameColumn: return QString("Deck Name");
+    case NewColumn: return QString("New");
+    case DueColumn: return QString("Due");
+    case ReviewColumn: return QString("Review");
+    }
+    return QVariant();
+}
+
+bool DeckTableModel::sameContents(const DataBase::DeckOverview& a, const DataBase::DeckOverview& b) {
+    return a.list_name == b.list_name
+        && a.new_count == b.new_count
+        && a.continuing_count == b.continuing_count
+        && a.review_count == b.review_count
+        && a.total_count == b.total_count
+        && a.next_review_date == b.next_review_date;
+}
+
+void DeckTableModel::setDecks(const QVector<DataBase::DeckOverview>& decks) {
+    QSet<int> wanted;
+    for (const auto &d : decks) wanted.insert(d.list_id);
+
+    // 1. Drop decks that are gone, one contiguous block at a time (from the bottom so rows keep their index)
+    for (int row = rows.size() - 1; row >= 0; --row) {
+        if (wanted.contains(rows.at(row).list_id)) continue;
+        int last = row;
+        while (row > 0 && !wanted.contains(rows.at(row - 1).list_id)) --row;
+        beginRemoveRows(QModelIndex(), row, last);
+        rows.erase(rows.begin() + row, rows.begin() + last + 1);
+        endRemoveRows();
+    }
+
+    // 2. Walk the new order: rows already in place are only compared, others are moved up or inserted
+    for (int i = 0; i < decks.size(); ++i) {
+        const DataBase::DeckOverview &d = decks.at(i);
+        if (i < rows.size() && rows.at(i).list_id == d.list_id) {
+            if (!sameContents(rows.at(i), d)) {
+                rows[i] = d;
+                emit dataChanged(index(i, 0), index(i, ColumnCount - 1));
+            }
+            continue;
+        }
+
+        int from = -1;
+        for (int j = i + 1; j < rows.size(); ++j) {
+            if (rows.at(j).list_id == d.list_id) {
+                from = j;
+                break;
+            }
+        }
+
+        if (from >= 0) {
+            beginMoveRows(QModelIndex(), from, from, QModelIndex(), i);
+            DataBase::DeckOverview moved = rows.at(from);
+            rows.remove(from);
+            rows.insert(i, moved);
+            endMoveRows();
+            if (!sameContents(rows.at(i), d)) {
+                rows[i] = d;
+                emit dataChanged(index(i, 0), index(i, ColumnCount - 1));
+            }
+        } else {
+            beginInsertRows(QModelIndex(), i, i);
+            rows.insert(i, d);
+            endInsertRows();
+        }
+    }
+}
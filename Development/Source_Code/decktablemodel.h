@@ -0,0 +1,35 @@
+#ifndef DECKTABLEMODEL_H
+#define DECKTABLEMODEL_H
+
+#include <QAbstractTableModel>
+#include <QVector>
+#include "database.h"
+
+// Table model over the deck overview. setDecks() diffs the new snapshot against the current
+// rows by list_id and only emits removals, moves, insertions and dataChanged for rows that
+// differ, so views keep their selection and scroll position across refreshes.
+class DeckTableModel : public QAbstractTableModel
+{
+    Q_OBJECT
+
+public:
+    enum Column { NameColumn, NewColumn, DueColumn, ReviewColumn, ColumnCount };
+    static constexpr int ListIdRole = Qt::UserRole;
+
+    explicit DeckTableModel(QObject *parent = nullptr);
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+
+    void setDecks(const QVector<DataBase::DeckOverview>& decks);
+    const QVector<DataBase::DeckOverview>& decks() const { return rows; }
+
+private:
+    static bool sameContents(const DataBase::DeckOverview& a, const DataBase::DeckOverview& b);
+
+    QVector<DataBase::DeckOverview> rows;
+};
+
+#endif // DECKTABLEMODEL_H
@@ -0,0 +1,184 @@
+#include "diagnosticsdialog.h"
+#include "metrics.h"
+#include "querycache.h"
+#include "sqlprofiler.h"
+#include "stallwatchdog.h"
+#include <QApplication>
+#include <QClipboard>
+#include <QFile>
+#include <QFileDialog>
+#include <QHBoxLayout>
+#include <QHeaderView>
+#include <QMessageBox>
+#include <QPushButton>
+#include <QTabWidget>
+#include <QVBoxLayout>
+
+namespace {
+// Statements listed on the SQL tab
+const size_t kTopStatements = 50;
+
+QTableWidgetItem* numberItem(double value, int decimals) {
+    QTableWidgetItem* item = new QTableWidgetItem(QString::number(value, 'f', decimals));
+    item->setTextAlignment(Qt::AlignRight | Qt::AlignVCenter);
+    return item;
+}
+}
+
+DiagnosticsDialog::DiagnosticsDialog(const StallWatchdog* watchdog, QWidget *parent)
+    : QDialog(parent)
+    , watchdog(watchdog) {
+    setWindowTitle("Diagnostics");
+
+    QVBoxLayout* layout = new QVBoxLayout(this);
+    QTabWidget* tabs = new QTabWidget(this);
+    table = new QTableWidget(this);
+    table->setColumnCount(7);
+    table->setHorizontalHeaderLabels({"Metric", "Count", "Errors", "p50 ms", "p90 ms", "p99 ms", "Max ms"});
+    table->horizontalHeader()->setSectionResizeMode(0, QHeaderView::Stretch);
+    table->verticalHeader()->setVisible(false);
+    table->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    table->setSortingEnabled(true);
+    tabs->addTab(table, "Operations");
+
+    statementTable = new QTableWidget(this);
+    statementTable->setColumnCount(8);
+    statementTable->setHorizontalHeaderLabels({"Fingerprint", "Count", "Total ms", "Mean ms", "Max ms", "Rows", "VM steps", "Statement"});
+    statementTable->horizontalHeader()->setSectionResizeMode(7, QHeaderView::Stretch);
+    statementTable->verticalHeader()->setVisible(false);
+    statementTable->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    statementTable->setSortingEnabled(true);
+    tabs->addTab(statementTable, "SQL statements");
+
+    stallTable = new QTableWidget(this);
+    stallTable->setColumnCount(3);
+    stallTable->setHorizontalHeaderLabels({"Started", "Duration ms", "Open spans"});
+    stallTable->horizontalHeader()->setSectionResizeMode(2, QHeaderView::Stretch);
+    stallTable->verticalHeader()->setVisible(false);
+    stallTable->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    if (watchdog) tabs->addTab(stallTable, "UI stalls");
+    layout->addWidget(tabs);
+
+    QHBoxLayout* buttons = new QHBoxLayout();
+    QPushButton* refreshBtn = new QPushButton("Refresh", this);
+    QPushButton* copyBtn = new QPushButton("Copy Prometheus", this);
+    QPushButton* saveBtn = new QPushButton("Save Dump...", this);
+    QPushButton* closeBtn = new QPushButton("Close", this);
+    buttons->addWidget(refreshBtn);
+    buttons->addWidget(copyBtn);
+    buttons->addWidget(saveBtn);
+    buttons->addStretch();
+    buttons->addWidget(closeBtn);
+    layout->addLayout(buttons);
+
+    connect(refreshBtn, &QPushButton::clicked, this, &DiagnosticsDialog::refresh);
+    connect(copyBtn, &QPushButton::clicked, this, &DiagnosticsDialog::copyPrometheus);
+    connect(saveBtn, &QPushButton::clicked, this, &DiagnosticsDialog::saveDump);
+    connect(closeBtn, &QPushButton::clicked, this, &QDialog::accept);
+
+    resize(760, 480);
+    refresh();
+}
+
+void DiagnosticsDialog::refresh() {
+    table->setSortingEnabled(false);
+    table->setRowCount(0);
+
+    const MetricsRegistry &registry = MetricsRegistry::instance();
+    for (const auto &p : registry.histogramSnapshots()) {
+        const auto &s = p.second;
+        int row = table->rowCount();
+        table->insertRow(row);
+        table->setItem(row, 0, new QTableWidgetItem(QString::fromStdString(p.first)));
+        table->setItem(row, 1, numberItem(static_cast<double>(s.count), 0));
+        table->setItem(row, 2, numberItem(static_cast<double>(s.errors), 0));
+        table->setItem(row, 3, numberItem(s.quantile(0.5) / 1000.0, 3));
+        table->setItem(row, 4, numberItem(s.quantile(0.9) / 1000.0, 3));
+        table->setItem(row, 5, numberItem(s.quantile(0.99) / 1000.0, 3));
+        table->setItem(row, 6, numberItem(static_cast<double>(s.maxMicros) / 1000.0, 3));
+    }
+    for (const auto &p : registry.counterValues()) {
+        int row = table->rowCount();
+        table->insertRow(row);
+        table->setItem(row, 0, new QTableWidgetItem(QString::fromStdString(p.first)));
+        table->setItem(row, 1, numberItem(static_cast<double>(p.second), 0));
+    }
+
+    // Hit rate and footprint of the query result cache, shown in the Count column
+    QueryCache::Stats cache = QueryCache::instance().stats();
+    uint64_t lookups = cache.hits + cache.misses;
+    const std::pair<const char*, double> cacheRows[] = {
+        {"db.cache.hit_rate_pct", lookups ? 100.0 * static_cast<double>(cache.hits) / static_cast<double>(lookups) : 0.0},
+        {"db.cache.entries", static_cast<double>(cache.entries)},
+        {"db.cache.kib", static_cast<double>(cache.bytes) / 1024.0},
+    };
+    for (const auto &p : cacheRows) {
+        int row = table->rowCount();
+        table->insertRow(row);
+        table->setItem(row, 0, new QTableWidgetItem(p.first));
+        table->setItem(row, 1, numberItem(p.second, 1));
+    }
+
+    table->setSortingEnabled(true);
+    refreshStatements();
+    refreshStalls();
+}
+
+void DiagnosticsDialog::refreshStalls() {
+    stallTable->setRowCount(0);
+    if (!watchdog) return;
+
+    // Newest first; the stack sample is in the tooltip of the spans column
+    const auto stalls = watchdog->recentStalls();
+    for (auto it = stalls.rbegin(); it != stalls.rend(); ++it) {
+        int row = stallTable->rowCount();
+        stallTable->insertRow(row);
+        QTableWidgetItem* spans = new QTableWidgetItem(it->spans.join(" > "));
+        spans->setToolTip(it->stack.isEmpty() ? "No stack sample" : it->stack.join("\n"));
+        stallTable->setItem(row, 0, new QTableWidgetItem(it->started.toString("HH:mm:ss.zzz")));
+        stallTable->setItem(row, 1, numberItem(static_cast<double>(it->durationMs), 0));
+        stallTable->setItem(row, 2, spans);
+    }
+}
+
+void DiagnosticsDialog::refreshStatements() {
+    statementTable->setSortingEnabled(false);
+    statementTable->setRowCount(0);
+
+    for (const auto &s : SqlProfiler::instance().topStatements(kTopStatements)) {
+        int row = statementTable->rowCount();
+        statementTable->insertRow(row);
+        QTableWidgetItem* sqlItem = new QTableWidgetItem(QString::fromStdString(s.normalizedSql));
+        sqlItem->setToolTip(QString::fromStdString(s.normalizedSql));
+        statementTable->setItem(row, 0, new QTableWidgetItem(QString::fromStdString(s.fingerprint)));
+        statementTable->setItem(row, 1, numberItem(static_cast<double>(s.count), 0));
+        statementTable->setItem(row, 2, numberItem(s.totalNs / 1e6, 3));
+        statementTable->setItem(row, 3, numberItem(s.count ? s.totalNs / 1e6 / s.count : 0.0, 3));
+        statementTable->setItem(row, 4, numberItem(s.maxNs / 1e6, 3));
+        statementTable->setItem(row, 5, numberItem(static_cast<double>(s.rows), 0));
+        statementTable->setItem(row, 6, numberItem(static_cast<double>(s.vmSteps), 0));
+        statementTable->setItem(row, 7, sqlItem);
+    }
+
+    statementTable->setSortingEnabled(true);
+}
+
+void DiagnosticsDialog::copyPrometheus() {
+    QApplication::clipboard()->setText(QString::fromStdString(MetricsRegistry::instance().toPrometheus()));
+}
+
+void DiagnosticsDialog::saveDump() {
+    QString path = QFileDialog::getSaveFileName(this, "Save metrics", "metrics.json",
+                                                "JSON (*.json);;Prometheus text (*.prom *.txt)");
+    if (path.isEmpty()) return;
+
+    const MetricsRegistry &registry = MetricsRegistry::instance();
+    std::string dump = path.endsWith(".json", Qt::CaseInsensitive) ? registry.toJson() : registry.toPrometheus();
+
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        QMessageBox::warning(this, "Save metrics", "Cannot write " + path + ": " + file.errorString());
+        return;
+    }
+    file.write(dump.data(), static_cast<qint64>(dump.size()));
+}
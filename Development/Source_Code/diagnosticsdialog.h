@@ -0,0 +1,34 @@
+#ifndef DIAGNOSTICSDIALOG_H
+#define DIAGNOSTICSDIALOG_H
+
+#include <QDialog>
+#include <QTableWidget>
+
+class StallWatchdog;
+
+// Hidden diagnostics view (Ctrl+Shift+D) over MetricsRegistry: latency percentiles per operation,
+// counters, the most expensive SQL statements from SqlProfiler, recent UI stalls, and export of
+// the whole registry as Prometheus text or JSON.
+class DiagnosticsDialog : public QDialog
+{
+    Q_OBJECT
+
+public:
+    explicit DiagnosticsDialog(const StallWatchdog* watchdog = nullptr, QWidget *parent = nullptr);
+
+private slots:
+    void refresh();
+    void copyPrometheus();
+    void saveDump();
+
+private:
+    void refreshStatements();
+    void refreshStalls();
+
+    const StallWatchdog* watchdog;
+    QTableWidget* table;
+    QTableWidget* statementTable;
+    QTableWidget* stallTable;
+};
+
+#endif // DIAGNOSTICSDIALOG_H
@@ -0,0 +1,23 @@
+#include "dialogopentimer.h"
+#include "metrics.h"
+#include <QDialog>
+#include <QEvent>
+
+DialogOpenTimer::DialogOpenTimer(const std::string& name, QObject *parent)
+    : QObject(parent)
+    , histogram(MetricsRegistry::instance().histogram("ui.dialog.open." + name)) {
+    timer.start();
+}
+
+void DialogOpenTimer::watch(QDialog* dialog) {
+    dialog->installEventFilter(this);
+}
+
+bool DialogOpenTimer::eventFilter(QObject *watched, QEvent *event) {
+    if (!recorded && event->type() == QEvent::Paint) {
+        recorded = true;
+        histogram.record(static_cast<uint64_t>(timer.nsecsElapsed() / 1000));
+        watched->removeEventFilter(this);
+    }
+    return QObject::eventFilter(watched, event);
+}
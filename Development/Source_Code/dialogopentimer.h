@@ -0,0 +1,31 @@
+#ifndef DIALOGOPENTIMER_H
+#define DIALOGOPENTIMER_H
+
+#include <QObject>
+#include <QElapsedTimer>
+#include <string>
+
+class QDialog;
+class LatencyHistogram;
+
+// Measures how long a dialog takes to open: from construction of the timer (just before the
+// dialog is built) to the dialog's first paint, recorded in the "ui.dialog.open.<name>" histogram.
+class DialogOpenTimer : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit DialogOpenTimer(const std::string& name, QObject *parent = nullptr);
+
+    void watch(QDialog* dialog);
+
+protected:
+    bool eventFilter(QObject *watched, QEvent *event) override;
+
+private:
+    LatencyHistogram& histogram;
+    QElapsedTimer timer;
+    bool recorded = false;
+};
+
+#endif // DIALOGOPENTIMER_H
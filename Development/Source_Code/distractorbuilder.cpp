@@ -0,0 +1,115 @@
+#include "distractorbuilder.h"
+#include "tracing.h"
+#include <QDebug>
+#include <algorithm>
+#include <set>
+#include <unordered_map>
+#include <stdexcept>
+
+DistractorBuilder::DistractorBuilder(const std::string& dbPath, QObject *parent)
+    : QObject(parent)
+    , dbPath(dbPath) {
+
+}
+
+DistractorBuilder::~DistractorBuilder() {
+}
+
+DataBase* DistractorBuilder::connection() {
+    // Opened lazily so the connection is created on the worker thread that uses it
+    if (!db) {
+        db = std::make_unique<DataBase>(dbPath);
+    }
+    return db.get();
+}
+
+void DistractorBuilder::refreshAllLists() {
+    TRACE_SCOPE_CAT("worker", "DistractorBuilder::refreshAllLists");
+    try {
+        std::vector<int> listIDs = connection()->getVocabListIds();
+
+        // Forget lists that no longer exist
+        std::set<int> live(listIDs.begin(), listIDs.end());
+        for (auto it = indexes.begin(); it != indexes.end(); ) {
+            if (live.count(it->first) == 0) it = indexes.erase(it);
+            else ++it;
+        }
+
+        for (int listID : listIDs) {
+            refreshList(listID);
+        }
+    } catch (const std::exception& ex) {
+        qCritical() << "Distractor refresh failed:" << ex.what();
+    }
+}
+
+void DistractorBuilder::refreshList(int listID) {
+    TRACE_SCOPE_CAT("worker", "DistractorBuilder::refreshList");
+    if (listID < 0) return;
+
+    try {
+        DataBase* conn = connection();
+        // Taken before reading the words, so a word added meanwhile makes the next refresh run again
+        DataBase::ListWordsStamp stamp = conn->getListWordsStamp(listID);
+        DataBase::ListWordsStamp stored;
+        // The stored rows were built from exactly these words (e.g. on every launch after the first)
+        if (conn->getDistractorStamp(listID, stored) && stored == stamp) return;
+
+        auto words = conn->getWordsInList(listID);
+
+        auto emplaced = indexes.emplace(listID, DistractorIndex(TOP_K));
+        DistractorIndex &index = emplaced.first->second;
+        bool rebuilt = emplaced.second;
+
+        std::set<int> changed;
+        std::set<int> current;
+        for (const auto &t : words) {
+            int wid = std::get<0>(t);
+            current.insert(wid);
+            if (index.contains(wid)) continue;
+            for (int id : index.addWord(wid, std::get<1>(t), std::get<2>(t))) changed.insert(id);
+        }
+
+        for (int wid : index.wordIds()) {
+            if (current.count(wid) > 0) continue;
+            for (int id : index.removeWord(wid)) changed.insert(id);
+            // An entry without neighbours just clears the removed word's rows
+            changed.insert(wid);
+        }
+
+        // A freshly built index sees every word as new; compare with the stored rows instead
+        // so only words whose neighbours actually moved are rewritten
+        std::unordered_map<int, std::vector<int>> storedIds;
+        if (rebuilt) {
+            storedIds = conn->getStoredDistractorIds(listID);
+            for (const auto &s : storedIds) {
+                if (current.count(s.first) == 0) changed.insert(s.first);
+            }
+        }
+
+        std::vector<DataBase::DistractorEntry> entries;
+        entries.reserve(changed.size());
+        for (int wid : changed) {
+            DataBase::DistractorEntry entry;
+            entry.word_id = wid;
+            std::vector<int> ids;
+            for (const auto &n : index.neighbours(wid)) {
+                entry.distractors.emplace_back(n.word_id, n.score);
+                ids.push_back(n.word_id);
+            }
+            if (rebuilt) {
+                auto s = storedIds.find(wid);
+                if (s == storedIds.end() ? ids.empty() : s->second == ids) continue;
+            }
+            entries.push_back(std::move(entry));
+        }
+
+        // Also records the new stamp when no row had to change
+        conn->replaceDistractors(listID, entries, stamp);
+        if (!entries.empty()) emit listRefreshed(listID, static_cast<int>(entries.size()));
+    } catch (const std::exception& ex) {
+        // Drop the cached index so the next refresh rebuilds it from the table contents
+        indexes.erase(listID);
+        qCritical() << "Distractor refresh failed for list" << listID << ":" << ex.what();
+    }
+}
@@ -0,0 +1,42 @@
+#ifndef DISTRACTORBUILDER_H
+#define DISTRACTORBUILDER_H
+
+#include <QObject>
+#include <map>
+#include <memory>
+#include <string>
+#include "database.h"
+#include "distractorindex.h"
+
+// Background job that keeps the word_distractors table up to date.
+// Lives on its own QThread with its own DataBase connection, so building the
+// similarity index never blocks the UI. Lists whose words are unchanged since their rows were
+// built (per distractor_sources) are skipped. Otherwise each list keeps an in-memory
+// DistractorIndex; refreshing a list only indexes words that are new (or gone) since the last
+// refresh and only rewrites rows whose top-K actually changed.
+class DistractorBuilder : public QObject
+{
+    Q_OBJECT
+
+public:
+    static constexpr int TOP_K = 8;
+
+    explicit DistractorBuilder(const std::string& dbPath, QObject *parent = nullptr);
+    ~DistractorBuilder();
+
+public slots:
+    void refreshList(int listID);
+    void refreshAllLists();
+
+signals:
+    void listRefreshed(int listID, int updatedWords);
+
+private:
+    DataBase* connection();
+
+    std::string dbPath;
+    std::unique_ptr<DataBase> db;
+    std::map<int, DistractorIndex> indexes;
+};
+
+#endif // DISTRACTORBUILDER_H
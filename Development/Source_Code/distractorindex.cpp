@@ -0,0 +1,205 @@
+#include "distractorindex.h"
+#include <algorithm>
+#include <cctype>
+
+namespace {
+// Trigrams shared by more words than this (e.g. " th" in definitions) carry almost no signal
+// and would make every lookup linear in the list size, so they are not used for scoring.
+const size_t kMaxPostingLength = 4096;
+
+const uint32_t kWordSalt = 0x9e3779b9u;
+const uint32_t kDefinitionSalt = 0x85ebca6bu;
+
+// Weight of the definition similarity vs the word similarity in the final score
+const double kDefinitionWeight = 0.6;
+
+size_t countShared(const std::vector<uint32_t>& a, const std::vector<uint32_t>& b) {
+    size_t shared = 0;
+    auto ia = a.begin();
+    auto ib = b.begin();
+    while (ia != a.end() && ib != b.end()) {
+        if (*ia < *ib) ++ia;
+        else if (*ib < *ia) ++ib;
+        else { ++shared; ++ia; ++ib; }
+    }
+    return shared;
+}
+
+double dice(size_t shared, size_t sizeA, size_t sizeB) {
+    if (sizeA + sizeB == 0) return 0.0;
+    return (2.0 * static_cast<double>(shared)) / static_cast<double>(sizeA + sizeB);
+}
+}
+
+DistractorIndex::DistractorIndex(size_t topK)
+    : topK(topK) {
+
+}
+
+std::string DistractorIndex::normalize(const std::string& text) {
+    std::string out;
+    out.reserve(text.size() + 2);
+    out.push_back(' ');
+    bool lastSpace = true;
+    for (unsigned char ch : text) {
+        if (std::isspace(ch) || std::ispunct(ch)) {
+            if (!lastSpace) out.push_back(' ');
+            lastSpace = true;
+        } else {
+            out.push_back(static_cast<char>(std::tolower(ch)));
+            lastSpace = false;
+        }
+    }
+    if (!lastSpace) out.push_back(' ');
+    return out;
+}
+
+std::vector<uint32_t> DistractorIndex::trigrams(const std::string& normalized, uint32_t salt) {
+    std::vector<uint32_t> grams;
+    if (normalized.size() < 3) return grams;
+    grams.reserve(normalized.size() - 2);
+    for (size_t i = 0; i + 2 < normalized.size(); ++i) {
+        // FNV-1a over the three bytes, seeded with the salt so word and definition grams never collide
+        uint32_t h = 2166136261u ^ salt;
+        for (size_t j = 0; j < 3; ++j) {
+            h ^= static_cast<unsigned char>(normalized[i + j]);
+            h *= 16777619u;
+        }
+        grams.push_back(h);
+    }
+    std::sort(grams.begin(), grams.end());
+    grams.erase(std::unique(grams.begin(), grams.end()), grams.end());
+    return grams;
+}
+
+std::unordered_map<int, double> DistractorIndex::scoreCandidates(int wordID, const Entry& self) const {
+    std::unordered_map<int, double> scores;
+
+    // Collect candidates through the inverted index, then score them exactly
+    auto collect = [&](const std::vector<uint32_t>& grams) {
+        for (uint32_t g : grams) {
+            auto it = postings.find(g);
+            if (it == postings.end() || it->second.size() > kMaxPostingLength) continue;
+            for (int other : it->second) {
+                if (other != wordID) scores.emplace(other, 0.0);
+            }
+        }
+    };
+    collect(self.wordGrams);
+    collect(self.definitionGrams);
+
+    for (auto it = scores.begin(); it != scores.end(); ) {
+        const Entry& other = entries.at(it->first);
+        // A distractor with the same definition as the answer would make the question ambiguous
+        if (!self.normalizedDefinition.empty() && other.normalizedDefinition == self.normalizedDefinition) {
+            it = scores.erase(it);
+            continue;
+        }
+        double wordScore = dice(countShared(self.wordGrams, other.wordGrams), self.wordGrams.size(), other.wordGrams.size());
+        double defScore = dice(countShared(self.definitionGrams, other.definitionGrams), self.definitionGrams.size(), other.definitionGrams.size());
+        it->second = (1.0 - kDefinitionWeight) * wordScore + kDefinitionWeight * defScore;
+        ++it;
+    }
+    return scores;
+}
+
+void DistractorIndex::recomputeTop(int wordID, Entry& entry) {
+    entry.top.clear();
+    auto scores = scoreCandidates(wordID, entry);
+    for (const auto &p : scores) {
+        offerNeighbour(entry, p.first, p.second);
+    }
+}
+
+bool DistractorIndex::offerNeighbour(Entry& entry, int candidateID, double score) {
+    auto &top = entry.top;
+    for (auto &n : top) {
+        if (n.word_id == candidateID) {
+            if (n.score == score) return false;
+            n.score = score;
+            std::sort(top.begin(), top.end(), [](const Neighbour& a, const Neighbour& b) { return a.score > b.score; });
+            return true;
+        }
+    }
+
+    if (top.size() >= topK && score <= top.back().score) return false;
+
+    auto pos = std::upper_bound(top.begin(), top.end(), score, [](double s, const Neighbour& n) { return s > n.score; });
+    top.insert(pos, Neighbour{candidateID, score});
+    if (top.size() > topK) top.pop_back();
+    return true;
+}
+
+std::vector<int> DistractorIndex::addWord(int wordID, const std::string& word, const std::string& definition) {
+    std::vector<int> changed;
+    if (contains(wordID)) {
+        changed = removeWord(wordID);
+    }
+
+    Entry entry;
+    entry.normalizedDefinition = normalize(definition);
+    entry.wordGrams = trigrams(normalize(word), kWordSalt);
+    entry.definitionGrams = trigrams(entry.normalizedDefinition, kDefinitionSalt);
+    if (entry.normalizedDefinition == " ") entry.normalizedDefinition.clear();
+
+    auto scores = scoreCandidates(wordID, entry);
+    for (const auto &p : scores) {
+        offerNeighbour(entry, p.first, p.second);
+        // The new word may displace the weakest neighbour of existing words
+        if (offerNeighbour(entries.at(p.first), wordID, p.second)) {
+            changed.push_back(p.first);
+        }
+    }
+
+    for (uint32_t g : entry.wordGrams) postings[g].push_back(wordID);
+    for (uint32_t g : entry.definitionGrams) postings[g].push_back(wordID);
+    entries.emplace(wordID, std::move(entry));
+    changed.push_back(wordID);
+
+    std::sort(changed.begin(), changed.end());
+    changed.erase(std::unique(changed.begin(), changed.end()), changed.end());
+    return changed;
+}
+
+std::vector<int> DistractorIndex::removeWord(int wordID) {
+    std::vector<int> changed;
+    auto it = entries.find(wordID);
+    if (it == entries.end()) return changed;
+
+    auto unlink = [&](const std::vector<uint32_t>& grams) {
+        for (uint32_t g : grams) {
+            auto pit = postings.find(g);
+            if (pit == postings.end()) continue;
+            auto &ids = pit->second;
+            ids.erase(std::remove(ids.begin(), ids.end(), wordID), ids.end());
+            if (ids.empty()) postings.erase(pit);
+        }
+    };
+    unlink(it->second.wordGrams);
+    unlink(it->second.definitionGrams);
+    entries.erase(it);
+
+    // Only words that listed the removed word as a neighbour need a new top-K
+    for (auto &p : entries) {
+        const auto &top = p.second.top;
+        bool referenced = std::any_of(top.begin(), top.end(), [wordID](const Neighbour& n) { return n.word_id == wordID; });
+        if (referenced) {
+            recomputeTop(p.first, p.second);
+            changed.push_back(p.first);
+        }
+    }
+    return changed;
+}
+
+std::vector<int> DistractorIndex::wordIds() const {
+    std::vector<int> ids;
+    ids.reserve(entries.size());
+    for (const auto &p : entries) ids.push_back(p.first);
+    return ids;
+}
+
+const std::vector<DistractorIndex::Neighbour>& DistractorIndex::neighbours(int wordID) const {
+    static const std::vector<Neighbour> empty;
+    auto it = entries.find(wordID);
+    return it == entries.end() ? empty : it->second.top;
+}
@@ -0,0 +1,59 @@
+#ifndef DISTRACTORINDEX_H
+#define DISTRACTORINDEX_H
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// In-memory similarity index used to pick confusable distractors for multiple-choice cards.
+// Words are compared with character trigrams: the word text gives the orthographic similarity
+// and the definition text gives a cheap stand-in for semantic similarity. Candidates are found
+// through an inverted index (trigram -> words), so adding a word only touches words that share
+// at least one trigram with it.
+class DistractorIndex
+{
+public:
+    struct Neighbour {
+        int word_id;
+        double score;
+    };
+
+    explicit DistractorIndex(size_t topK = 8);
+
+    // Adds a word (or replaces it if the id is already known).
+    // Returns the ids of every word whose top-K neighbour list changed, including the new word.
+    std::vector<int> addWord(int wordID, const std::string& word, const std::string& definition);
+
+    // Removes a word. Returns the ids of the words whose top-K neighbour list changed.
+    std::vector<int> removeWord(int wordID);
+
+    bool contains(int wordID) const { return entries.count(wordID) > 0; }
+    size_t size() const { return entries.size(); }
+    std::vector<int> wordIds() const;
+
+    // Neighbours sorted by descending score (at most topK entries)
+    const std::vector<Neighbour>& neighbours(int wordID) const;
+
+private:
+    struct Entry {
+        std::vector<uint32_t> wordGrams;        // sorted, unique
+        std::vector<uint32_t> definitionGrams;  // sorted, unique
+        std::string normalizedDefinition;
+        std::vector<Neighbour> top;
+    };
+
+    static std::string normalize(const std::string& text);
+    static std::vector<uint32_t> trigrams(const std::string& normalized, uint32_t salt);
+
+    // Scores every word sharing a trigram with `self` (excluding itself)
+    std::unordered_map<int, double> scoreCandidates(int wordID, const Entry& self) const;
+    void recomputeTop(int wordID, Entry& entry);
+    bool offerNeighbour(Entry& entry, int candidateID, double score);
+
+    size_t topK;
+    std::unordered_map<int, Entry> entries;
+    std::unordered_map<uint32_t, std::vector<int>> postings;
+};
+
+#endif // DISTRACTORINDEX_H
@@ -0,0 +1,315 @@
+#include "enrichmentjob.h"
+#include "aistreamparser.h"
+#include "aivocabgenerator.h"
+#include <QNetworkRequest>
+#include <QJsonDocument>
+#include <QJsonArray>
+#include <QRandomGenerator>
+#include <QTimer>
+#include <QSet>
+#include <QDebug>
+#include "metrics.h"
+
+namespace {
+const int kMaxTokens = 3000;
+const double kTemperature = 0.7;
+const int kExamplesPerWord = 2;
+
+QString systemPrompt() {
+    return "You are a helpful assistant that outputs JSON only."
+           " For each vocabulary word you are given, write short example sentences and list closely related words."
+           " Answer with a JSON array of objects like"
+           " {\"id\": 1, \"examples\": [{\"text\": \"...\", \"context\": \"...\"}], \"relations\": [{\"word\": \"...\", \"type\": \"synonym\"}]}."
+           " The relation type must be one of synonym, antonym, related, derived_from.";
+}
+
+// Extracts the assistant text from a non-streamed chat-completions body
+QString completionText(const QByteArray& body) {
+    QJsonArray choices = QJsonDocument::fromJson(body).object().value("choices").toArray();
+    if (choices.isEmpty()) return QString();
+    return choices.at(0).toObject().value("message").toObject().value("content").toString();
+}
+}
+
+EnrichmentJob::EnrichmentJob(const std::string& dbPath, QObject *parent)
+    : QObject(parent)
+    , dbPath(dbPath)
+    , manager(new QNetworkAccessManager(this))
+    , endpoint(AIVocabGenerator::defaultEndpoint()) {
+
+}
+
+EnrichmentJob::~EnrichmentJob() {
+    stop();
+}
+
+DataBase* EnrichmentJob::connection() {
+    // Opened lazily so the connection is created on the worker thread that uses it
+    if (!db) {
+        db = std::make_unique<DataBase>(dbPath);
+    }
+    return db.get();
+}
+
+void EnrichmentJob::start() {
+    stop();
+
+    runId++;
+    running = true;
+    exhausted = false;
+    pendingRetries = 0;
+    nextSequence = 0;
+    nextToCheckpoint = 0;
+    finishedBatches.clear();
+
+    checkpointWordID = 0;
+    processed = 0;
+    try {
+        connection()->getEnrichmentCheckpoint(JOB_NAME, checkpointWordID, processed);
+        total = processed + connection()->countWordsMissingEnrichment(checkpointWordID);
+    } catch (const std::exception &e) {
+        fail(QString::fromStdString(e.what()));
+        return;
+    }
+    fetchCursor = checkpointWordID;
+
+    qInfo() << "Enrichment job starting after word" << checkpointWordID << "(" << processed << "of" << total << "done)";
+    emit progress(processed, total);
+    launchPending();
+}
+
+void EnrichmentJob::stop() {
+    runId++;
+    pending.clear();
+    pendingRetries = 0;
+    std::map<QNetworkReply*, Batch> replies;
+    replies.swap(inFlight);
+    for (auto &p : replies) {
+        p.first->disconnect(this);
+        p.first->abort();
+        p.first->deleteLater();
+    }
+    running = false;
+}
+
+bool EnrichmentJob::fetchNextBatch() {
+    if (exhausted) return false;
+
+    std::vector<DataBase::EnrichmentCandidate> words = connection()->getWordsMissingEnrichment(fetchCursor, batchSize);
+    if (words.empty()) {
+        exhausted = true;
+        return false;
+    }
+
+    Batch batch;
+    batch.sequence = nextSequence++;
+    batch.lastWordID = words.back().word_id;
+    batch.words = std::move(words);
+    fetchCursor = batch.lastWordID;
+    pending.push_back(std::move(batch));
+    return true;
+}
+
+void EnrichmentJob::launchPending() {
+    try {
+        while (running && static_cast<int>(inFlight.size()) < maxConcurrent) {
+            if (pending.empty() && !fetchNextBatch()) break;
+            Batch batch = std::move(pending.front());
+            pending.pop_front();
+            launch(batch);
+        }
+    } catch (const std::exception &e) {
+        fail(QString::fromStdString(e.what()));
+        return;
+    }
+    checkCompletion();
+}
+
+QJsonObject EnrichmentJob::buildBody(const Batch& batch) const {
+    QJsonArray words;
+    for (const auto &w : batch.words) {
+        QJsonArray need;
+        if (w.needs_examples) need.append("examples");
+        if (w.needs_relations) need.append("relations");
+
+        QJsonObject o;
+        o["id"] = w.word_id;
+        o["word"] = QString::fromStdString(w.word);
+        o["definition"] = QString::fromStdString(w.definition);
+        o["need"] = need;
+        words.append(o);
+    }
+
+    QJsonArray messages;
+    QJsonObject systemMsg;
+    systemMsg["role"] = "system";
+    systemMsg["content"] = systemPrompt();
+    messages.append(systemMsg);
+
+    QJsonObject userMsg;
+    userMsg["role"] = "user";
+    userMsg["content"] = QString("Give %1 example sentences per word where \"examples\" is needed, and up to 5 relations "
+                                 "where \"relations\" is needed. Keep each id unchanged.\n%2")
+                         .arg(kExamplesPerWord)
+                         .arg(QString::fromUtf8(QJsonDocument(words).toJson(QJsonDocument::Compact)));
+    messages.append(userMsg);
+
+    QJsonObject body;
+    body["model"] = model;
+    body["messages"] = messages;
+    body["max_tokens"] = kMaxTokens;
+    body["temperature"] = kTemperature;
+    return body;
+}
+
+void EnrichmentJob::launch(const Batch& batch) {
+    QNetworkRequest netRequest(endpoint);
+    netRequest.setRawHeader("Authorization", QString("Bearer %1").arg(apiKey).toUtf8());
+    netRequest.setHeader(QNetworkRequest::ContentTypeHeader, "application/json");
+
+    QByteArray payload = QJsonDocument(buildBody(batch)).toJson(QJsonDocument::Compact);
+    QNetworkReply* reply = manager->post(netRequest, payload);
+
+    Batch state = batch;
+    state.attempts++;
+    state.sent.start();
+    inFlight.emplace(reply, std::move(state));
+
+    connect(reply, &QNetworkReply::finished, this, &EnrichmentJob::onReplyFinished);
+}
+
+std::vector<DataBase::EnrichmentResult> EnrichmentJob::parseResults(const Batch& batch, const QByteArray& body) const {
+    std::map<int, const DataBase::EnrichmentCandidate*> byId;
+    for (const auto &w : batch.words) byId[w.word_id] = &w;
+
+    std::vector<DataBase::EnrichmentResult> results;
+    QSet<int> seen;
+    JsonObjectStreamExtractor extractor;
+    for (const QJsonObject &o : extractor.feed(completionText(body))) {
+        int id = o.value("id").toInt(-1);
+        auto it = byId.find(id);
+        // Ignore ids the model made up and anything answered twice
+        if (it == byId.end() || seen.contains(id)) continue;
+        seen.insert(id);
+
+        DataBase::EnrichmentResult r;
+        r.word_id = id;
+        if (it->second->needs_examples) {
+            for (const QJsonValue &v : o.value("examples").toArray()) {
+                QString text = v.toObject().value("text").toString().trimmed();
+                if (text.isEmpty()) continue;
+                r.examples.emplace_back(text.toStdString(), v.toObject().value("context").toString().trimmed().toStdString());
+            }
+        }
+        if (it->second->needs_relations) {
+            for (const QJsonValue &v : o.value("relations").toArray()) {
+                QString word = v.toObject().value("word").toString().trimmed();
+                if (word.isEmpty()) continue;
+                r.relations.emplace_back(word.toStdString(), v.toObject().value("type").toString().trimmed().toLower().toStdString());
+            }
+        }
+        results.push_back(std::move(r));
+    }
+    return results;
+}
+
+void EnrichmentJob::onReplyFinished() {
+    QNetworkReply* reply = qobject_cast<QNetworkReply*>(sender());
+    auto it = inFlight.find(reply);
+    if (it == inFlight.end()) return;
+    reply->deleteLater();
+
+    Batch batch = std::move(it->second);
+    inFlight.erase(it);
+
+    static LatencyHistogram& requestLatency = MetricsRegistry::instance().histogram("ai.enrich.request");
+    requestLatency.record(static_cast<uint64_t>(batch.sent.nsecsElapsed() / 1000));
+    if (reply->error() != QNetworkReply::NoError) requestLatency.recordError();
+
+    int status = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+    if (reply->error() != QNetworkReply::NoError) {
+        QString error = reply->errorString();
+        qWarning() << "Enrichment batch" << batch.sequence << "failed (attempt" << batch.attempts << "):" << error;
+        // Client errors other than rate limiting (e.g. a bad key) will fail for every batch
+        if (status == 0 || status == 429 || status >= 500) {
+            retryOrFail(batch, error, reply->rawHeader("Retry-After").toInt() * 1000);
+        } else {
+            fail(error);
+        }
+        return;
+    }
+
+    std::vector<DataBase::EnrichmentResult> results = parseResults(batch, reply->readAll());
+    if (results.empty()) {
+        retryOrFail(batch, "Could not parse the model output as a JSON array.", 0);
+        return;
+    }
+
+    try {
+        connection()->addEnrichmentBatch(results);
+    } catch (const std::exception &e) {
+        fail(QString::fromStdString(e.what()));
+        return;
+    }
+
+    completeBatch(batch);
+    launchPending();
+}
+
+void EnrichmentJob::retryOrFail(Batch batch, const QString& error, int retryAfterMs) {
+    if (batch.attempts > maxRetries) {
+        // Stop here so the checkpoint stays before this batch and a later run tries it again
+        fail(error);
+        return;
+    }
+
+    static Counter& retries = MetricsRegistry::instance().counter("ai.enrich.retries");
+    retries.add();
+
+    int backoff = baseBackoffMs * (1 << (batch.attempts - 1));
+    backoff += static_cast<int>(QRandomGenerator::global()->bounded(baseBackoffMs + 1));
+    backoff = qMax(backoff, retryAfterMs);
+
+    pendingRetries++;
+    int run = runId;
+    QTimer::singleShot(backoff, this, [this, batch, run]() {
+        if (run != runId) return; // stopped or restarted meanwhile
+        pendingRetries--;
+        pending.push_front(batch);
+        launchPending();
+    });
+}
+
+void EnrichmentJob::completeBatch(const Batch& batch) {
+    finishedBatches[batch.sequence] = std::make_pair(batch.lastWordID, static_cast<int>(batch.words.size()));
+
+    bool advanced = false;
+    for (auto it = finishedBatches.find(nextToCheckpoint); it != finishedBatches.end(); it = finishedBatches.find(nextToCheckpoint)) {
+        checkpointWordID = it->second.first;
+        processed += it->second.second;
+        finishedBatches.erase(it);
+        nextToCheckpoint++;
+        advanced = true;
+    }
+    if (!advanced) return;
+
+    try {
+        connection()->saveEnrichmentCheckpoint(JOB_NAME, checkpointWordID, processed);
+    } catch (const std::exception &e) {
+        qWarning() << "Failed to save enrichment checkpoint:" << e.what();
+    }
+    emit progress(processed, total);
+}
+
+void EnrichmentJob::fail(const QString& error) {
+    stop();
+    emit finished(false, error);
+}
+
+void EnrichmentJob::checkCompletion() {
+    if (!running || !exhausted || !pending.empty() || !inFlight.empty() || pendingRetries > 0) return;
+
+    running = false;
+    qInfo() << "Enrichment job finished:" << processed << "words processed";
+    emit finished(true, QString());
+}
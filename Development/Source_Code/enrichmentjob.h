@@ -0,0 +1,108 @@
+#ifndef ENRICHMENTJOB_H
+#define ENRICHMENTJOB_H
+
+#include <QObject>
+#include <QNetworkAccessManager>
+#include <QNetworkReply>
+#include <QJsonObject>
+#include <QUrl>
+#include <QElapsedTimer>
+#include <deque>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+#include "database.h"
+
+// Fills in word_examples and word_relations for words that are missing either, asking the model
+// about batchSize words per request with at most maxConcurrent requests in flight.
+// Progress is checkpointed in enrichment_progress after every contiguous run of finished
+// batches, so an interrupted run continues from the last checkpoint on the next start().
+// Lives on its own QThread with its own DataBase connection, so neither the candidate queries
+// nor the result writes run on the UI thread.
+class EnrichmentJob : public QObject
+{
+    Q_OBJECT
+
+public:
+    static constexpr int DEFAULT_BATCH_SIZE = 20;
+    static constexpr int DEFAULT_MAX_CONCURRENT = 3;
+    static constexpr int DEFAULT_MAX_RETRIES = 3;
+    static constexpr const char* JOB_NAME = "examples_relations";
+
+    explicit EnrichmentJob(const std::string& dbPath, QObject *parent = nullptr);
+    ~EnrichmentJob();
+
+    void setEndpoint(const QUrl& url) { endpoint = url; }
+    void setApiKey(const QString& key) { apiKey = key; }
+    void setModel(const QString& name) { model = name; }
+    void setBatchSize(int size) { batchSize = qMax(1, size); }
+    void setMaxConcurrentRequests(int limit) { maxConcurrent = qMax(1, limit); }
+    void setMaxRetries(int retries) { maxRetries = qMax(0, retries); }
+
+    bool isRunning() const { return running; }
+
+public slots:
+    void start();
+    // Stops after abandoning the requests in flight; the checkpoint is kept
+    void stop();
+
+signals:
+    void progress(long long processed, long long total);
+    void finished(bool success, const QString& errorMessage);
+
+private slots:
+    void onReplyFinished();
+
+private:
+    DataBase* connection();
+
+    struct Batch {
+        int sequence = 0;
+        int lastWordID = 0;
+        int attempts = 0;
+        QElapsedTimer sent;
+        std::vector<DataBase::EnrichmentCandidate> words;
+    };
+
+    QJsonObject buildBody(const Batch& batch) const;
+    std::vector<DataBase::EnrichmentResult> parseResults(const Batch& batch, const QByteArray& body) const;
+    bool fetchNextBatch();
+    void launchPending();
+    void launch(const Batch& batch);
+    void retryOrFail(Batch batch, const QString& error, int retryAfterMs);
+    void completeBatch(const Batch& batch);
+    void fail(const QString& error);
+    void checkCompletion();
+
+    std::string dbPath;
+    std::unique_ptr<DataBase> db;
+    QNetworkAccessManager* manager;
+    QUrl endpoint;
+    QString apiKey;
+    QString model = "gpt-4o-mini";
+    int batchSize = DEFAULT_BATCH_SIZE;
+    int maxConcurrent = DEFAULT_MAX_CONCURRENT;
+    int maxRetries = DEFAULT_MAX_RETRIES;
+    int baseBackoffMs = 500;
+
+    bool running = false;
+    bool exhausted = false;
+    int runId = 0;
+    int pendingRetries = 0;
+    int fetchCursor = 0;
+    int nextSequence = 0;
+
+    // Checkpoint state: batches finish out of order, so the saved position only
+    // advances over the contiguous prefix of finished sequences
+    int nextToCheckpoint = 0;
+    std::map<int, std::pair<int, int>> finishedBatches;  // sequence -> (lastWordID, word count)
+    int checkpointWordID = 0;
+    long long processed = 0;
+    long long total = 0;
+
+    std::deque<Batch> pending;
+    std::map<QNetworkReply*, Batch> inFlight;
+};
+
+#endif // ENRICHMENTJOB_H
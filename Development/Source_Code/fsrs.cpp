@@ -0,0 +1,69 @@
+#include "fsrs.h"
+#include <algorithm>
+#include <cstdio>
+#include <sstream>
+
+namespace Fsrs {
+
+const Params& defaultParams() {
+    static const Params params = {0.4872, 1.4003, 3.7145, 13.8206, 5.1618, 1.2298, 0.8975, 0.031, 1.6474,
+                                  0.1367, 1.0461, 2.1072, 0.0793, 0.3246, 1.587, 0.2272, 2.8755};
+    return params;
+}
+
+const Params& lowerBounds() {
+    static const Params bounds = {0.1, 0.1, 0.1, 0.1, 1.0, 0.1, 0.1, 0.0, 0.0,
+                                  0.0, 0.01, 0.1, 0.01, 0.01, 0.01, 0.0, 1.0};
+    return bounds;
+}
+
+const Params& upperBounds() {
+    static const Params bounds = {100.0, 100.0, 100.0, 100.0, 10.0, 5.0, 5.0, 0.75, 4.5,
+                                  0.8, 3.5, 5.0, 0.25, 0.9, 4.0, 1.0, 6.0};
+    return bounds;
+}
+
+std::string formatParams(const Params& params) {
+    std::string out;
+    char buf[32];
+    for (int i = 0; i < PARAM_COUNT; ++i) {
+        std::snprintf(buf, sizeof(buf), i ? " %.6g" : "%.6g", params[i]);
+        out += buf;
+    }
+    return out;
+}
+
+bool parseParams(const std::string& text, Params& params) {
+    std::istringstream in(text);
+    Params parsed;
+    for (int i = 0; i < PARAM_COUNT; ++i) {
+        if (!(in >> parsed[i])) return false;
+        parsed[i] = std::max(lowerBounds()[i], std::min(upperBounds()[i], parsed[i]));
+    }
+    params = parsed;
+    return true;
+}
+
+Scheduler::Scheduler(const Params& params, double desiredRetention)
+    : model(params)
+    , desiredRetention(std::max(0.7, std::min(0.97, desiredRetention))) {
+}
+
+MemoryState Scheduler::nextState(const MemoryState& current, double elapsedDays, int rating) const {
+    rating = std::max(1, std::min(4, rating));
+    if (current.valid() && elapsedDays < 1.0) return current;
+
+    MemoryState next = current;
+    if (next.valid()) {
+        next.difficulty = std::max(MIN_DIFFICULTY, std::min(MAX_DIFFICULTY, next.difficulty));
+    }
+    model.review(next.stability, next.difficulty, !current.valid(), elapsedDays, rating);
+    return next;
+}
+
+int Scheduler::nextIntervalDays(double stability) const {
+    double days = stability / FACTOR * (std::pow(desiredRetention, 1.0 / DECAY) - 1.0);
+    return std::max(1, std::min(MAX_INTERVAL_DAYS, static_cast<int>(std::lround(days))));
+}
+
+}
@@ -0,0 +1,143 @@
+#ifndef FSRS_H
+#define FSRS_H
+
+#include <array>
+#include <cmath>
+#include <string>
+
+// FSRS (Free Spaced Repetition Scheduler, v4.5 formulas). A card's memory is a stability S, the
+// number of days until the recall probability falls to 90%, and a difficulty D in [1, 10].
+// Ratings are 1 = again, 2 = hard, 3 = good, 4 = easy. The 17 weights are fitted to the
+// review history by Fsrs::Optimizer (fsrsoptimizer.h); the defaults are the published FSRS-4.5 ones.
+//
+// The formulas are templates over the number type so the optimizer can evaluate them on dual
+// numbers and get exact gradients with respect to every weight.
+namespace Fsrs {
+
+constexpr int PARAM_COUNT = 17;
+using Params = std::array<double, PARAM_COUNT>;
+
+constexpr double DECAY = -0.5;
+constexpr double FACTOR = 19.0 / 81.0;     // makes R(S, S) = 0.9
+constexpr double MIN_STABILITY = 0.01;
+constexpr double MIN_DIFFICULTY = 1.0;
+constexpr double MAX_DIFFICULTY = 10.0;
+constexpr int MAX_INTERVAL_DAYS = 36500;
+
+const Params& defaultParams();
+// Ranges the optimizer keeps each weight in
+const Params& lowerBounds();
+const Params& upperBounds();
+
+// The study panel records SM-2 qualities 0..5: below 3 is a lapse, then hard, good, easy
+inline int ratingFromQuality(int quality) {
+    return quality < 3 ? 1 : (quality > 5 ? 4 : quality - 1);
+}
+
+std::string formatParams(const Params& params);
+bool parseParams(const std::string& text, Params& params);
+
+struct MemoryState {
+    double stability = 0.0;
+    double difficulty = 0.0;
+    bool valid() const { return stability > 0.0; }
+};
+
+// The math below works for double and for the optimizer's dual numbers. exp/log/pow resolve to
+// std:: for double and to the dual overloads otherwise; clamps compare plain values.
+inline double valueOf(double x) { return x; }
+
+template <typename T>
+T clampValue(const T& x, double lo, double hi) {
+    if (valueOf(x) < lo) return T(lo);
+    if (valueOf(x) > hi) return T(hi);
+    return x;
+}
+
+template <typename T>
+T retrievability(double elapsedDays, const T& stability) {
+    using std::pow;
+    return pow(1.0 + FACTOR * elapsedDays / stability, DECAY);
+}
+
+// The weights plus the terms that depend on them alone, computed once per evaluation
+template <typename T>
+struct Model {
+    std::array<T, PARAM_COUNT> w;
+    T expW8;            // exp(w8), scales stability growth
+    T meanDifficulty;   // initial difficulty of a "good", the target of mean reversion
+
+    explicit Model(const std::array<T, PARAM_COUNT>& weights)
+        : w(weights) {
+        using std::exp;
+        expW8 = exp(w[8]);
+        meanDifficulty = initDifficulty(3);
+    }
+
+    T initStability(int rating) const {
+        return clampValue<T>(w[rating - 1], MIN_STABILITY, 1e9);
+    }
+
+    T initDifficulty(int rating) const {
+        return clampValue<T>(w[4] - w[5] * static_cast<double>(rating - 3), MIN_DIFFICULTY, MAX_DIFFICULTY);
+    }
+
+    T nextDifficulty(const T& difficulty, int rating) const {
+        T moved = difficulty - w[6] * static_cast<double>(rating - 3);
+        return clampValue<T>(w[7] * meanDifficulty + (1.0 - w[7]) * moved, MIN_DIFFICULTY, MAX_DIFFICULTY);
+    }
+
+    T recallStability(const T& difficulty, const T& stability, const T& r, int rating) const {
+        using std::exp;
+        using std::log;
+        T growth = expW8 * (11.0 - difficulty) * exp(-w[9] * log(stability)) * (exp(w[10] * (1.0 - r)) - 1.0);
+        if (rating == 2) growth = growth * w[15];
+        if (rating == 4) growth = growth * w[16];
+        return stability * (growth + 1.0);
+    }
+
+    T forgetStability(const T& difficulty, const T& stability, const T& r) const {
+        using std::exp;
+        using std::log;
+        // w11 * D^-w12 * ((S + 1)^w13 - 1) * e^(w14 * (1 - R)), with the powers folded into exp/log
+        T scale = w[11] * exp(w[14] * (1.0 - r) - w[12] * log(difficulty));
+        T next = scale * (exp(w[13] * log(stability + 1.0)) - 1.0);
+        // A lapse never makes the memory stronger
+        return valueOf(next) < valueOf(stability) ? next : stability;
+    }
+
+    // State after a review; stability and difficulty of the first review come from the rating alone
+    void review(T& stability, T& difficulty, bool first, double elapsedDays, int rating) const {
+        if (first) {
+            stability = initStability(rating);
+            difficulty = initDifficulty(rating);
+            return;
+        }
+        T r = retrievability(elapsedDays, stability);
+        T nextS = rating == 1 ? forgetStability(difficulty, stability, r) : recallStability(difficulty, stability, r, rating);
+        difficulty = nextDifficulty(difficulty, rating);
+        stability = clampValue<T>(nextS, MIN_STABILITY, 1e9);
+    }
+};
+
+// Schedules single cards with fitted weights
+class Scheduler
+{
+public:
+    explicit Scheduler(const Params& params = defaultParams(), double desiredRetention = 0.9);
+
+    // Reviews less than a day apart do not change the state (the optimizer skips them too)
+    MemoryState nextState(const MemoryState& current, double elapsedDays, int rating) const;
+    // Days until recall probability falls to the desired retention
+    int nextIntervalDays(double stability) const;
+
+    const Params& params() const { return model.w; }
+
+private:
+    Model<double> model;
+    double desiredRetention;
+};
+
+}
+
+#endif // FSRS_H
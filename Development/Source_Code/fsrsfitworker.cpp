@@ -0,0 +1,85 @@
+#include "fsrsfitworker.h"
+#include "fsrs.h"
+#include "fsrsoptimizer.h"
+#include "tracing.h"
+#include <QDebug>
+#include <stdexcept>
+
+FsrsFitWorker::FsrsFitWorker(const std::string& dbPath, QObject *parent)
+    : QObject(parent)
+    , dbPath(dbPath) {
+
+}
+
+FsrsFitWorker::~FsrsFitWorker() {
+}
+
+DataBase* FsrsFitWorker::connection() {
+    // Opened lazily so the connection is created on the worker thread that uses it
+    if (!db) {
+        db = std::make_unique<DataBase>(dbPath);
+    }
+    return db.get();
+}
+
+void FsrsFitWorker::fit(bool force) {
+    TRACE_SCOPE_CAT("worker", "FsrsFitWorker::fit");
+    try {
+        DataBase* conn = connection();
+        long long reviews = conn->countReviewLogs();
+
+        DataBase::SchedulerParams saved;
+        bool haveSaved = conn->getSchedulerParams("fsrs", saved);
+        if (!force && haveSaved
+            && (saved.secondsSinceFit < MIN_SECONDS_BETWEEN_FITS || reviews - saved.reviewCount < MIN_NEW_REVIEWS)) {
+            return;
+        }
+        if (reviews < MIN_REVIEWS) {
+            if (force) emit fitFinished(false, QString("Only %1 reviews logged; at least %2 are needed").arg(reviews).arg(MIN_REVIEWS));
+            return;
+        }
+
+        // Elapsed time is counted in whole days, as the scheduler sees it
+        Fsrs::Optimizer::History history;
+        history.elapsedDays.reserve(static_cast<size_t>(reviews));
+        history.ratings.reserve(static_cast<size_t>(reviews));
+        int currentWord = -1;
+        long long previousReview = 0;
+        conn->forEachReviewLog([&](int wordID, long long reviewedAt, int confidence) {
+            if (wordID != currentWord) {
+                history.beginCard(wordID);
+                currentWord = wordID;
+                previousReview = reviewedAt;
+            }
+            history.add(static_cast<float>((reviewedAt - previousReview) / 86400), Fsrs::ratingFromQuality(confidence));
+            previousReview = reviewedAt;
+        });
+        history.finish();
+
+        // Start from the last fit so a refit only has to follow the new reviews
+        Fsrs::Params start = Fsrs::defaultParams();
+        if (haveSaved) Fsrs::parseParams(saved.params, start);
+
+        Fsrs::Optimizer::Result result = Fsrs::Optimizer::fit(history, start, Fsrs::Optimizer::Options());
+        if (result.predictions == 0) {
+            if (force) emit fitFinished(false, "No card has been reviewed on two different days yet");
+            return;
+        }
+        conn->saveSchedulerParams("fsrs", Fsrs::formatParams(result.params), reviews, result.finalLoss);
+
+        std::vector<Fsrs::MemoryState> states = Fsrs::Optimizer::replay(history, result.params);
+        std::vector<DataBase::MemoryStateUpdate> updates;
+        updates.reserve(states.size());
+        for (size_t c = 0; c < states.size(); ++c) {
+            if (states[c].valid()) updates.push_back({history.wordIds[c], states[c].stability, states[c].difficulty});
+        }
+        conn->updateMemoryStates(updates);
+
+        emit fitFinished(true, QString("Scheduler fitted to %1 reviews in %2 ms (log loss %3 -> %4)")
+                                   .arg(reviews).arg(result.elapsedMs)
+                                   .arg(result.initialLoss, 0, 'f', 4).arg(result.finalLoss, 0, 'f', 4));
+    } catch (const std::exception& ex) {
+        qCritical() << "Fitting the FSRS scheduler failed:" << ex.what();
+        emit fitFinished(false, QString::fromStdString(ex.what()));
+    }
+}
@@ -0,0 +1,43 @@
+#ifndef FSRSFITWORKER_H
+#define FSRSFITWORKER_H
+
+#include <QObject>
+#include <QString>
+#include <memory>
+#include <string>
+#include "database.h"
+
+// Refits the FSRS weights to the whole study_sessions history and stores them in scheduler_params,
+// then replays every card with the new weights to refresh the stored stability and difficulty.
+// Lives on its own QThread with its own DataBase connection; the optimizer itself spreads the
+// gradient over all cores.
+class FsrsFitWorker : public QObject
+{
+    Q_OBJECT
+
+public:
+    // An unforced fit runs at most this often...
+    static constexpr long long MIN_SECONDS_BETWEEN_FITS = 20 * 60 * 60;
+    // ...and only once this many reviews were logged since the last one
+    static constexpr long long MIN_NEW_REVIEWS = 50;
+    // Fewer reviews than this cannot move 17 weights anywhere useful
+    static constexpr long long MIN_REVIEWS = 100;
+
+    explicit FsrsFitWorker(const std::string& dbPath, QObject *parent = nullptr);
+    ~FsrsFitWorker();
+
+public slots:
+    // force: fit now even if the last fit is recent (the history still has to be large enough)
+    void fit(bool force);
+
+signals:
+    void fitFinished(bool fitted, const QString& summary);
+
+private:
+    DataBase* connection();
+
+    std::string dbPath;
+    std::unique_ptr<DataBase> db;
+};
+
+#endif // FSRSFITWORKER_H
@@ -0,0 +1,169 @@
+// The dual-number loops are only vectorized at -O3 (about 3x faster than -O2); the rest of the
+// application keeps the default level
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC optimize("O3")
+#endif
+
+#include "fsrsoptimizer.h"
+#include <algorithm>
+#include <chrono>
+#include <thread>
+
+namespace Fsrs {
+
+namespace {
+// Predicted recall probabilities are kept away from 0 and 1 so one surprise cannot dominate the loss
+const double kMinProbability = 1e-4;
+// Adam moments
+const double kBeta1 = 0.9;
+const double kBeta2 = 0.999;
+const double kEpsilon = 1e-8;
+// Below this many cards per thread the threads cost more than they save
+const size_t kMinCardsPerThread = 2048;
+
+template <typename T>
+T clampProbability(const T& p) {
+    return clampValue<T>(p, kMinProbability, 1.0 - kMinProbability);
+}
+}
+
+void Optimizer::History::beginCard(int wordID) {
+    cardStart.push_back(static_cast<uint32_t>(ratings.size()));
+    wordIds.push_back(wordID);
+}
+
+void Optimizer::History::add(float elapsed, int rating) {
+    elapsedDays.push_back(elapsed);
+    ratings.push_back(static_cast<uint8_t>(std::max(1, std::min(4, rating))));
+}
+
+void Optimizer::History::finish() {
+    // Sentinel so every card's range is [cardStart[c], cardStart[c + 1])
+    if (cardStart.size() == wordIds.size()) cardStart.push_back(static_cast<uint32_t>(ratings.size()));
+}
+
+template <typename T>
+void Optimizer::accumulateCards(const History& history, const Model<T>& model, size_t firstCard, size_t lastCard,
+                                T& lossSum, size_t& predictions) {
+    using std::log;
+    for (size_t c = firstCard; c < lastCard; ++c) {
+        T stability(0.0), difficulty(0.0);
+        bool first = true;
+        for (uint32_t i = history.cardStart[c]; i < history.cardStart[c + 1]; ++i) {
+            double elapsed = history.elapsedDays[i];
+            int rating = history.ratings[i];
+            // Same-day repeats say little about long-term memory; skip them as the scheduler does
+            if (!first && elapsed < 1.0) continue;
+            if (!first) {
+                T p = clampProbability(retrievability(elapsed, stability));
+                lossSum = lossSum - (rating > 1 ? log(p) : log(1.0 - p));
+                predictions++;
+            }
+            model.review(stability, difficulty, first, elapsed, rating);
+            first = false;
+        }
+    }
+}
+
+Optimizer::Partial Optimizer::evaluate(const History& history, const Params& params, int threads) {
+    std::array<Grad, PARAM_COUNT> w;
+    for (int i = 0; i < PARAM_COUNT; ++i) w[i] = Grad::variable(params[i], i);
+    const Model<Grad> model(w);
+
+    size_t cards = history.cardCount();
+    size_t workers = std::max<size_t>(1, std::min<size_t>(static_cast<size_t>(threads), cards / kMinCardsPerThread));
+    std::vector<Partial> partials(workers);
+    auto run = [&](size_t k) {
+        size_t first = cards * k / workers;
+        size_t last = cards * (k + 1) / workers;
+        accumulateCards(history, model, first, last, partials[k].loss, partials[k].predictions);
+    };
+
+    std::vector<std::thread> pool;
+    for (size_t k = 1; k < workers; ++k) pool.emplace_back(run, k);
+    run(0);
+    for (std::thread &t : pool) t.join();
+
+    Partial total = partials[0];
+    for (size_t k = 1; k < workers; ++k) {
+        total.loss = total.loss + partials[k].loss;
+        total.predictions += partials[k].predictions;
+    }
+    return total;
+}
+
+double Optimizer::loss(const History& history, const Params& params, size_t* predictions) {
+    double sum = 0.0;
+    size_t count = 0;
+    accumulateCards(history, Model<double>(params), 0, history.cardCount(), sum, count);
+    if (predictions) *predictions = count;
+    return count ? sum / static_cast<double>(count) : 0.0;
+}
+
+Optimizer::Result Optimizer::fit(const History& history, const Params& start, const Options& options) {
+    auto started = std::chrono::steady_clock::now();
+    int threads = options.threads > 0 ? options.threads : static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+
+    Result result;
+    result.params = start;
+    for (int i = 0; i < PARAM_COUNT; ++i) {
+        result.params[i] = std::max(lowerBounds()[i], std::min(upperBounds()[i], result.params[i]));
+    }
+
+    Params m{}, v{};
+    Params best = result.params;
+    double bestLoss = 0.0;
+    for (int step = 1; step <= options.iterations; ++step) {
+        Partial eval = evaluate(history, result.params, threads);
+        if (eval.predictions == 0) break;
+        double n = static_cast<double>(eval.predictions);
+        double loss = eval.loss.v / n;
+        if (step == 1) {
+            result.initialLoss = loss;
+            result.predictions = eval.predictions;
+            bestLoss = loss;
+        }
+        // Adam takes noisy steps near the optimum; keep the best weights seen
+        if (loss <= bestLoss) {
+            bestLoss = loss;
+            best = result.params;
+        }
+
+        double b1 = 1.0 - std::pow(kBeta1, step);
+        double b2 = 1.0 - std::pow(kBeta2, step);
+        for (int i = 0; i < PARAM_COUNT; ++i) {
+            double g = eval.loss.d[i] / n;
+            m[i] = kBeta1 * m[i] + (1.0 - kBeta1) * g;
+            v[i] = kBeta2 * v[i] + (1.0 - kBeta2) * g * g;
+            double stepSize = options.learningRate * (m[i] / b1) / (std::sqrt(v[i] / b2) + kEpsilon);
+            result.params[i] = std::max(lowerBounds()[i], std::min(upperBounds()[i], result.params[i] - stepSize));
+        }
+        result.iterations = step;
+    }
+
+    double finalLoss = loss(history, result.params);
+    if (result.iterations > 0 && finalLoss > bestLoss) {
+        result.params = best;
+        finalLoss = bestLoss;
+    }
+    result.finalLoss = result.iterations > 0 ? finalLoss : 0.0;
+    result.elapsedMs = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - started).count();
+    return result;
+}
+
+std::vector<MemoryState> Optimizer::replay(const History& history, const Params& params) {
+    const Model<double> model(params);
+    std::vector<MemoryState> states(history.cardCount());
+    for (size_t c = 0; c < history.cardCount(); ++c) {
+        MemoryState &s = states[c];
+        bool first = true;
+        for (uint32_t i = history.cardStart[c]; i < history.cardStart[c + 1]; ++i) {
+            if (!first && history.elapsedDays[i] < 1.0f) continue;
+            model.review(s.stability, s.difficulty, first, history.elapsedDays[i], history.ratings[i]);
+            first = false;
+        }
+    }
+    return states;
+}
+
+}
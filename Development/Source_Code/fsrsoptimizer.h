@@ -0,0 +1,140 @@
+#ifndef FSRSOPTIMIZER_H
+#define FSRSOPTIMIZER_H
+
+#include "fsrs.h"
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+namespace Fsrs {
+
+// Forward-mode dual number: a value and its partial derivatives with respect to all N weights.
+// Every operation is a fixed-length loop over plain doubles, which the compiler vectorizes.
+template <int N>
+struct Dual {
+    double v = 0.0;
+    std::array<double, N> d{};
+
+    Dual() = default;
+    Dual(double value) : v(value) {}
+
+    static Dual variable(double value, int index) {
+        Dual x(value);
+        x.d[index] = 1.0;
+        return x;
+    }
+
+    // f(x) given f(v) and f'(v)
+    Dual chain(double f, double df) const {
+        Dual r(f);
+        for (int i = 0; i < N; ++i) r.d[i] = df * d[i];
+        return r;
+    }
+};
+
+template <int N> double valueOf(const Dual<N>& x) { return x.v; }
+
+template <int N> Dual<N> operator+(const Dual<N>& a, const Dual<N>& b) {
+    Dual<N> r(a.v + b.v);
+    for (int i = 0; i < N; ++i) r.d[i] = a.d[i] + b.d[i];
+    return r;
+}
+template <int N> Dual<N> operator-(const Dual<N>& a, const Dual<N>& b) {
+    Dual<N> r(a.v - b.v);
+    for (int i = 0; i < N; ++i) r.d[i] = a.d[i] - b.d[i];
+    return r;
+}
+template <int N> Dual<N> operator*(const Dual<N>& a, const Dual<N>& b) {
+    Dual<N> r(a.v * b.v);
+    for (int i = 0; i < N; ++i) r.d[i] = a.d[i] * b.v + b.d[i] * a.v;
+    return r;
+}
+template <int N> Dual<N> operator/(const Dual<N>& a, const Dual<N>& b) {
+    Dual<N> r(a.v / b.v);
+    double inv = 1.0 / (b.v * b.v);
+    for (int i = 0; i < N; ++i) r.d[i] = (a.d[i] * b.v - b.d[i] * a.v) * inv;
+    return r;
+}
+template <int N> Dual<N> operator-(const Dual<N>& a) { return a.chain(-a.v, -1.0); }
+
+template <int N> Dual<N> operator+(const Dual<N>& a, double b) { Dual<N> r = a; r.v += b; return r; }
+template <int N> Dual<N> operator+(double a, const Dual<N>& b) { return b + a; }
+template <int N> Dual<N> operator-(const Dual<N>& a, double b) { Dual<N> r = a; r.v -= b; return r; }
+template <int N> Dual<N> operator-(double a, const Dual<N>& b) { return b.chain(a - b.v, -1.0); }
+template <int N> Dual<N> operator*(const Dual<N>& a, double b) { return a.chain(a.v * b, b); }
+template <int N> Dual<N> operator*(double a, const Dual<N>& b) { return b.chain(a * b.v, a); }
+template <int N> Dual<N> operator/(const Dual<N>& a, double b) { return a.chain(a.v / b, 1.0 / b); }
+template <int N> Dual<N> operator/(double a, const Dual<N>& b) { return b.chain(a / b.v, -a / (b.v * b.v)); }
+
+template <int N> Dual<N> exp(const Dual<N>& x) {
+    double e = std::exp(x.v);
+    return x.chain(e, e);
+}
+template <int N> Dual<N> log(const Dual<N>& x) { return x.chain(std::log(x.v), 1.0 / x.v); }
+template <int N> Dual<N> pow(const Dual<N>& x, double p) {
+    double y = std::pow(x.v, p);
+    return x.chain(y, p * y / x.v);
+}
+
+// Fits the 17 weights to the review history by minimising the log loss of the predicted recall
+// probability at every review after a card's first. The gradient is exact (dual numbers) and
+// evaluated in parallel over disjoint sets of cards; the weights take full-batch Adam steps and
+// are clamped to lowerBounds()/upperBounds() after each step.
+class Optimizer
+{
+public:
+    using Grad = Dual<PARAM_COUNT>;
+
+    // Reviews grouped by card, oldest first
+    struct History {
+        std::vector<float> elapsedDays;     // since the card's previous review, 0 for the first
+        std::vector<uint8_t> ratings;       // 1..4
+        std::vector<uint32_t> cardStart;    // card c owns reviews [cardStart[c], cardStart[c + 1])
+        std::vector<int> wordIds;           // per card
+
+        void beginCard(int wordID);
+        void add(float elapsed, int rating);
+        void finish();
+        size_t cardCount() const { return wordIds.size(); }
+        size_t reviewCount() const { return ratings.size(); }
+    };
+
+    struct Options {
+        int iterations = 80;
+        double learningRate = 0.04;
+        int threads = 0;                    // 0: one per hardware thread
+    };
+
+    struct Result {
+        Params params{};
+        double initialLoss = 0.0;
+        double finalLoss = 0.0;
+        size_t predictions = 0;             // reviews that contributed to the loss
+        int iterations = 0;
+        long long elapsedMs = 0;
+    };
+
+    static Result fit(const History& history, const Params& start, const Options& options);
+
+    // Mean log loss of the weights over the history (value only)
+    static double loss(const History& history, const Params& params, size_t* predictions = nullptr);
+
+    // Memory state of every card after its last review
+    static std::vector<MemoryState> replay(const History& history, const Params& params);
+
+private:
+    struct Partial {
+        Grad loss;
+        size_t predictions = 0;
+    };
+
+    template <typename T>
+    static void accumulateCards(const History& history, const Model<T>& model, size_t firstCard, size_t lastCard,
+                                T& lossSum, size_t& predictions);
+    static Partial evaluate(const History& history, const Params& params, int threads);
+};
+
+}
+
+#endif // FSRSOPTIMIZER_H
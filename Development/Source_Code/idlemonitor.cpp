@@ -0,0 +1,46 @@
+#include "idlemonitor.h"
+#include <QCoreApplication>
+#include <QEvent>
+
+IdleMonitor::IdleMonitor(QObject *parent)
+    : QObject(parent) {
+    sinceInput.start();
+    qApp->installEventFilter(this);
+
+    pollTimer.setInterval(DEFAULT_TICK_INTERVAL_MS);
+    connect(&pollTimer, &QTimer::timeout, this, &IdleMonitor::poll);
+    pollTimer.start();
+}
+
+IdleMonitor::~IdleMonitor() {
+    qApp->removeEventFilter(this);
+}
+
+bool IdleMonitor::eventFilter(QObject *watched, QEvent *event) {
+    switch (event->type()) {
+    case QEvent::KeyPress:
+    case QEvent::MouseButtonPress:
+    case QEvent::MouseMove:
+    case QEvent::Wheel:
+    case QEvent::TouchBegin:
+        sinceInput.restart();
+        if (idle) {
+            idle = false;
+            emit idleEnded();
+        }
+        break;
+    default:
+        break;
+    }
+    return QObject::eventFilter(watched, event);
+}
+
+void IdleMonitor::poll() {
+    if (sinceInput.elapsed() < idleAfterMs) return;
+
+    if (!idle) {
+        idle = true;
+        emit idleStarted();
+    }
+    emit idleTick();
+}
@@ -0,0 +1,43 @@
+#ifndef IDLEMONITOR_H
+#define IDLEMONITOR_H
+
+#include <QObject>
+#include <QElapsedTimer>
+#include <QTimer>
+
+// Watches application-wide user input and reports when the UI has been idle.
+// While idle, idleTick() fires every tickIntervalMs so background housekeeping can run
+// in short slices; any key, mouse or wheel event ends the idle period immediately.
+class IdleMonitor : public QObject
+{
+    Q_OBJECT
+
+public:
+    static constexpr int DEFAULT_IDLE_AFTER_MS = 30000;
+    static constexpr int DEFAULT_TICK_INTERVAL_MS = 2000;
+
+    explicit IdleMonitor(QObject *parent = nullptr);
+    ~IdleMonitor();
+
+    void setIdleAfterMs(int ms) { idleAfterMs = ms; }
+    void setTickIntervalMs(int ms) { pollTimer.setInterval(ms); }
+    bool isIdle() const { return idle; }
+
+signals:
+    void idleStarted();
+    void idleTick();
+    void idleEnded();
+
+protected:
+    bool eventFilter(QObject *watched, QEvent *event) override;
+
+private:
+    void poll();
+
+    QTimer pollTimer;
+    QElapsedTimer sinceInput;
+    int idleAfterMs = DEFAULT_IDLE_AFTER_MS;
+    bool idle = false;
+};
+
+#endif // IDLEMONITOR_H
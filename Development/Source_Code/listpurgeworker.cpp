@@ -0,0 +1,47 @@
+#include "listpurgeworker.h"
+#include "tracing.h"
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QThread>
+#include <stdexcept>
+
+ListPurgeWorker::ListPurgeWorker(const std::string& dbPath, QObject *parent)
+    : QObject(parent)
+    , dbPath(dbPath) {
+
+}
+
+ListPurgeWorker::~ListPurgeWorker() {
+}
+
+DataBase* ListPurgeWorker::connection() {
+    // Opened lazily so the connection is created on the worker thread that uses it
+    if (!db) {
+        db = std::make_unique<DataBase>(dbPath);
+    }
+    return db.get();
+}
+
+void ListPurgeWorker::purgeList(int listID) {
+    TRACE_SCOPE_CAT("worker", "ListPurgeWorker::purgeList");
+    try {
+        DataBase* conn = connection();
+        QElapsedTimer timer;
+        timer.start();
+
+        int total = conn->countListRows(listID);
+        int purged = 0;
+        bool finished = false;
+        while (!finished) {
+            purged += conn->purgeDeletedListBatch(listID, BATCH_SIZE, finished);
+            emit purgeProgress(listID, purged, total);
+            if (!finished) QThread::msleep(PAUSE_BETWEEN_BATCHES_MS);
+        }
+
+        qInfo() << "Purged list" << listID << ":" << purged << "rows in" << timer.elapsed() << "ms";
+        emit listPurged(listID);
+    } catch (const std::exception& ex) {
+        // The list stays marked deleted, so the purge is retried on the next start
+        qCritical() << "Purging list" << listID << "failed:" << ex.what();
+    }
+}
@@ -0,0 +1,39 @@
+#ifndef LISTPURGEWORKER_H
+#define LISTPURGEWORKER_H
+
+#include <QObject>
+#include <memory>
+#include <string>
+#include "database.h"
+
+// Background job that removes the rows of lists marked deleted by DataBase::deleteList.
+// Lives on its own QThread with its own DataBase connection and deletes in batches of
+// BATCH_SIZE rows, each in its own short transaction, so the UI connection never waits
+// on the write lock for long.
+class ListPurgeWorker : public QObject
+{
+    Q_OBJECT
+
+public:
+    static constexpr int BATCH_SIZE = 500;
+    // Pause between batches so a waiting UI write gets the lock
+    static constexpr int PAUSE_BETWEEN_BATCHES_MS = 5;
+
+    explicit ListPurgeWorker(const std::string& dbPath, QObject *parent = nullptr);
+    ~ListPurgeWorker();
+
+public slots:
+    void purgeList(int listID);
+
+signals:
+    void purgeProgress(int listID, int purgedRows, int totalRows);
+    void listPurged(int listID);
+
+private:
+    DataBase* connection();
+
+    std::string dbPath;
+    std::unique_ptr<DataBase> db;
+};
+
+#endif // LISTPURGEWORKER_H
@@ -0,0 +1,48 @@
+#ifndef LOADBALANCER_H
+#define LOADBALANCER_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <vector>
+
+// Spreads reviews of cards learned together over neighbouring days. Every new interval may move
+// within a small window around the one the scheduler asked for (a few percent of it, more for
+// short intervals); the review goes to the day in the window with the fewest cards already due,
+// read from the due_histogram table, so each decision costs O(window).
+namespace Scheduling {
+
+struct FuzzWindow {
+    int minDays;
+    int maxDays;
+    int size() const { return maxDays - minDays + 1; }
+};
+
+// Intervals of two days or less are left alone; beyond that the window shrinks from ±15% to ±5%
+inline FuzzWindow fuzzWindow(int intervalDays, int maxIntervalDays = 36500) {
+    if (intervalDays <= 2) return {intervalDays, intervalDays};
+    double fraction = intervalDays <= 7 ? 0.15 : (intervalDays <= 20 ? 0.10 : 0.05);
+    int delta = std::max(1, static_cast<int>(std::lround(intervalDays * fraction)));
+    return {std::max(1, intervalDays - delta), std::min(maxIntervalDays, intervalDays + delta)};
+}
+
+// dueLoad[i] is the number of cards due minDays + i days from today. Ties go to the day closest to
+// the requested interval, then to the earlier one.
+inline int leastLoadedInterval(int intervalDays, const FuzzWindow& window, const std::vector<int>& dueLoad) {
+    int best = intervalDays;
+    int bestLoad = -1;
+    for (int i = 0; i < window.size() && i < static_cast<int>(dueLoad.size()); ++i) {
+        int day = window.minDays + i;
+        int load = dueLoad[static_cast<size_t>(i)];
+        if (bestLoad < 0 || load < bestLoad
+            || (load == bestLoad && std::abs(day - intervalDays) < std::abs(best - intervalDays))) {
+            best = day;
+            bestLoad = load;
+        }
+    }
+    return best;
+}
+
+}
+
+#endif // LOADBALANCER_H
@@ -1,9 +1,39 @@
 #include "mainwindow.h"
-#include <QApplication>
+#include "tracingapplication.h"
+#include "tracing.h"
+#include "metrics.h"
+#include <QElapsedTimer>
+#include <QTimer>
+#include <cstdio>
 
 int main(int argc, char *argv[]) {
-    QApplication a(argc, argv);
+    QElapsedTimer sinceStart;
+    sinceStart.start();
+
+    TracingApplication a(argc, argv);
+    // VOCAB_TRACE=1 records from the start, so startup shows up in the exported timeline
+    if (qEnvironmentVariableIntValue("VOCAB_TRACE") > 0) Tracer::instance().setEnabled(true);
+    // --startup-benchmark prints the startup milestones and exits once the deck list is usable
+    const bool startupBenchmark = a.arguments().contains("--startup-benchmark");
+
     MainWindow w;
+    qint64 constructedMs = sinceStart.elapsed();
+
+    QObject::connect(&w, &MainWindow::firstPainted, [&]() {
+        static LatencyHistogram& firstPaint = MetricsRegistry::instance().histogram("startup.first_paint");
+        firstPaint.record(static_cast<uint64_t>(sinceStart.nsecsElapsed() / 1000));
+        if (startupBenchmark) std::printf("time_to_first_paint_ms %lld\n", static_cast<long long>(sinceStart.elapsed()));
+    });
+    QObject::connect(&w, &MainWindow::interactive, [&]() {
+        static LatencyHistogram& interactive = MetricsRegistry::instance().histogram("startup.interactive");
+        interactive.record(static_cast<uint64_t>(sinceStart.nsecsElapsed() / 1000));
+        if (!startupBenchmark) return;
+        std::printf("main_window_constructed_ms %lld\n", static_cast<long long>(constructedMs));
+        std::printf("time_to_interactive_ms %lld\n", static_cast<long long>(sinceStart.elapsed()));
+        std::fflush(stdout);
+        QTimer::singleShot(0, &a, &QCoreApplication::quit);
+    });
+
     w.show();
     return a.exec();
 }
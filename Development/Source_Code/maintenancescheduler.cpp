@@ -0,0 +1,89 @@
+#include "maintenancescheduler.h"
+#include "tracing.h"
+#include <QDebug>
+#include <stdexcept>
+
+namespace {
+// Statistics first so the vacuum and checkpoint that follow do not delay them
+const DataBase::MaintenanceTask kTasks[] = {
+    DataBase::MaintenanceTask::Analyze,
+    DataBase::MaintenanceTask::Optimize,
+    DataBase::MaintenanceTask::IncrementalVacuum,
+    DataBase::MaintenanceTask::WalCheckpoint,
+};
+const size_t kTaskCount = sizeof(kTasks) / sizeof(kTasks[0]);
+static_assert(kTaskCount == MaintenanceScheduler::TASK_COUNT, "TASK_COUNT must match kTasks");
+}
+
+MaintenanceScheduler::MaintenanceScheduler(const std::string& dbPath, QObject *parent)
+    : QObject(parent)
+    , dbPath(dbPath) {
+
+}
+
+MaintenanceScheduler::~MaintenanceScheduler() {
+}
+
+DataBase* MaintenanceScheduler::connection() {
+    // Opened lazily so the connection is created on the worker thread that uses it
+    if (!db) {
+        db = std::make_unique<DataBase>(dbPath);
+    }
+    return db.get();
+}
+
+void MaintenanceScheduler::runSlice(int budgetMs) {
+    TRACE_SCOPE_CAT("worker", "MaintenanceScheduler::runSlice");
+    bool anyPending = false;
+    for (bool p : pending) anyPending = anyPending || p;
+    if (!anyPending && sinceIdleCheck.isValid() && sinceIdleCheck.elapsed() < RECHECK_INTERVAL_MS) {
+        emit sliceFinished(0, false);
+        return;
+    }
+
+    int tasksRun = 0;
+    bool workLeft = false;
+    try {
+        DataBase* conn = connection();
+        QElapsedTimer budget;
+        budget.start();
+
+        size_t i = 0;
+        for (; i < kTaskCount && budget.elapsed() < budgetMs; ++i) {
+            size_t index = (nextTask + i) % kTaskCount;
+            DataBase::MaintenanceTask task = kTasks[index];
+            if (!pending[index] && !conn->isMaintenanceDue(task, thresholds)) continue;
+
+            // A task that keeps hitting the deadline without progress (PRAGMA optimize, a single
+            // large table's ANALYZE) restarts from scratch each time, so give it more room
+            int remaining = budgetMs - static_cast<int>(budget.elapsed());
+            int multiplier = qMin(1 << qMin(stalledRuns[index], 3), MAX_BUDGET_MULTIPLIER);
+            int taskBudget = qMax(remaining, multiplier * budgetMs);
+            DataBase::MaintenanceOutcome outcome = conn->runMaintenanceTask(task, thresholds, qMax(1, taskBudget));
+            tasksRun++;
+
+            if (outcome.interrupted) {
+                pending[index] = true;
+                stalledRuns[index] = outcome.progressed ? 0 : stalledRuns[index] + 1;
+                // Rotate: the next slice starts with the task after this one
+                nextTask = (index + 1) % kTaskCount;
+                workLeft = true;
+                break;
+            }
+            pending[index] = false;
+            stalledRuns[index] = 0;
+            nextTask = (index + 1) % kTaskCount;
+        }
+        // Out of budget before every task was checked
+        if (i < kTaskCount) workLeft = true;
+    } catch (const std::exception& ex) {
+        qCritical() << "Database maintenance failed:" << ex.what();
+        for (size_t t = 0; t < kTaskCount; ++t) {
+            pending[t] = false;
+            stalledRuns[t] = 0;
+        }
+    }
+
+    if (!workLeft) sinceIdleCheck.start();
+    emit sliceFinished(tasksRun, workLeft);
+}
@@ -0,0 +1,52 @@
+#ifndef MAINTENANCESCHEDULER_H
+#define MAINTENANCESCHEDULER_H
+
+#include <QObject>
+#include <QElapsedTimer>
+#include <memory>
+#include <string>
+#include "database.h"
+
+// Runs ANALYZE, PRAGMA optimize, incremental vacuum and WAL checkpoints while the UI is idle.
+// Lives on its own QThread with its own DataBase connection. Each runSlice() call checks which
+// tasks are due against the thresholds and runs them in turn until the slice budget is spent.
+// A task that runs out of budget stays pending and the next slice starts with the task after it,
+// so one slow task cannot starve the others. A task interrupted without making any progress gets
+// a doubled budget on its next run, up to MAX_BUDGET_MULTIPLIER times the slice budget.
+class MaintenanceScheduler : public QObject
+{
+    Q_OBJECT
+
+public:
+    // Due checks count rows, so they are not repeated more often than this when nothing is due
+    static constexpr int RECHECK_INTERVAL_MS = 60000;
+    static constexpr int MAX_BUDGET_MULTIPLIER = 8;
+    static constexpr size_t TASK_COUNT = 4;
+
+    explicit MaintenanceScheduler(const std::string& dbPath, QObject *parent = nullptr);
+    ~MaintenanceScheduler();
+
+    // Call before moving the scheduler to its thread
+    void setThresholds(const DataBase::MaintenanceThresholds& value) { thresholds = value; }
+
+public slots:
+    void runSlice(int budgetMs);
+
+signals:
+    void sliceFinished(int tasksRun, bool workLeft);
+
+private:
+    DataBase* connection();
+
+    std::string dbPath;
+    std::unique_ptr<DataBase> db;
+    DataBase::MaintenanceThresholds thresholds;
+    size_t nextTask = 0;
+    // Interrupted tasks skip the due check until they complete
+    bool pending[TASK_COUNT] = {};
+    // Consecutive runs that were interrupted without any progress
+    int stalledRuns[TASK_COUNT] = {};
+    QElapsedTimer sinceIdleCheck;
+};
+
+#endif // MAINTENANCESCHEDULER_H
@@ -4,63 +4,275 @@
 #include "addlistwindow.h"
 #include "aicreatewindow.h"
 #include "themeutils.h"
+#include "diagnosticsdialog.h"
+#include "dialogopentimer.h"
+#include "tracing.h"
+#include "deckoverviewcache.h"
+#include "catchupplanner.h"
 #include <QDialog>
 #include <QVBoxLayout>
 #include <QTextEdit>
 #include <QPushButton>
 #include <QMessageBox>
+#include <QInputDialog>
+#include <QStatusBar>
+#include <QFileDialog>
+#include <QFileInfo>
+#include <QFile>
+#include <QDateTime>
+#include <QEvent>
+#include <QShortcut>
 #include <sstream>
 #include <random>
 #include <algorithm>
+#include <set>
 
 MainWindow::MainWindow(QWidget *parent)
     : QMainWindow(parent)
     , ui(new Ui::MainWindow)
     , db("/home/brometheus/IA_Project/data/example.db")
 {
+    TRACE_SCOPE("MainWindow::MainWindow");
     ui->setupUi(this);
+
+    // Created before the workers open their connections so none of their writes go unreported
+    changeBus = new ChangeBus(this);
     
-    // Create panel widgets
-    deckListPanel = new DeckListPanel(&db, this);
-    modeSelectorPanel = new ModeSelectorPanel(this);
-    studyPanel = new StudyPanel(&db, this);
-    
-    // Add panels to the main layout
+    // Only the deck list is visible at startup; the other panels are created on first use
+    deckListPanel = new DeckListPanel(this);
     ui->deckListContainer->layout()->addWidget(deckListPanel);
-    ui->modeSelectorContainer->layout()->addWidget(modeSelectorPanel);
-    ui->studyPanelContainer->layout()->addWidget(studyPanel);
-    
-    // Connect panel signals
     connect(deckListPanel, &DeckListPanel::deckDoubleClicked, this, &MainWindow::onDeckDoubleClicked);
-    connect(modeSelectorPanel, &ModeSelectorPanel::startStudyClicked, this, &MainWindow::onStartStudy);
-    connect(modeSelectorPanel, &ModeSelectorPanel::viewAllClicked, this, &MainWindow::onViewAll);
-    connect(modeSelectorPanel, &ModeSelectorPanel::deleteListClicked, this, &MainWindow::onDeleteList);
-    connect(studyPanel, &StudyPanel::studyCompleted, this, &MainWindow::onStudyCompleted);
+
+    deckOverviewLoader = new DeckOverviewLoader(db.getPath());
+    deckOverviewLoader->moveToThread(&deckOverviewThread);
+    connect(&deckOverviewThread, &QThread::finished, deckOverviewLoader, &QObject::deleteLater);
+    connect(deckListPanel, &DeckListPanel::reloadRequested, deckOverviewLoader, &DeckOverviewLoader::load);
+    connect(deckOverviewLoader, &DeckOverviewLoader::loaded, deckListPanel, &DeckListPanel::setDeckOverview);
+    connect(deckOverviewLoader, &DeckOverviewLoader::loadFailed, deckListPanel, &DeckListPanel::onLoadFailed);
+    connect(deckOverviewLoader, &DeckOverviewLoader::nextReviewDue, changeBus, &ChangeBus::setNextDue);
+    connect(changeBus, &ChangeBus::changed, this, [this](unsigned tables) {
+        // The first load waits for the first paint; anything written before then is part of it
+        if (!firstPaintSeen || !(tables & (DataBase::ListsTable | DataBase::ScheduleTable))) return;
+        deckListPanel->updateDeckList();
+    });
+    connect(changeBus, &ChangeBus::cardsDue, deckListPanel, &DeckListPanel::updateDeckList);
+    connect(deckListPanel, &DeckListPanel::deckListUpdated, this, [this]() {
+        if (interactiveReported) return;
+        interactiveReported = true;
+        // Reported once the filled-in table has been laid out and painted
+        QTimer::singleShot(0, this, &MainWindow::interactive);
+    });
+    deckOverviewThread.start();
+
+    // Paint last session's deck list right away; the live load after the first paint replaces it
+    QVector<DataBase::DeckOverview> cachedDecks;
+    QDateTime cachedAt;
+    if (DeckOverviewCache::load(DeckOverviewCache::pathFor(db.getPath()), cachedDecks, cachedAt)) {
+        deckListPanel->showCachedOverview(cachedDecks, cachedAt);
+    }
+    QMetaObject::invokeMethod(deckOverviewLoader, []() { Tracer::setThreadName("deck overview"); }, Qt::QueuedConnection);
+
+    // Build the confusable-distractor table off the UI thread
+    distractorBuilder = new DistractorBuilder(db.getPath());
+    distractorBuilder->moveToThread(&distractorThread);
+    connect(&distractorThread, &QThread::finished, distractorBuilder, &QObject::deleteLater);
+    distractorThread.start(QThread::LowPriority);
+    QMetaObject::invokeMethod(distractorBuilder, []() { Tracer::setThreadName("distractors"); }, Qt::QueuedConnection);
+    refreshDistractors();
+
+    // Collect orphaned words in short slices while the user is away
+    orphanCollector = new OrphanCollector(db.getPath());
+    orphanCollector->moveToThread(&maintenanceThread);
+    connect(&maintenanceThread, &QThread::finished, orphanCollector, &QObject::deleteLater);
+    connect(orphanCollector, &OrphanCollector::collected, this, &MainWindow::onOrphansCollected);
+
+    maintenanceScheduler = new MaintenanceScheduler(db.getPath());
+    maintenanceScheduler->moveToThread(&maintenanceThread);
+    connect(&maintenanceThread, &QThread::finished, maintenanceScheduler, &QObject::deleteLater);
+    connect(maintenanceScheduler, &MaintenanceScheduler::sliceFinished, this, [this]() {
+        maintenanceSliceQueued = false;
+    });
+
+    // Deleted lists are hidden at once and purged in batches here
+    listPurgeWorker = new ListPurgeWorker(db.getPath());
+    listPurgeWorker->moveToThread(&maintenanceThread);
+    connect(&maintenanceThread, &QThread::finished, listPurgeWorker, &QObject::deleteLater);
+    connect(listPurgeWorker, &ListPurgeWorker::purgeProgress, this, [this](int, int purged, int total) {
+        statusBar()->showMessage(QString("Removing deleted list: %1 / %2 rows").arg(purged).arg(total));
+    });
+    connect(listPurgeWorker, &ListPurgeWorker::listPurged, this, [this](int) {
+        statusBar()->showMessage("Deleted list removed", 5000);
+        orphanSweepPending = true;
+    });
+    maintenanceThread.start(QThread::LowPriority);
+    QMetaObject::invokeMethod(listPurgeWorker, []() { Tracer::setThreadName("maintenance"); }, Qt::QueuedConnection);
+
+    // Finish purges interrupted by the last shutdown
+    for (int listID : db.getDeletedListIds()) {
+        QMetaObject::invokeMethod(listPurgeWorker, "purgeList", Qt::QueuedConnection, Q_ARG(int, listID));
+    }
+
+    idleMonitor = new IdleMonitor(this);
+    connect(idleMonitor, &IdleMonitor::idleTick, this, &MainWindow::onIdleTick);
+
+    backupWorker = new BackupWorker(db.getPath());
+    backupWorker->moveToThread(&backupThread);
+    connect(&backupThread, &QThread::finished, backupWorker, &QObject::deleteLater);
+    connect(backupWorker, &BackupWorker::backupProgress, this, [this](int percent) {
+        statusBar()->showMessage(QString("Backing up: %1%").arg(percent));
+    });
+    connect(backupWorker, &BackupWorker::backupFinished, this, [this](bool success, const QString& summary) {
+        backupRunning = false;
+        statusBar()->showMessage(success ? summary : "Backup failed: " + summary, 10000);
+    });
+    connect(backupWorker, &BackupWorker::restoreFinished, this, [this](bool success, const QString& message) {
+        if (success) {
+            QMessageBox::information(this, "Restore Backup", message);
+        } else {
+            QMessageBox::critical(this, "Restore Backup", "Restore failed: " + message);
+        }
+    });
+    backupThread.start(QThread::LowPriority);
+    QMetaObject::invokeMethod(backupWorker, []() { Tracer::setThreadName("backup"); }, Qt::QueuedConnection);
+
+    fsrsFitWorker = new FsrsFitWorker(db.getPath());
+    fsrsFitWorker->moveToThread(&fsrsThread);
+    connect(&fsrsThread, &QThread::finished, fsrsFitWorker, &QObject::deleteLater);
+    connect(fsrsFitWorker, &FsrsFitWorker::fitFinished, this, [this](bool, const QString& summary) {
+        fsrsFitRunning = false;
+        statusBar()->showMessage(summary, 10000);
+    });
+    // The worker decides whether a fit is due; an unforced check that finds nothing to do stays silent
+    connect(idleMonitor, &IdleMonitor::idleStarted, this, [this]() {
+        QMetaObject::invokeMethod(fsrsFitWorker, "fit", Qt::QueuedConnection, Q_ARG(bool, false));
+    });
+    fsrsThread.start(QThread::LowPriority);
+    QMetaObject::invokeMethod(fsrsFitWorker, []() { Tracer::setThreadName("fsrs fit"); }, Qt::QueuedConnection);
+
+    backupTimer.setInterval(BACKUP_INTERVAL_MS);
+    connect(&backupTimer, &QTimer::timeout, this, &MainWindow::on_actionBackupNow_triggered);
+    backupTimer.start();
+
+    stallWatchdog = new StallWatchdog(this);
+
+    // Hidden diagnostics view over the metrics registry
+    QShortcut* diagnosticsShortcut = new QShortcut(QKeySequence("Ctrl+Shift+D"), this);
+    connect(diagnosticsShortcut, &QShortcut::activated, this, [this]() {
+        DialogOpenTimer openTimer("diagnostics");
+        DiagnosticsDialog dlg(stallWatchdog, this);
+        openTimer.watch(&dlg);
+        dlg.exec();
+    });
+
+    QShortcut* traceShortcut = new QShortcut(QKeySequence("Ctrl+Shift+T"), this);
+    connect(traceShortcut, &QShortcut::activated, this, &MainWindow::toggleTracing);
+
+    enrichmentJob = new EnrichmentJob(db.getPath());
+    enrichmentJob->moveToThread(&enrichmentThread);
+    connect(&enrichmentThread, &QThread::finished, enrichmentJob, &QObject::deleteLater);
+    connect(enrichmentJob, &EnrichmentJob::progress, this, [this](long long processed, long long total) {
+        if (!enrichmentRunning) return; // paused meanwhile
+        statusBar()->showMessage(QString("Enriching words: %1 / %2").arg(processed).arg(total));
+    });
+    connect(enrichmentJob, &EnrichmentJob::finished, this, [this](bool success, const QString& error) {
+        enrichmentRunning = false;
+        ui->actionEnrichWords->setText("Enrich Words with AI...");
+        if (success) {
+            statusBar()->showMessage("Word enrichment complete", 5000);
+        } else {
+            statusBar()->showMessage("Word enrichment stopped: " + error);
+        }
+    });
+    enrichmentThread.start(QThread::LowPriority);
+    QMetaObject::invokeMethod(enrichmentJob, []() { Tracer::setThreadName("enrichment"); }, Qt::QueuedConnection);
     
-    // Initial visibility - show only deck list on startup
-    showDeckList();
+    // Initial visibility - show only deck list on startup; its rows load after the first paint
+    ui->modeSelectorContainer->setVisible(false);
+    ui->studyPanelContainer->setVisible(false);
     
     // Apply initial theme (light mode by default)
     applyLightTheme();
 }
 
 MainWindow::~MainWindow() {
+    // Only a live overview is worth keeping for the next launch
+    if (deckListPanel->hasLiveOverview()) {
+        DeckOverviewCache::save(DeckOverviewCache::pathFor(db.getPath()), deckListPanel->deckOverview());
+    }
+    deckOverviewThread.quit();
+    deckOverviewThread.wait();
+    distractorThread.quit();
+    distractorThread.wait();
+    maintenanceThread.quit();
+    maintenanceThread.wait();
+    backupThread.quit();
+    backupThread.wait();
+    fsrsThread.quit();
+    fsrsThread.wait();
+    enrichmentThread.quit();
+    enrichmentThread.wait();
     delete ui;
 }
 
+bool MainWindow::event(QEvent *event) {
+    bool handled = QMainWindow::event(event);
+    if (!firstPaintSeen && (event->type() == QEvent::UpdateRequest || event->type() == QEvent::Paint)) {
+        firstPaintSeen = true;
+        emit firstPainted();
+        deckListPanel->updateDeckList();
+    }
+    return handled;
+}
+
+ModeSelectorPanel* MainWindow::ensureModeSelectorPanel() {
+    if (!modeSelectorPanel) {
+        TRACE_SCOPE("MainWindow::ensureModeSelectorPanel");
+        modeSelectorPanel = new ModeSelectorPanel(this);
+        ui->modeSelectorContainer->layout()->addWidget(modeSelectorPanel);
+        connect(modeSelectorPanel, &ModeSelectorPanel::startStudyClicked, this, &MainWindow::onStartStudy);
+        connect(modeSelectorPanel, &ModeSelectorPanel::viewAllClicked, this, &MainWindow::onViewAll);
+        connect(modeSelectorPanel, &ModeSelectorPanel::deleteListClicked, this, &MainWindow::onDeleteList);
+        connect(modeSelectorPanel, &ModeSelectorPanel::schedulerChanged, this, [this](int listID, const QString& scheduler) {
+            try {
+                db.setListScheduler(listID, scheduler.toStdString());
+            } catch (const std::exception& e) {
+                QMessageBox::critical(this, "Error", "Failed to change the scheduler: " + QString::fromStdString(e.what()));
+            }
+        });
+        connect(modeSelectorPanel, &ModeSelectorPanel::sm2StepsChanged, this, [this](int listID, int firstDays, int secondDays) {
+            try {
+                db.setListSm2Steps(listID, firstDays, secondDays);
+            } catch (const std::exception& e) {
+                QMessageBox::critical(this, "Error", "Failed to change the SM-2 intervals: " + QString::fromStdString(e.what()));
+            }
+        });
+    }
+    return modeSelectorPanel;
+}
+
+StudyPanel* MainWindow::ensureStudyPanel() {
+    if (!studyPanel) {
+        TRACE_SCOPE("MainWindow::ensureStudyPanel");
+        studyPanel = new StudyPanel(&db, this);
+        ui->studyPanelContainer->layout()->addWidget(studyPanel);
+        connect(studyPanel, &StudyPanel::studyCompleted, this, &MainWindow::onStudyCompleted);
+    }
+    return studyPanel;
+}
+
 void MainWindow::on_addWord_clicked() {
+    DialogOpenTimer openTimer("addCard");
     AddCardWindow addCardWindow{nullptr, &db};
-    addCardWindow.applyTheme(isDarkMode);
+    openTimer.watch(&addCardWindow);
+    QObject::connect(&addCardWindow, &AddCardWindow::wordsAdded, this, &MainWindow::refreshDistractors);
     addCardWindow.setModal(true);
     addCardWindow.exec();
 }
 
 void MainWindow::on_createDeck_clicked() {
+    DialogOpenTimer openTimer("addList");
     AddListWindow addListWindow{nullptr, &db};
-    QObject::connect(&addListWindow, &AddListWindow::newAddedList, this, [this]() {
-        deckListPanel->updateDeckList();
-    });
-    addListWindow.applyTheme(isDarkMode);
+    openTimer.watch(&addListWindow);
     addListWindow.setModal(true);
     addListWindow.exec();
 }
@@ -69,12 +281,55 @@ DataBase* MainWindow::getDB() {
     return &db;
 }
 
+void MainWindow::refreshDistractors(int listID) {
+    TRACE_SCOPE("MainWindow::refreshDistractors");
+    if (listID < 0) {
+        QMetaObject::invokeMethod(distractorBuilder, "refreshAllLists", Qt::QueuedConnection);
+    } else {
+        QMetaObject::invokeMethod(distractorBuilder, "refreshList", Qt::QueuedConnection, Q_ARG(int, listID));
+    }
+}
+
+void MainWindow::onIdleTick() {
+    if (orphanSliceQueued || maintenanceSliceQueued) return;
+
+    // Reclaim orphans before maintenance so the vacuum can release their pages
+    if (orphanSweepPending) {
+        orphanSliceQueued = true;
+        QMetaObject::invokeMethod(orphanCollector, "collect", Qt::QueuedConnection, Q_ARG(int, ORPHAN_SLICE_BUDGET_MS));
+    } else {
+        maintenanceSliceQueued = true;
+        QMetaObject::invokeMethod(maintenanceScheduler, "runSlice", Qt::QueuedConnection, Q_ARG(int, MAINTENANCE_SLICE_BUDGET_MS));
+    }
+}
+
+void MainWindow::onOrphansCollected(int words, int examples, int relations, bool passComplete) {
+    orphanSliceQueued = false;
+    orphansReclaimed.words += words;
+    orphansReclaimed.examples += examples;
+    orphansReclaimed.relations += relations;
+    if (!passComplete) return;
+
+    orphanSweepPending = false;
+    if (orphansReclaimed.words + orphansReclaimed.examples + orphansReclaimed.relations > 0) {
+        statusBar()->showMessage(QString("Cleaned up %1 unused words, %2 examples and %3 relations")
+                                 .arg(orphansReclaimed.words).arg(orphansReclaimed.examples).arg(orphansReclaimed.relations), 10000);
+    }
+    orphansReclaimed = DataBase::OrphanReport();
+}
+
 void MainWindow::onDeckDoubleClicked(const QString& deckName, int listID) {
-    modeSelectorPanel->setDeckInfo(deckName, listID);
+    TRACE_SCOPE("MainWindow::onDeckDoubleClicked");
+    int firstDays = Scheduling::Sm2Policy::FIRST_INTERVAL_DAYS;
+    int secondDays = Scheduling::Sm2Policy::SECOND_INTERVAL_DAYS;
+    db.getListSm2Steps(listID, firstDays, secondDays);
+    ensureModeSelectorPanel()->setDeckInfo(deckName, listID, QString::fromStdString(db.getListScheduler(listID)), firstDays, secondDays);
     showModePanel();
 }
 
 void MainWindow::onStartStudy(int listID, int mode) {
+    TRACE_SCOPE("MainWindow::onStartStudy");
+    ensureStudyPanel();
     // Load cards for study
     auto cards = db.getDueCards(listID);
     
@@ -141,12 +396,33 @@ void MainWindow::onStartStudy(int listID, int mode) {
         studyMode = StudyPanel::StudyMode::Flashcard;
     }
     
+    startStudySession(cards, studyMode);
+}
+
+void MainWindow::startStudySession(const std::vector<DataBase::DueCard>& cards, StudyPanel::StudyMode studyMode) {
+    ensureStudyPanel();
+    // Decks on FSRS use the weights of the last fit, or the published defaults before the first one
+    Fsrs::Params params = Fsrs::defaultParams();
+    DataBase::SchedulerParams fitted;
+    if (db.getSchedulerParams("fsrs", fitted)) Fsrs::parseParams(fitted.params, params);
+    studyPanel->setFsrsParams(params);
+
+    std::set<int> listIDs;
+    for (const auto &card : cards) listIDs.insert(card.list_id);
+    for (int listID : listIDs) {
+        int firstDays = Scheduling::Sm2Policy::FIRST_INTERVAL_DAYS;
+        int secondDays = Scheduling::Sm2Policy::SECOND_INTERVAL_DAYS;
+        db.getListSm2Steps(listID, firstDays, secondDays);
+        studyPanel->setDeckScheduling(listID, db.getListScheduler(listID) == "fsrs", Scheduling::PolicyConfig::forSteps(firstDays, secondDays));
+    }
+
     studyPanel->setStudyCards(cards, studyMode);
     showStudyPanel();
     studyPanel->showCurrentCard();
 }
 
 void MainWindow::onViewAll(int listID) {
+    TRACE_SCOPE("MainWindow::onViewAll");
     // Get list name from mode selector panel
     QString listName = modeSelectorPanel->getCurrentDeckName();
     
@@ -167,6 +443,7 @@ void MainWindow::onViewAll(int listID) {
 }
 
 void MainWindow::onDeleteList(int listID) {
+    TRACE_SCOPE("MainWindow::onDeleteList");
     QString listName = modeSelectorPanel->getCurrentDeckName();
     
     // Ask for confirmation before deleting
@@ -179,11 +456,11 @@ void MainWindow::onDeleteList(int listID) {
     if (reply == QMessageBox::Yes) {
         try {
             db.deleteList(listID);
+            QMetaObject::invokeMethod(listPurgeWorker, "purgeList", Qt::QueuedConnection, Q_ARG(int, listID));
             QMessageBox::information(this, "Success", "List \"" + listName + "\" has been deleted.");
             
-            // Go back to deck list view and refresh
+            // Back to the deck list; the change bus refreshes it
             showDeckList();
-            deckListPanel->updateDeckList();
         } catch (const std::exception& e) {
             QMessageBox::critical(this, "Error", "Failed to delete list: " + QString::fromStdString(e.what()));
         }
@@ -199,28 +476,31 @@ void MainWindow::on_listDecks_clicked() {
 }
 
 void MainWindow::on_aiCreate_clicked() {
+    TRACE_SCOPE("MainWindow::on_aiCreate_clicked");
+    DialogOpenTimer openTimer("aiCreate");
     AICreateWindow dlg(this, &db);
-    dlg.applyTheme(isDarkMode);
+    openTimer.watch(&dlg);
+    QObject::connect(&dlg, &AICreateWindow::wordsAdded, this, &MainWindow::refreshDistractors);
     dlg.setModal(true);
     dlg.exec();
-    // after creation, refresh list view in case a new list was created
-    deckListPanel->updateDeckList();
 }
 
 void MainWindow::on_showStats_clicked() {
+    TRACE_SCOPE("MainWindow::on_showStats_clicked");
     std::string summary = db.getStudySessionSummary();
     showTextDialog("Study Sessions Summary", QString::fromStdString(summary));
 }
 
 void MainWindow::showDeckList() {
+    TRACE_SCOPE("MainWindow::showDeckList");
     ui->deckListContainer->setVisible(true);
     ui->modeSelectorContainer->setVisible(false);
     ui->studyPanelContainer->setVisible(false);
     ui->createDeck->setVisible(true);
-    deckListPanel->updateDeckList();
 }
 
 void MainWindow::showModePanel() {
+    TRACE_SCOPE("MainWindow::showModePanel");
     ui->deckListContainer->setVisible(false);
     ui->modeSelectorContainer->setVisible(true);
     ui->studyPanelContainer->setVisible(false);
@@ -228,6 +508,7 @@ void MainWindow::showModePanel() {
 }
 
 void MainWindow::showStudyPanel() {
+    TRACE_SCOPE("MainWindow::showStudyPanel");
     ui->deckListContainer->setVisible(false);
     ui->modeSelectorContainer->setVisible(false);
     ui->studyPanelContainer->setVisible(true);
@@ -246,18 +527,119 @@ void MainWindow::on_actionToggleDarkMode_triggered(bool checked) {
     deckListPanel->applyTheme(isDarkMode);
 }
 
+void MainWindow::on_actionEnrichWords_triggered() {
+    if (enrichmentRunning) {
+        // Progress is checkpointed, so the next run picks up where this one stopped
+        enrichmentRunning = false;
+        QMetaObject::invokeMethod(enrichmentJob, "stop", Qt::QueuedConnection);
+        ui->actionEnrichWords->setText("Enrich Words with AI...");
+        statusBar()->showMessage("Word enrichment paused", 5000);
+        return;
+    }
+
+    QString apiKey = QString::fromUtf8(qgetenv("OPENAI_API_KEY"));
+    if (apiKey.isEmpty()) {
+        bool ok = false;
+        apiKey = QInputDialog::getText(this, "OpenAI API Key", "Enter your OpenAI API key:", QLineEdit::Password, "", &ok);
+        if (!ok || apiKey.isEmpty()) return;
+    }
+
+    enrichmentRunning = true;
+    ui->actionEnrichWords->setText("Pause Word Enrichment");
+    EnrichmentJob* job = enrichmentJob;
+    QMetaObject::invokeMethod(job, [job, apiKey]() {
+        job->setApiKey(apiKey);
+        job->start();
+    }, Qt::QueuedConnection);
+}
+
+void MainWindow::on_actionBackupNow_triggered() {
+    if (backupRunning) return;
+    backupRunning = true;
+    QMetaObject::invokeMethod(backupWorker, "backupNow", Qt::QueuedConnection);
+}
+
+void MainWindow::on_actionRestoreBackup_triggered() {
+    QString snapshotsDir = BackupWorker::backupDirFor(db.getPath()) + "/snapshots";
+    QString manifest = QFileDialog::getOpenFileName(this, "Choose a snapshot", snapshotsDir, "Snapshots (*.manifest)");
+    if (manifest.isEmpty()) return;
+
+    QString dest = QFileDialog::getSaveFileName(this, "Restore snapshot as", QString(), "SQLite database (*.db)");
+    if (dest.isEmpty()) return;
+
+    // The open database cannot be replaced underneath its connections
+    if (QFileInfo(dest).absoluteFilePath() == QFileInfo(QString::fromStdString(db.getPath())).absoluteFilePath()) {
+        QMessageBox::warning(this, "Restore Backup", "Choose a different file than the database currently in use.");
+        return;
+    }
+
+    QMetaObject::invokeMethod(backupWorker, "restoreSnapshot", Qt::QueuedConnection,
+                              Q_ARG(QString, manifest), Q_ARG(QString, dest));
+}
+
+void MainWindow::on_actionFitScheduler_triggered() {
+    if (fsrsFitRunning) return;
+    fsrsFitRunning = true;
+    statusBar()->showMessage("Fitting the FSRS scheduler to the review history...");
+    QMetaObject::invokeMethod(fsrsFitWorker, "fit", Qt::QueuedConnection, Q_ARG(bool, true));
+}
+
+void MainWindow::on_actionCatchUp_triggered() {
+    TRACE_SCOPE("MainWindow::on_actionCatchUp_triggered");
+    bool ok = false;
+    int dailyCap = QInputDialog::getInt(this, "Catch Up", "Reviews per day while catching up:",
+                                        CatchUpPlanner::DEFAULT_DAILY_CAP, 10, 5000, 10, &ok);
+    if (!ok) return;
+
+    std::vector<DataBase::DueCard> cards;
+    CatchUpPlanner::Plan plan;
+    try {
+        // Today's reviews so far count against today's share
+        CatchUpPlanner planner(dailyCap, qMax(0, dailyCap - db.countReviewsToday()));
+        db.forEachOverdueCard([&planner](const DataBase::OverdueCard& card) { planner.add(card); });
+        plan = planner.finish();
+
+        std::vector<int> scheduleIDs;
+        for (const auto &entry : plan.batch(0)) scheduleIDs.push_back(entry.scheduleId);
+        cards = db.getDueCardsByScheduleIds(scheduleIDs);
+    } catch (const std::exception& e) {
+        QMessageBox::critical(this, "Catch Up", "Planning failed: " + QString::fromStdString(e.what()));
+        return;
+    }
+
+    if (plan.overdueCount == 0) {
+        QMessageBox::information(this, "Catch Up", "No reviews are overdue.");
+        return;
+    }
+    QString summary = QString("%1 overdue reviews across %2 decks; at %3 a day that takes about %4 days.")
+                          .arg(plan.overdueCount).arg(plan.deckCount).arg(dailyCap).arg(plan.daysToClear());
+    if (cards.empty()) {
+        QMessageBox::information(this, "Catch Up", summary + "\n\nToday's reviews are done; come back tomorrow.");
+        return;
+    }
+
+    QMessageBox::StandardButton reply = QMessageBox::question(
+        this, "Catch Up", summary + QString("\n\nStudy today's %1 cards, most likely forgotten first?").arg(cards.size()),
+        QMessageBox::Yes | QMessageBox::No);
+    if (reply != QMessageBox::Yes) return;
+
+    ensureStudyPanel()->setRandomPracticeMode(false);
+    startStudySession(cards, StudyPanel::StudyMode::Flashcard);
+}
+
 void MainWindow::applyLightTheme() {
-    this->setStyleSheet(ThemeUtils::getLightTheme());
+    ThemeUtils::applyTheme(false);
 }
 
 void MainWindow::applyDarkTheme() {
-    this->setStyleSheet(ThemeUtils::getDarkTheme());
+    ThemeUtils::applyTheme(true);
 }
 
 void MainWindow::showTextDialog(const QString& title, const QString& text, int width, int height) {
+    DialogOpenTimer openTimer("text");
     QDialog dlg(this);
+    openTimer.watch(&dlg);
     dlg.setWindowTitle(title);
-    dlg.setStyleSheet(isDarkMode ? ThemeUtils::getDarkTheme() : ThemeUtils::getLightTheme());
     
     QVBoxLayout* layout = new QVBoxLayout(&dlg);
     QTextEdit* view = new QTextEdit(&dlg);
@@ -270,3 +652,27 @@ void MainWindow::showTextDialog(const QString& title, const QString& text, int w
     dlg.resize(width, height);
     dlg.exec();
 }
+
+void MainWindow::toggleTracing() {
+    Tracer &tracer = Tracer::instance();
+    if (!Tracer::enabled()) {
+        tracer.setEnabled(true);
+        statusBar()->showMessage("Tracing... press Ctrl+Shift+T again to stop and save");
+        return;
+    }
+
+    tracer.setEnabled(false);
+    statusBar()->clearMessage();
+    QString defaultName = "trace-" + QDateTime::currentDateTime().toString("yyyyMMdd-HHmmss") + ".json";
+    QString path = QFileDialog::getSaveFileName(this, "Save Trace", defaultName, "Chrome trace (*.json)");
+    if (path.isEmpty()) return;
+
+    std::string json = tracer.toChromeJson();
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        QMessageBox::warning(this, "Save Trace", "Cannot write " + path + ": " + file.errorString());
+        return;
+    }
+    file.write(json.data(), static_cast<qint64>(json.size()));
+    statusBar()->showMessage("Trace saved to " + path + " (open it in ui.perfetto.dev or chrome://tracing)", 10000);
+}
@@ -7,11 +7,24 @@
 #include <QTableWidgetItem>
 #include <QString>
 #include <QPushButton>
+#include <QThread>
 #include <vector>
 #include "spacedrepetitioncalculator.h"
 #include "decklistpanel.h"
 #include "modeselectorpanel.h"
 #include "studypanel.h"
+#include "distractorbuilder.h"
+#include "enrichmentjob.h"
+#include "idlemonitor.h"
+#include "orphancollector.h"
+#include "maintenancescheduler.h"
+#include "listpurgeworker.h"
+#include "backupworker.h"
+#include "stallwatchdog.h"
+#include "deckoverviewloader.h"
+#include "changebus.h"
+#include "fsrsfitworker.h"
+#include <QTimer>
 
 QT_BEGIN_NAMESPACE
 namespace Ui {
@@ -29,6 +42,20 @@ public:
 
     DataBase* getDB();
 
+    // Work done per idle tick by the orphan collector and the maintenance scheduler
+    static constexpr int ORPHAN_SLICE_BUDGET_MS = 50;
+    static constexpr int MAINTENANCE_SLICE_BUDGET_MS = 100;
+
+    static constexpr int BACKUP_INTERVAL_MS = 60 * 60 * 1000;
+
+signals:
+    // Startup milestones: the window has painted once / the deck list is filled in
+    void firstPainted();
+    void interactive();
+
+protected:
+    bool event(QEvent *event) override;
+
 private slots:
     void on_addWord_clicked();
     void on_createDeck_clicked();
@@ -36,6 +63,11 @@ private slots:
     void on_listDecks_clicked();
     void on_showStats_clicked();
     void on_actionToggleDarkMode_triggered(bool checked);
+    void on_actionEnrichWords_triggered();
+    void on_actionBackupNow_triggered();
+    void on_actionRestoreBackup_triggered();
+    void on_actionFitScheduler_triggered();
+    void on_actionCatchUp_triggered();
     
     // Panel slots
     void onDeckDoubleClicked(const QString& deckName, int listID);
@@ -45,12 +77,22 @@ private slots:
     void onStudyCompleted();
 
 private:
+    void refreshDistractors(int listID = -1);
+    void onIdleTick();
+    void onOrphansCollected(int words, int examples, int relations, bool passComplete);
     void showDeckList();
     void showModePanel();
     void showStudyPanel();
+    // Sets up each deck's scheduler for the cards and opens the study panel on them
+    void startStudySession(const std::vector<DataBase::DueCard>& cards, StudyPanel::StudyMode studyMode);
+    // The mode and study panels are built the first time they are needed
+    ModeSelectorPanel* ensureModeSelectorPanel();
+    StudyPanel* ensureStudyPanel();
     void applyLightTheme();
     void applyDarkTheme();
     void showTextDialog(const QString& title, const QString& text, int width = 480, int height = 320);
+    // Ctrl+Shift+T: starts a trace recording, or stops it and saves the Chrome trace JSON
+    void toggleTracing();
     
     Ui::MainWindow *ui;
 
@@ -58,8 +100,52 @@ private:
     
     // Panel widgets
     DeckListPanel* deckListPanel;
-    ModeSelectorPanel* modeSelectorPanel;
-    StudyPanel* studyPanel;
+    ModeSelectorPanel* modeSelectorPanel = nullptr;
+    StudyPanel* studyPanel = nullptr;
+
+    // Committed writes and due times; drives every deck list refresh after the first
+    ChangeBus* changeBus;
+
+    // Deck list queries run here; the first load starts once the window has painted
+    QThread deckOverviewThread;
+    DeckOverviewLoader* deckOverviewLoader;
+    bool firstPaintSeen = false;
+    bool interactiveReported = false;
+
+    // Background distractor table maintenance
+    QThread distractorThread;
+    DistractorBuilder* distractorBuilder;
+
+    // Resumable AI enrichment of examples and relations; requests and writes both run here
+    QThread enrichmentThread;
+    EnrichmentJob* enrichmentJob;
+    bool enrichmentRunning = false;
+
+    // Idle-time housekeeping: orphaned words first, then ANALYZE/optimize/vacuum/checkpoint.
+    // Both workers share one thread so their writes never compete with each other.
+    IdleMonitor* idleMonitor;
+    QThread maintenanceThread;
+    OrphanCollector* orphanCollector;
+    MaintenanceScheduler* maintenanceScheduler;
+    bool maintenanceSliceQueued = false;
+    ListPurgeWorker* listPurgeWorker;
+
+    // Hourly hot backups into <database directory>/backups
+    QThread backupThread;
+    BackupWorker* backupWorker;
+    QTimer backupTimer;
+    bool backupRunning = false;
+    bool orphanSweepPending = true;
+    bool orphanSliceQueued = false;
+    DataBase::OrphanReport orphansReclaimed;
+
+    // FSRS weights are refitted here when the user is idle, at most about once a day
+    QThread fsrsThread;
+    FsrsFitWorker* fsrsFitWorker;
+    bool fsrsFitRunning = false;
+
+    // Reports UI-thread freezes (shown in the diagnostics view)
+    StallWatchdog* stallWatchdog;
     
     bool isDarkMode = false;
 };
@@ -0,0 +1,185 @@
+#include "metrics.h"
+#include <cmath>
+#include <iomanip>
+#include <sstream>
+
+namespace {
+// Durations are capped so every value lands in the last octave instead of overflowing the buckets
+const uint64_t kMaxTrackableMicros = (uint64_t(1) << 36) - 1;
+
+int highestBit(uint64_t v) {
+    int bit = 0;
+    while (v >>= 1) bit++;
+    return bit;
+}
+
+std::string escapeLabel(const std::string& text) {
+    std::string out;
+    for (char ch : text) {
+        if (ch == '\\' || ch == '"') out.push_back('\\');
+        if (ch == '\n') { out += "\\n"; continue; }
+        out.push_back(ch);
+    }
+    return out;
+}
+
+// Prometheus metric names allow [a-zA-Z0-9_:] only
+std::string metricName(const std::string& name) {
+    std::string out;
+    for (char ch : name) {
+        bool ok = (ch >= 'a' && ch <= 'z') || (ch >= 'A' && ch <= 'Z') || (ch >= '0' && ch <= '9') || ch == '_';
+        out.push_back(ok ? ch : '_');
+    }
+    return out;
+}
+}
+
+int LatencyHistogram::bucketIndex(uint64_t micros) {
+    if (micros > kMaxTrackableMicros) micros = kMaxTrackableMicros;
+    if (micros < static_cast<uint64_t>(SUB_BUCKETS)) return static_cast<int>(micros);
+
+    // Keep the top SUB_BUCKET_BITS + 1 bits: the leading one selects the octave, the rest the sub-bucket
+    int msb = highestBit(micros);
+    int shift = msb - SUB_BUCKET_BITS;
+    int mantissa = static_cast<int>(micros >> shift);
+    return (shift + 1) * SUB_BUCKETS + (mantissa - SUB_BUCKETS);
+}
+
+uint64_t LatencyHistogram::bucketLowerBound(int index) {
+    if (index < SUB_BUCKETS) return static_cast<uint64_t>(index);
+    int shift = index / SUB_BUCKETS - 1;
+    uint64_t mantissa = static_cast<uint64_t>(SUB_BUCKETS + index % SUB_BUCKETS);
+    return mantissa << shift;
+}
+
+void LatencyHistogram::record(uint64_t micros) {
+    buckets[bucketIndex(micros)].fetch_add(1, std::memory_order_relaxed);
+    sumMicros.fetch_add(micros, std::memory_order_relaxed);
+
+    uint64_t seen = maxMicros.load(std::memory_order_relaxed);
+    while (micros > seen && !maxMicros.compare_exchange_weak(seen, micros, std::memory_order_relaxed)) {
+    }
+}
+
+LatencyHistogram::Snapshot LatencyHistogram::snapshot() const {
+    Snapshot s;
+    // Fields are read one by one, so a snapshot taken while recording may be off by a few samples
+    for (int i = 0; i < BUCKETS; ++i) {
+        s.buckets[i] = buckets[i].load(std::memory_order_relaxed);
+        s.count += s.buckets[i];
+    }
+    s.errors = errors.load(std::memory_order_relaxed);
+    s.sumMicros = sumMicros.load(std::memory_order_relaxed);
+    s.maxMicros = maxMicros.load(std::memory_order_relaxed);
+    return s;
+}
+
+double LatencyHistogram::Snapshot::quantile(double q) const {
+    if (count == 0) return 0.0;
+    uint64_t target = static_cast<uint64_t>(std::ceil(q * static_cast<double>(count)));
+    if (target == 0) target = 1;
+
+    uint64_t seen = 0;
+    for (int i = 0; i < BUCKETS; ++i) {
+        seen += buckets[i];
+        if (seen >= target) {
+            // Midpoint of the bucket, never above the largest value actually recorded
+            double low = static_cast<double>(bucketLowerBound(i));
+            double high = (i + 1 < BUCKETS) ? static_cast<double>(bucketLowerBound(i + 1)) : low;
+            return std::min((low + high) / 2.0, static_cast<double>(maxMicros));
+        }
+    }
+    return static_cast<double>(maxMicros);
+}
+
+MetricsRegistry& MetricsRegistry::instance() {
+    static MetricsRegistry registry;
+    return registry;
+}
+
+Counter& MetricsRegistry::counter(const std::string& name) {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto &slot = counters[name];
+    if (!slot) slot = std::make_unique<Counter>();
+    return *slot;
+}
+
+LatencyHistogram& MetricsRegistry::histogram(const std::string& name) {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto &slot = histograms[name];
+    if (!slot) slot = std::make_unique<LatencyHistogram>();
+    return *slot;
+}
+
+std::map<std::string, uint64_t> MetricsRegistry::counterValues() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    std::map<std::string, uint64_t> out;
+    for (const auto &p : counters) out[p.first] = p.second->get();
+    return out;
+}
+
+std::map<std::string, LatencyHistogram::Snapshot> MetricsRegistry::histogramSnapshots() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    std::map<std::string, LatencyHistogram::Snapshot> out;
+    for (const auto &p : histograms) out[p.first] = p.second->snapshot();
+    return out;
+}
+
+std::string MetricsRegistry::toPrometheus() const {
+    std::ostringstream out;
+    out << std::setprecision(9);
+
+    for (const auto &p : counterValues()) {
+        std::string name = "vocab_" + metricName(p.first) + "_total";
+        out << "# TYPE " << name << " counter\n";
+        out << name << " " << p.second << "\n";
+    }
+
+    auto snapshots = histogramSnapshots();
+    if (!snapshots.empty()) {
+        out << "# TYPE vocab_latency_seconds summary\n";
+        for (const auto &p : snapshots) {
+            std::string op = escapeLabel(p.first);
+            for (double q : {0.5, 0.9, 0.99}) {
+                out << "vocab_latency_seconds{op=\"" << op << "\",quantile=\"" << q << "\"} "
+                    << p.second.quantile(q) / 1e6 << "\n";
+            }
+            out << "vocab_latency_seconds_sum{op=\"" << op << "\"} " << static_cast<double>(p.second.sumMicros) / 1e6 << "\n";
+            out << "vocab_latency_seconds_count{op=\"" << op << "\"} " << p.second.count << "\n";
+        }
+        out << "# TYPE vocab_errors_total counter\n";
+        for (const auto &p : snapshots) {
+            out << "vocab_errors_total{op=\"" << escapeLabel(p.first) << "\"} " << p.second.errors << "\n";
+        }
+    }
+    return out.str();
+}
+
+std::string MetricsRegistry::toJson() const {
+    std::ostringstream out;
+    out << std::setprecision(6) << std::fixed;
+
+    out << "{\"counters\":{";
+    bool first = true;
+    for (const auto &p : counterValues()) {
+        out << (first ? "" : ",") << "\"" << escapeLabel(p.first) << "\":" << p.second;
+        first = false;
+    }
+
+    out << "},\"histograms\":{";
+    first = true;
+    for (const auto &p : histogramSnapshots()) {
+        const auto &s = p.second;
+        out << (first ? "" : ",") << "\"" << escapeLabel(p.first) << "\":{"
+            << "\"count\":" << s.count << ","
+            << "\"errors\":" << s.errors << ","
+            << "\"sum_ms\":" << static_cast<double>(s.sumMicros) / 1000.0 << ","
+            << "\"p50_ms\":" << s.quantile(0.5) / 1000.0 << ","
+            << "\"p90_ms\":" << s.quantile(0.9) / 1000.0 << ","
+            << "\"p99_ms\":" << s.quantile(0.99) / 1000.0 << ","
+            << "\"max_ms\":" << static_cast<double>(s.maxMicros) / 1000.0 << "}";
+        first = false;
+    }
+    out << "}}";
+    return out.str();
+}
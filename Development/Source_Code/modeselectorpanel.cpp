@@ -1,5 +1,7 @@
 #include "modeselectorpanel.h"
 #include "ui_modeselectorpanel.h"
+#include "tracing.h"
+#include <QSignalBlocker>
 
 ModeSelectorPanel::ModeSelectorPanel(QWidget *parent)
     : QWidget(parent)
@@ -12,6 +14,9 @@ ModeSelectorPanel::ModeSelectorPanel(QWidget *parent)
     connect(ui->startStudyButton, &QPushButton::clicked, this, &ModeSelectorPanel::onStartStudyClicked);
     connect(ui->viewAllButton, &QPushButton::clicked, this, &ModeSelectorPanel::onViewAllClicked);
     connect(ui->deleteListButton, &QPushButton::clicked, this, &ModeSelectorPanel::onDeleteListClicked);
+    connect(ui->schedulerComboBox, QOverload<int>::of(&QComboBox::currentIndexChanged), this, &ModeSelectorPanel::onSchedulerIndexChanged);
+    connect(ui->sm2FirstIntervalSpinBox, &QSpinBox::editingFinished, this, &ModeSelectorPanel::onSm2StepsEdited);
+    connect(ui->sm2SecondIntervalSpinBox, &QSpinBox::editingFinished, this, &ModeSelectorPanel::onSm2StepsEdited);
 }
 
 ModeSelectorPanel::~ModeSelectorPanel()
@@ -19,11 +24,19 @@ ModeSelectorPanel::~ModeSelectorPanel()
     delete ui;
 }
 
-void ModeSelectorPanel::setDeckInfo(const QString& deckName, int listID)
+void ModeSelectorPanel::setDeckInfo(const QString& deckName, int listID, const QString& scheduler,
+                                    int sm2FirstIntervalDays, int sm2SecondIntervalDays)
 {
+    TRACE_SCOPE("ModeSelectorPanel::setDeckInfo");
     currentDeckName = deckName;
     currentListID = listID;
     ui->selectedDeckLabel->setText(deckName);
+    // Showing the stored choice is not a change
+    QSignalBlocker blocker(ui->schedulerComboBox);
+    ui->schedulerComboBox->setCurrentIndex(scheduler == "fsrs" ? 1 : 0);
+    ui->sm2FirstIntervalSpinBox->setValue(sm2FirstIntervalDays);
+    ui->sm2SecondIntervalSpinBox->setValue(sm2SecondIntervalDays);
+    shownSm2Steps = qMakePair(sm2FirstIntervalDays, sm2SecondIntervalDays);
 }
 
 int ModeSelectorPanel::getSelectedMode() const
@@ -45,3 +58,17 @@ void ModeSelectorPanel::onDeleteListClicked()
 {
     emit deleteListClicked(currentListID);
 }
+
+void ModeSelectorPanel::onSchedulerIndexChanged(int index)
+{
+    emit schedulerChanged(currentListID, index == 1 ? "fsrs" : "sm2");
+}
+
+void ModeSelectorPanel::onSm2StepsEdited()
+{
+    // editingFinished also fires on focus loss without an edit
+    QPair<int, int> steps(ui->sm2FirstIntervalSpinBox->value(), ui->sm2SecondIntervalSpinBox->value());
+    if (steps == shownSm2Steps) return;
+    shownSm2Steps = steps;
+    emit sm2StepsChanged(currentListID, steps.first, steps.second);
+}
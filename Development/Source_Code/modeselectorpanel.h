@@ -2,6 +2,7 @@
 #define MODESELECTORPANEL_H
 
 #include <QWidget>
+#include <QPair>
 
 namespace Ui {
 class ModeSelectorPanel;
@@ -15,7 +16,9 @@ public:
     explicit ModeSelectorPanel(QWidget *parent = nullptr);
     ~ModeSelectorPanel();
 
-    void setDeckInfo(const QString& deckName, int listID);
+    // scheduler: "sm2" or "fsrs", as stored in vocabulary_lists, with the deck's SM-2 first intervals
+    void setDeckInfo(const QString& deckName, int listID, const QString& scheduler = "sm2",
+                     int sm2FirstIntervalDays = 1, int sm2SecondIntervalDays = 6);
     int getSelectedMode() const; // 0=Flashcard, 1=MultipleChoice, 2=Typing
     int getCurrentListID() const { return currentListID; }
     QString getCurrentDeckName() const { return currentDeckName; }
@@ -24,16 +27,21 @@ signals:
     void startStudyClicked(int listID, int mode);
     void viewAllClicked(int listID);
     void deleteListClicked(int listID);
+    void schedulerChanged(int listID, const QString& scheduler);
+    void sm2StepsChanged(int listID, int firstIntervalDays, int secondIntervalDays);
 
 private slots:
     void onStartStudyClicked();
     void onViewAllClicked();
     void onDeleteListClicked();
+    void onSchedulerIndexChanged(int index);
+    void onSm2StepsEdited();
 
 private:
     Ui::ModeSelectorPanel *ui;
     int currentListID;
     QString currentDeckName;
+    QPair<int, int> shownSm2Steps;
 };
 
 #endif // MODESELECTORPANEL_H
@@ -0,0 +1,81 @@
+#include "orphancollector.h"
+#include "tracing.h"
+#include <QDebug>
+#include <QElapsedTimer>
+#include <algorithm>
+#include <stdexcept>
+
+namespace {
+const int kMinScanLimit = 32;
+const int kMaxScanLimit = 4096;
+}
+
+OrphanCollector::OrphanCollector(const std::string& dbPath, QObject *parent)
+    : QObject(parent)
+    , dbPath(dbPath) {
+
+}
+
+OrphanCollector::~OrphanCollector() {
+}
+
+DataBase* OrphanCollector::connection() {
+    // Opened lazily so the connection is created on the worker thread that uses it
+    if (!db) {
+        db = std::make_unique<DataBase>(dbPath);
+    }
+    return db.get();
+}
+
+void OrphanCollector::collect(int budgetMs) {
+    TRACE_SCOPE_CAT("worker", "OrphanCollector::collect");
+    DataBase::OrphanReport slice;
+    bool passComplete = false;
+
+    try {
+        DataBase* conn = connection();
+        QElapsedTimer budget;
+        budget.start();
+
+        while (budget.elapsed() < budgetMs) {
+            QElapsedTimer chunkTimer;
+            chunkTimer.start();
+
+            bool reachedEnd = false;
+            DataBase::OrphanReport chunk = conn->collectOrphanWords(cursor, scanLimit, reachedEnd);
+            slice.words += chunk.words;
+            slice.examples += chunk.examples;
+            slice.relations += chunk.relations;
+
+            // Keep each chunk (and so each write lock) close to the target duration
+            qint64 took = chunkTimer.elapsed();
+            if (took > TARGET_CHUNK_MS) scanLimit = std::max(kMinScanLimit, scanLimit / 2);
+            else if (took * 2 < TARGET_CHUNK_MS) scanLimit = std::min(kMaxScanLimit, scanLimit * 2);
+
+            if (reachedEnd) {
+                DataBase::OrphanReport dangling = conn->collectDanglingRows(kMaxScanLimit);
+                slice.examples += dangling.examples;
+                slice.relations += dangling.relations;
+                // Another pass is only needed if the bounded cleanup left rows behind
+                if (dangling.examples < kMaxScanLimit && dangling.relations < kMaxScanLimit) {
+                    passComplete = true;
+                    cursor = 0;
+                    break;
+                }
+            }
+        }
+    } catch (const std::exception& ex) {
+        qCritical() << "Orphan collection failed:" << ex.what();
+    }
+
+    passTotal.words += slice.words;
+    passTotal.examples += slice.examples;
+    passTotal.relations += slice.relations;
+    if (passComplete) {
+        qInfo() << "Orphan collection pass reclaimed" << passTotal.words << "words," << passTotal.examples
+                << "examples and" << passTotal.relations << "relations";
+        passTotal = DataBase::OrphanReport();
+    }
+
+    emit collected(slice.words, slice.examples, slice.relations, passComplete);
+}
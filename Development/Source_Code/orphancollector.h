@@ -0,0 +1,41 @@
+#ifndef ORPHANCOLLECTOR_H
+#define ORPHANCOLLECTOR_H
+
+#include <QObject>
+#include <memory>
+#include <string>
+#include "database.h"
+
+// Background job that deletes words left behind by deleted lists, with their examples and relations.
+// Lives on its own QThread with its own DataBase connection. Every collect() call works for at most
+// budgetMs, in chunks sized so that each write transaction stays within a few milliseconds, and then
+// returns so the caller can schedule the next slice (e.g. on the next idle tick).
+class OrphanCollector : public QObject
+{
+    Q_OBJECT
+
+public:
+    // Target duration of a single write transaction
+    static constexpr int TARGET_CHUNK_MS = 4;
+
+    explicit OrphanCollector(const std::string& dbPath, QObject *parent = nullptr);
+    ~OrphanCollector();
+
+public slots:
+    void collect(int budgetMs);
+
+signals:
+    // Emitted after every slice; passComplete is set once a full sweep over the words table has finished
+    void collected(int words, int examples, int relations, bool passComplete);
+
+private:
+    DataBase* connection();
+
+    std::string dbPath;
+    std::unique_ptr<DataBase> db;
+    int cursor = 0;
+    int scanLimit = 256;
+    DataBase::OrphanReport passTotal;
+};
+
+#endif // ORPHANCOLLECTOR_H
@@ -0,0 +1,132 @@
+#include "querycache.h"
+#include "metrics.h"
+#include <algorithm>
+#include <cstdlib>
+#include <iterator>
+
+namespace {
+size_t budgetFromEnvironment() {
+    const char* env = std::getenv("VOCAB_QUERY_CACHE_MB");
+    if (env && *env) return static_cast<size_t>(std::max(0, std::atoi(env))) * 1024 * 1024;
+    return QueryCache::DEFAULT_BUDGET_BYTES;
+}
+
+// Bookkeeping per entry on top of the result itself
+const size_t kEntryOverheadBytes = 128;
+}
+
+QueryCache& QueryCache::instance() {
+    static QueryCache cache;
+    return cache;
+}
+
+QueryCache::QueryCache()
+    : budgetBytes(budgetFromEnvironment()) {
+}
+
+void QueryCache::setBudgetBytes(size_t bytes) {
+    std::lock_guard<std::mutex> lock(mutex);
+    budgetBytes = bytes;
+    while (usedBytes > budgetBytes && !lru.empty()) {
+        eraseLocked(std::prev(lru.end()));
+        counts.evictions++;
+    }
+}
+
+uint64_t QueryCache::stampLocked(unsigned tables) const {
+    // Generations only grow, so the sum changes whenever any of the tables was written
+    uint64_t sum = 0;
+    for (int bit = 0; bit < 32; ++bit) {
+        if (tables & (1u << bit)) sum += generations[bit];
+    }
+    return sum;
+}
+
+uint64_t QueryCache::stamp(unsigned tables) const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return stampLocked(tables);
+}
+
+std::shared_ptr<const void> QueryCache::lookup(const std::string& key) {
+    static Counter& hits = MetricsRegistry::instance().counter("db.cache.hits");
+    static Counter& misses = MetricsRegistry::instance().counter("db.cache.misses");
+
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = index.find(key);
+    if (it != index.end() && it->second->expires <= Clock::now()) {
+        eraseLocked(it->second);
+        it = index.end();
+    }
+    if (it == index.end()) {
+        counts.misses++;
+        misses.add();
+        return nullptr;
+    }
+
+    lru.splice(lru.begin(), lru, it->second);
+    counts.hits++;
+    hits.add();
+    return it->second->value;
+}
+
+void QueryCache::store(const std::string& key, unsigned tables, uint64_t stampBefore, std::shared_ptr<const void> value,
+                       size_t bytes, Clock::time_point expires) {
+    static Counter& evictions = MetricsRegistry::instance().counter("db.cache.evictions");
+
+    bytes += key.size() + kEntryOverheadBytes;
+    std::lock_guard<std::mutex> lock(mutex);
+    // Written while the query ran: the result may predate the commit. Huge results would flush everything else.
+    if (stampLocked(tables) != stampBefore || bytes > budgetBytes / 4) return;
+
+    auto existing = index.find(key);
+    if (existing != index.end()) eraseLocked(existing->second);
+
+    while (usedBytes + bytes > budgetBytes && !lru.empty()) {
+        eraseLocked(std::prev(lru.end()));
+        counts.evictions++;
+        evictions.add();
+    }
+
+    lru.push_front(Entry{key, tables, std::move(value), bytes, expires});
+    index[key] = lru.begin();
+    usedBytes += bytes;
+}
+
+void QueryCache::invalidate(unsigned tables) {
+    static Counter& invalidated = MetricsRegistry::instance().counter("db.cache.invalidated");
+
+    std::lock_guard<std::mutex> lock(mutex);
+    for (int bit = 0; bit < 32; ++bit) {
+        if (tables & (1u << bit)) generations[bit]++;
+    }
+    for (auto it = lru.begin(); it != lru.end();) {
+        auto next = std::next(it);
+        if (it->tables & tables) {
+            eraseLocked(it);
+            counts.invalidated++;
+            invalidated.add();
+        }
+        it = next;
+    }
+}
+
+void QueryCache::clear() {
+    std::lock_guard<std::mutex> lock(mutex);
+    lru.clear();
+    index.clear();
+    usedBytes = 0;
+}
+
+QueryCache::Stats QueryCache::stats() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    Stats s = counts;
+    s.entries = lru.size();
+    s.bytes = usedBytes;
+    return s;
+}
+
+void QueryCache::eraseLocked(std::list<Entry>::iterator it) {
+    usedBytes -= it->bytes;
+    index.erase(it->key);
+    lru.erase(it);
+}
@@ -0,0 +1,77 @@
+#ifndef QUERYCACHE_H
+#define QUERYCACHE_H
+
+#include <chrono>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+// Process-wide cache of read-query results shared by all DataBase connections. Entries are keyed
+// by statement and bound parameters and tagged with the tables the query reads (a mask of
+// DataBase::ChangedTable bits); a commit that writes one of those tables drops them.
+// Least recently used entries are evicted once the results exceed the memory budget.
+//
+// A query that races with a commit must not leave its stale result behind: callers take a
+// stamp() of the tables before running the query and store() refuses the result if any of
+// them was invalidated in the meantime.
+class QueryCache
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    // VOCAB_QUERY_CACHE_MB overrides the budget; 0 disables the cache
+    static constexpr size_t DEFAULT_BUDGET_BYTES = 4 * 1024 * 1024;
+
+    struct Stats {
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+        uint64_t evictions = 0;
+        uint64_t invalidated = 0;
+        size_t entries = 0;
+        size_t bytes = 0;
+    };
+
+    static QueryCache& instance();
+
+    bool enabled() const { return budgetBytes > 0; }
+    void setBudgetBytes(size_t bytes);
+
+    uint64_t stamp(unsigned tables) const;
+
+    // The stored value, or null on a miss or when the entry has expired
+    std::shared_ptr<const void> lookup(const std::string& key);
+    void store(const std::string& key, unsigned tables, uint64_t stampBefore, std::shared_ptr<const void> value,
+               size_t bytes, Clock::time_point expires = Clock::time_point::max());
+
+    void invalidate(unsigned tables);
+    void clear();
+
+    Stats stats() const;
+
+private:
+    QueryCache();
+
+    struct Entry {
+        std::string key;
+        unsigned tables = 0;
+        std::shared_ptr<const void> value;
+        size_t bytes = 0;
+        Clock::time_point expires;
+    };
+
+    uint64_t stampLocked(unsigned tables) const;
+    void eraseLocked(std::list<Entry>::iterator it);
+
+    mutable std::mutex mutex;
+    size_t budgetBytes;
+    size_t usedBytes = 0;
+    uint64_t generations[32] = {};
+    std::list<Entry> lru;   // most recently used first
+    std::unordered_map<std::string, std::list<Entry>::iterator> index;
+    Stats counts;
+};
+
+#endif // QUERYCACHE_H
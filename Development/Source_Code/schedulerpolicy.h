@@ -0,0 +1,129 @@
+#ifndef SCHEDULERPOLICY_H
+#define SCHEDULERPOLICY_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+
+// Interval policies for the SM-2 family. A policy is a small value type providing
+//
+//   void review(CardSchedule& card, int quality) const;
+//
+// with no virtual functions. Code that schedules many cards resolves the deck's PolicyConfig
+// once with dispatch() and runs a loop instantiated for the concrete policy, so the update is
+// inlined into it. New policies add a PolicyKind and a case in dispatch().
+namespace Scheduling {
+
+struct CardSchedule {
+    double easeFactor = 2.5;
+    int repetitions = 0;
+    int intervalDays = 0;
+};
+
+// Ease factor update and lapse handling shared by the SM-2 family. Derived supplies the
+// intervals after the first and second successful reviews; later ones grow by the ease factor.
+template <typename Derived>
+struct Sm2Base {
+    static constexpr double MIN_EF = 1.3;
+    static constexpr double MAX_EF = 2.5;
+    static constexpr double INITIAL_EF = 2.5;
+    static constexpr int LAPSE_INTERVAL_DAYS = 1;
+    // Same ceiling as FSRS; also keeps long streaks from overflowing the int
+    static constexpr int MAX_INTERVAL_DAYS = 36500;
+
+    // quality 0..5; below 3 is a lapse. Written with selects rather than branches: ratings are
+    // unpredictable, and a branch-free body lets batch loops pipeline (and vectorize) the update.
+    void review(CardSchedule& card, int quality) const {
+        quality = std::max(0, std::min(5, quality));
+        int missed = 5 - quality;
+        double ef = std::max(MIN_EF, std::min(MAX_EF, card.easeFactor + (0.1 - missed * (0.08 + missed * 0.02))));
+
+        const Derived& self = static_cast<const Derived&>(*this);
+        bool passed = quality >= 3;
+        int repetitions = passed ? card.repetitions + 1 : 0;
+        int grown = static_cast<int>(std::min<double>(MAX_INTERVAL_DAYS, card.intervalDays * ef));
+        int interval = repetitions == 1 ? self.firstIntervalDays() : (repetitions == 2 ? self.secondIntervalDays() : grown);
+
+        card.easeFactor = ef;
+        card.repetitions = repetitions;
+        card.intervalDays = passed ? interval : LAPSE_INTERVAL_DAYS;
+    }
+};
+
+// Classic SM-2: 1 day, then 6 days
+struct Sm2Policy : Sm2Base<Sm2Policy> {
+    static constexpr int FIRST_INTERVAL_DAYS = 1;
+    static constexpr int SECOND_INTERVAL_DAYS = 6;
+
+    static constexpr int firstIntervalDays() { return FIRST_INTERVAL_DAYS; }
+    static constexpr int secondIntervalDays() { return SECOND_INTERVAL_DAYS; }
+};
+
+// SM-2 with the deck's own first and second intervals
+struct Sm2StepsPolicy : Sm2Base<Sm2StepsPolicy> {
+    Sm2StepsPolicy(int firstDays, int secondDays)
+        : first(std::max(1, firstDays))
+        , second(std::max(first, secondDays)) {}
+
+    int firstIntervalDays() const { return first; }
+    int secondIntervalDays() const { return second; }
+
+    int first;
+    int second;
+};
+
+enum class PolicyKind : uint8_t {
+    Sm2,
+    Sm2Steps
+};
+
+// A deck's policy as chosen at runtime
+struct PolicyConfig {
+    PolicyKind kind = PolicyKind::Sm2;
+    int firstIntervalDays = Sm2Policy::FIRST_INTERVAL_DAYS;
+    int secondIntervalDays = Sm2Policy::SECOND_INTERVAL_DAYS;
+
+    // Plain SM-2 when the steps are the classic ones
+    static PolicyConfig forSteps(int firstDays, int secondDays) {
+        PolicyConfig config;
+        config.firstIntervalDays = firstDays;
+        config.secondIntervalDays = secondDays;
+        if (firstDays != Sm2Policy::FIRST_INTERVAL_DAYS || secondDays != Sm2Policy::SECOND_INTERVAL_DAYS) {
+            config.kind = PolicyKind::Sm2Steps;
+        }
+        return config;
+    }
+};
+
+// Calls f with the concrete policy; the only branch on the policy kind for whatever f does
+template <typename F>
+decltype(auto) dispatch(const PolicyConfig& config, F&& f) {
+    switch (config.kind) {
+    case PolicyKind::Sm2Steps:
+        return f(Sm2StepsPolicy(config.firstIntervalDays, config.secondIntervalDays));
+    case PolicyKind::Sm2:
+    default:
+        return f(Sm2Policy());
+    }
+}
+
+// Applies qualities[i] to cards[i]
+template <typename Policy>
+void reviewBatch(const Policy& policy, CardSchedule* cards, const uint8_t* qualities, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        policy.review(cards[i], qualities[i]);
+    }
+}
+
+inline void reviewBatch(const PolicyConfig& config, CardSchedule* cards, const uint8_t* qualities, size_t count) {
+    dispatch(config, [&](const auto& policy) { reviewBatch(policy, cards, qualities, count); });
+}
+
+// Single card, e.g. one rating in the study panel
+inline void review(const PolicyConfig& config, CardSchedule& card, int quality) {
+    dispatch(config, [&](const auto& policy) { policy.review(card, quality); });
+}
+
+}
+
+#endif // SCHEDULERPOLICY_H
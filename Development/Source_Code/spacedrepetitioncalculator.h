@@ -2,16 +2,20 @@
 #define SPACEDREPETITIONCALCULATOR_H
 
 #include <ctime>
+#include "schedulerpolicy.h"
 
 class SpacedRepetitionCalculator
 {
 public:
     SpacedRepetitionCalculator();
 
+    // Updates the schedule with the deck's policy (classic SM-2 unless setPolicy was called)
     void calculateNextReview(int quality);
 
-    static constexpr double MIN_EF = 1.3;
-    static constexpr double MAX_EF = 2.5;
+    static constexpr double MIN_EF = Scheduling::Sm2Policy::MIN_EF;
+    static constexpr double MAX_EF = Scheduling::Sm2Policy::MAX_EF;
+
+    void setPolicy(const Scheduling::PolicyConfig& value) { policy = value; }
 
     double getEasinessFactor() const {return easinessFactor; };
     int getRepetitions() const { return repetitions; };
@@ -32,6 +36,7 @@ private:
     int repetitions;
     int interval;
     time_t nextReview;
+    Scheduling::PolicyConfig policy;
 };
 
 #endif // SPACEDREPETITIONCALCULATOR_H
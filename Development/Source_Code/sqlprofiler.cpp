@@ -0,0 +1,161 @@
+#include "sqlprofiler.h"
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <filesystem>
+#include <fstream>
+
+namespace {
+int thresholdFromEnvironment() {
+    const char* env = std::getenv("VOCAB_SLOW_QUERY_MS");
+    if (env && *env) return std::max(0, std::atoi(env));
+    return 50;
+}
+
+bool isIdentifierChar(char ch) {
+    return std::isalnum(static_cast<unsigned char>(ch)) || ch == '_';
+}
+}
+
+std::atomic<int> SqlProfiler::slowThresholdMs{thresholdFromEnvironment()};
+std::mutex SlowQueryLog::mutex;
+
+SqlProfiler& SqlProfiler::instance() {
+    static SqlProfiler profiler;
+    return profiler;
+}
+
+std::string SqlProfiler::normalize(const std::string& sql) {
+    std::string out;
+    out.reserve(sql.size());
+
+    size_t i = 0;
+    while (i < sql.size()) {
+        char ch = sql[i];
+        if (ch == '\'') {
+            // String literal ('' is an escaped quote)
+            ++i;
+            while (i < sql.size()) {
+                if (sql[i] == '\'' && i + 1 < sql.size() && sql[i + 1] == '\'') i += 2;
+                else if (sql[i] == '\'') { ++i; break; }
+                else ++i;
+            }
+            out.push_back('?');
+        } else if (std::isdigit(static_cast<unsigned char>(ch)) && (out.empty() || !isIdentifierChar(out.back()))) {
+            // Numeric literal (digits inside identifiers such as word1_id are kept)
+            while (i < sql.size() && (std::isalnum(static_cast<unsigned char>(sql[i])) || sql[i] == '.')) ++i;
+            out.push_back('?');
+        } else if (ch == '?') {
+            // ?NNN numbered parameters
+            ++i;
+            while (i < sql.size() && std::isdigit(static_cast<unsigned char>(sql[i]))) ++i;
+            out.push_back('?');
+        } else if (std::isspace(static_cast<unsigned char>(ch))) {
+            while (i < sql.size() && std::isspace(static_cast<unsigned char>(sql[i]))) ++i;
+            if (!out.empty() && out.back() != ' ') out.push_back(' ');
+        } else {
+            out.push_back(static_cast<char>(std::tolower(static_cast<unsigned char>(ch))));
+            ++i;
+        }
+    }
+
+    // Drop the spaces around punctuation, then fold IN lists of any length into one "?"
+    std::string compact;
+    compact.reserve(out.size());
+    for (size_t j = 0; j < out.size(); ++j) {
+        char ch = out[j];
+        if (ch == ' ') {
+            char prev = compact.empty() ? ' ' : compact.back();
+            char next = j + 1 < out.size() ? out[j + 1] : ' ';
+            if (prev == ',' || prev == '(' || next == ',' || next == ')' || next == ';' || prev == ' ') continue;
+        }
+        compact.push_back(ch);
+    }
+    size_t pos;
+    while ((pos = compact.find("?,?")) != std::string::npos) {
+        compact.erase(pos, 2);
+    }
+    while (!compact.empty() && (compact.back() == ' ' || compact.back() == ';')) compact.pop_back();
+    return compact;
+}
+
+std::string SqlProfiler::fingerprint(const std::string& normalizedSql) {
+    // 64-bit FNV-1a
+    uint64_t h = 1469598103934665603ULL;
+    for (unsigned char ch : normalizedSql) {
+        h ^= ch;
+        h *= 1099511628211ULL;
+    }
+    char buf[17];
+    std::snprintf(buf, sizeof(buf), "%016llx", static_cast<unsigned long long>(h));
+    return std::string(buf);
+}
+
+void SqlProfiler::record(const std::string& normalizedSql, const std::string& fp, uint64_t ns, uint64_t rows, uint64_t vmSteps) {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = statements.find(fp);
+    if (it == statements.end()) {
+        if (statements.size() >= MAX_STATEMENTS) return;
+        StatementStats stats;
+        stats.fingerprint = fp;
+        stats.normalizedSql = normalizedSql;
+        it = statements.emplace(fp, std::move(stats)).first;
+    }
+
+    StatementStats &s = it->second;
+    s.count++;
+    s.totalNs += ns;
+    s.maxNs = std::max(s.maxNs, ns);
+    s.rows += rows;
+    s.vmSteps += vmSteps;
+}
+
+std::vector<SqlProfiler::StatementStats> SqlProfiler::topStatements(size_t limit) const {
+    std::vector<StatementStats> out;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        out.reserve(statements.size());
+        for (const auto &p : statements) out.push_back(p.second);
+    }
+    std::sort(out.begin(), out.end(), [](const StatementStats& a, const StatementStats& b) { return a.totalNs > b.totalNs; });
+    if (out.size() > limit) out.resize(limit);
+    return out;
+}
+
+void SlowQueryLog::rotateIfNeeded(const std::string& logPath) {
+    std::error_code ec;
+    auto size = std::filesystem::file_size(logPath, ec);
+    if (ec || size < MAX_BYTES) return;
+
+    std::filesystem::remove(logPath + "." + std::to_string(KEEP_FILES), ec);
+    for (int i = KEEP_FILES - 1; i >= 1; --i) {
+        std::filesystem::rename(logPath + "." + std::to_string(i), logPath + "." + std::to_string(i + 1), ec);
+    }
+    std::filesystem::rename(logPath, logPath + ".1", ec);
+}
+
+void SlowQueryLog::append(const std::string& logPath, const Entry& entry) {
+    std::lock_guard<std::mutex> lock(mutex);
+
+    std::error_code ec;
+    std::filesystem::create_directories(std::filesystem::path(logPath).parent_path(), ec);
+    rotateIfNeeded(logPath);
+
+    std::ofstream out(logPath, std::ios::app);
+    if (!out) return;
+
+    std::time_t now = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
+    char stamp[32];
+    std::strftime(stamp, sizeof(stamp), "%Y-%m-%d %H:%M:%S", std::gmtime(&now));
+
+    out << stamp << " UTC  " << (entry.durationNs / 1000) / 1000.0 << " ms  rows=" << entry.rows
+        << "  vm_steps=" << entry.vmSteps << "  fingerprint=" << entry.fingerprint << "\n";
+    out << "  " << entry.sql << "\n";
+    for (const std::string &line : entry.queryPlan) {
+        out << "    " << line << "\n";
+    }
+    out << "\n";
+}
@@ -0,0 +1,77 @@
+#ifndef SQLPROFILER_H
+#define SQLPROFILER_H
+
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Statement-level profiling fed by DataBase's sqlite3_trace_v2 callback.
+// Statements are grouped by fingerprint: the SQL with literals and parameter lists replaced by
+// "?" and whitespace and case normalized, so "... WHERE id = 5" and "... WHERE id = 7" count together.
+class SqlProfiler
+{
+public:
+    struct StatementStats {
+        std::string fingerprint;    // 16 hex digits
+        std::string normalizedSql;
+        uint64_t count = 0;
+        uint64_t totalNs = 0;
+        uint64_t maxNs = 0;
+        uint64_t rows = 0;
+        uint64_t vmSteps = 0;
+    };
+
+    // Distinct statements tracked; later new fingerprints are not recorded
+    static constexpr size_t MAX_STATEMENTS = 2000;
+
+    static SqlProfiler& instance();
+
+    static std::string normalize(const std::string& sql);
+    static std::string fingerprint(const std::string& normalizedSql);
+
+    // Statements slower than this go to the slow-query log (VOCAB_SLOW_QUERY_MS, default 50 ms)
+    static int slowQueryThresholdMs() { return slowThresholdMs.load(std::memory_order_relaxed); }
+    static void setSlowQueryThresholdMs(int ms) { slowThresholdMs.store(ms, std::memory_order_relaxed); }
+
+    void record(const std::string& normalizedSql, const std::string& fingerprint, uint64_t ns, uint64_t rows, uint64_t vmSteps);
+
+    // Sorted by total time, most expensive first
+    std::vector<StatementStats> topStatements(size_t limit) const;
+
+private:
+    SqlProfiler() = default;
+
+    static std::atomic<int> slowThresholdMs;
+
+    mutable std::mutex mutex;
+    std::map<std::string, StatementStats> statements;
+};
+
+// Size-rotated text log shared by all connections: <name> grows to MAX_BYTES, then moves to
+// <name>.1 (and <name>.1 to <name>.2, ...), keeping KEEP_FILES old files.
+class SlowQueryLog
+{
+public:
+    static constexpr uint64_t MAX_BYTES = 1024 * 1024;
+    static constexpr int KEEP_FILES = 3;
+
+    struct Entry {
+        std::string fingerprint;
+        std::string sql;
+        uint64_t durationNs = 0;
+        uint64_t rows = 0;
+        uint64_t vmSteps = 0;
+        std::vector<std::string> queryPlan;
+    };
+
+    static void append(const std::string& logPath, const Entry& entry);
+
+private:
+    static void rotateIfNeeded(const std::string& logPath);
+    static std::mutex mutex;
+};
+
+#endif // SQLPROFILER_H
@@ -0,0 +1,203 @@
+#include "stallwatchdog.h"
+#include "metrics.h"
+#include "tracing.h"
+#include <QDebug>
+#include <algorithm>
+#include <chrono>
+
+#ifdef Q_OS_LINUX
+#include <csignal>
+#include <cstdlib>
+#include <cxxabi.h>
+#include <execinfo.h>
+#include <pthread.h>
+#endif
+
+namespace {
+long long steadyNowNs() {
+    // Same clock as the trace spans, so a stall can be placed on the timeline
+    return static_cast<long long>(Tracer::nowNs());
+}
+
+#ifdef Q_OS_LINUX
+// The sample is taken on the UI thread itself: the watchdog signals it and the handler
+// unwinds into these buffers, which the watchdog copies and symbolizes afterwards.
+//
+// Sampling is best-effort. backtrace() is not async-signal-safe: it is warmed up in the
+// constructor so the handler does not load libgcc, but a signal landing while the UI thread is
+// itself unwinding (e.g. throwing) can still yield a truncated or missing stack. The stall report
+// never depends on it.
+const int kStackSignal = SIGUSR2;
+const int kMaxFrames = 64;
+const int kSampleWaitMs = 100;
+void* sampledFrames[kMaxFrames];
+std::atomic<int> sampledDepth{-1};
+// Sequence numbers tie the buffer to one request: the watchdog publishes the number it waits for
+// (0 = none), the handler marks which one it started and finished. A handler arriving after the
+// watchdog gave up sees 0 and leaves the buffer alone.
+std::atomic<unsigned> sampleRequested{0};
+std::atomic<unsigned> sampleStarted{0};
+std::atomic<unsigned> sampleFinished{0};
+unsigned lastSample = 0;
+pthread_t uiThread;
+struct sigaction previousAction;
+
+void sampleStackHandler(int signal, siginfo_t* info, void* context) {
+    unsigned seq = sampleRequested.load(std::memory_order_acquire);
+    if (seq == 0 || sampleStarted.load(std::memory_order_relaxed) == seq) {
+        // Not ours: hand the signal to whoever had it before
+        if (previousAction.sa_flags & SA_SIGINFO) {
+            if (previousAction.sa_sigaction) previousAction.sa_sigaction(signal, info, context);
+        } else if (previousAction.sa_handler != SIG_DFL && previousAction.sa_handler != SIG_IGN) {
+            previousAction.sa_handler(signal);
+        }
+        return;
+    }
+    sampleStarted.store(seq, std::memory_order_relaxed);
+    sampledDepth.store(backtrace(sampledFrames, kMaxFrames), std::memory_order_relaxed);
+    sampleFinished.store(seq, std::memory_order_release);
+}
+
+// "binary(_ZN10MainWindow12onDeleteListEi+0x4c) [0x...]" -> "MainWindow::onDeleteList(int)+0x4c"
+QString demangleFrame(const char* symbol) {
+    QString line = QString::fromLocal8Bit(symbol);
+    int open = line.indexOf('(');
+    int plus = line.indexOf('+', open);
+    if (open < 0 || plus < 0 || plus == open + 1) return line;
+
+    QByteArray mangled = line.mid(open + 1, plus - open - 1).toLocal8Bit();
+    int status = 0;
+    char* demangled = abi::__cxa_demangle(mangled.constData(), nullptr, nullptr, &status);
+    if (status != 0 || !demangled) return line;
+    QString pretty = QString::fromLocal8Bit(demangled) + line.mid(plus, line.indexOf(')', plus) - plus);
+    std::free(demangled);
+    return pretty;
+}
+#endif
+}
+
+StallWatchdog::StallWatchdog(QObject *parent)
+    : QObject(parent) {
+    int fromEnv = qEnvironmentVariableIntValue("VOCAB_STALL_MS");
+    if (fromEnv > 0) threshold = fromEnv;
+
+    Tracer::watchActivityOfThisThread();
+
+#ifdef Q_OS_LINUX
+    uiThread = pthread_self();
+    // backtrace() loads libgcc on first use, which must not happen inside the signal handler
+    void* warmUp[1];
+    backtrace(warmUp, 1);
+
+    struct sigaction action = {};
+    action.sa_sigaction = sampleStackHandler;
+    action.sa_flags = SA_RESTART | SA_SIGINFO;
+    sigemptyset(&action.sa_mask);
+    sigaction(kStackSignal, &action, &previousAction);
+#endif
+
+    worker = std::thread(&StallWatchdog::run, this);
+}
+
+StallWatchdog::~StallWatchdog() {
+    {
+        std::lock_guard<std::mutex> lock(waitMutex);
+        stopping = true;
+    }
+    wakeUp.notify_all();
+    worker.join();
+
+#ifdef Q_OS_LINUX
+    sampleRequested.store(0, std::memory_order_release);
+    sigaction(kStackSignal, &previousAction, nullptr);
+#endif
+}
+
+std::vector<StallWatchdog::StallReport> StallWatchdog::recentStalls() const {
+    std::lock_guard<std::mutex> lock(reportMutex);
+    return std::vector<StallReport>(reports.begin(), reports.end());
+}
+
+void StallWatchdog::onPong() {
+    pongNs.store(steadyNowNs(), std::memory_order_relaxed);
+    pingOutstanding.store(false, std::memory_order_release);
+}
+
+QStringList StallWatchdog::sampleUiStack() {
+    QStringList frames;
+#ifdef Q_OS_LINUX
+    unsigned seq = ++lastSample;
+    if (seq == 0) seq = ++lastSample;  // 0 means "no request"
+    sampleRequested.store(seq, std::memory_order_release);
+    if (pthread_kill(uiThread, kStackSignal) != 0) {
+        sampleRequested.store(0, std::memory_order_release);
+        return frames;
+    }
+
+    bool sampled = false;
+    for (int waited = 0; waited < kSampleWaitMs && !sampled; ++waited) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        sampled = sampleFinished.load(std::memory_order_acquire) == seq;
+    }
+    // From here on a late handler finds no request and does not touch the buffer
+    sampleRequested.store(0, std::memory_order_release);
+    if (!sampled) return frames;
+
+    // Symbolize a copy; only a handler for a newer request could write the shared buffer
+    void* copied[kMaxFrames];
+    int depth = std::min(sampledDepth.load(std::memory_order_relaxed), kMaxFrames);
+    for (int i = 0; i < depth; ++i) copied[i] = sampledFrames[i];
+    if (depth <= 0 || sampleStarted.load(std::memory_order_acquire) != seq) return frames;
+
+    char** symbols = backtrace_symbols(copied, depth);
+    if (!symbols) return frames;
+    // Frame 0 is the handler and frame 1 the signal trampoline
+    for (int i = 2; i < depth; ++i) frames.append(demangleFrame(symbols[i]));
+    std::free(symbols);
+#endif
+    return frames;
+}
+
+void StallWatchdog::run() {
+    static LatencyHistogram& stalls = MetricsRegistry::instance().histogram("ui.stall");
+
+    long long pingSentNs = 0;
+    bool inStall = false;
+    StallReport report;
+
+    std::unique_lock<std::mutex> lock(waitMutex);
+    while (!wakeUp.wait_for(lock, std::chrono::milliseconds(POLL_INTERVAL_MS), [this]() { return stopping; })) {
+        long long now = steadyNowNs();
+
+        if (!pingOutstanding.load(std::memory_order_acquire)) {
+            if (inStall) {
+                // The loop answered: the stall lasted from the ping to its reply
+                long long endNs = pongNs.load(std::memory_order_relaxed);
+                report.durationMs = (endNs - pingSentNs) / 1000000;
+                stalls.record(static_cast<uint64_t>((endNs - pingSentNs) / 1000));
+                if (Tracer::enabled()) Tracer::record("ui.stall", "watchdog", static_cast<uint64_t>(pingSentNs), static_cast<uint64_t>(endNs));
+
+                qWarning() << "UI stalled for" << report.durationMs << "ms in" << report.spans.join(" > ");
+                std::lock_guard<std::mutex> reportLock(reportMutex);
+                reports.push_back(report);
+                if (reports.size() > MAX_REPORTS) reports.pop_front();
+                inStall = false;
+            }
+
+            pingSentNs = now;
+            pingOutstanding.store(true, std::memory_order_release);
+            QMetaObject::invokeMethod(this, [this]() { onPong(); }, Qt::QueuedConnection);
+            continue;
+        }
+
+        if (!inStall && now - pingSentNs > static_cast<long long>(threshold) * 1000000) {
+            // Still blocked: capture what the UI thread is doing while it is doing it
+            inStall = true;
+            report = StallReport();
+            report.started = QDateTime::currentDateTime().addMSecs(-(now - pingSentNs) / 1000000);
+            for (const std::string &name : Tracer::watchedActivity()) report.spans.append(QString::fromStdString(name));
+            if (report.spans.isEmpty()) report.spans.append("(no open span)");
+            report.stack = sampleUiStack();
+        }
+    }
+}
@@ -0,0 +1,60 @@
+#ifndef STALLWATCHDOG_H
+#define STALLWATCHDOG_H
+
+#include <QObject>
+#include <QDateTime>
+#include <QStringList>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Detects UI freezes. A watchdog thread posts a ping to the event loop of the thread that created
+// this object; when the reply takes longer than the threshold, the spans open on the UI thread
+// (TRACE_SCOPE and DataBase operations) and a stack sample are captured, and once the loop answers
+// the stall duration goes into the "ui.stall" histogram and the list of recent stalls.
+class StallWatchdog : public QObject
+{
+    Q_OBJECT
+
+public:
+    static constexpr int DEFAULT_THRESHOLD_MS = 250;
+    static constexpr int POLL_INTERVAL_MS = 50;
+    static constexpr size_t MAX_REPORTS = 20;
+
+    struct StallReport {
+        QDateTime started;
+        qint64 durationMs = 0;
+        QStringList spans;   // outermost first
+        QStringList stack;   // innermost frame first; empty where sampling is unsupported or failed (best-effort)
+    };
+
+    // The threshold comes from VOCAB_STALL_MS when set
+    explicit StallWatchdog(QObject *parent = nullptr);
+    ~StallWatchdog();
+
+    int thresholdMs() const { return threshold; }
+    std::vector<StallReport> recentStalls() const;
+
+private:
+    void run();
+    void onPong();
+    static QStringList sampleUiStack();
+
+    int threshold = DEFAULT_THRESHOLD_MS;
+
+    std::thread worker;
+    std::mutex waitMutex;
+    std::condition_variable wakeUp;
+    bool stopping = false;
+
+    std::atomic<bool> pingOutstanding{false};
+    std::atomic<long long> pongNs{0};
+
+    mutable std::mutex reportMutex;
+    std::deque<StallReport> reports;
+};
+
+#endif // STALLWATCHDOG_H
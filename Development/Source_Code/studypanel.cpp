@@ -1,12 +1,30 @@
 #include "studypanel.h"
 #include "ui_studypanel.h"
 #include "spacedrepetitioncalculator.h"
+#include "loadbalancer.h"
+#include "metrics.h"
+#include "tracing.h"
 #include <QMessageBox>
+#include <QDebug>
 #include <QTimer>
 #include <QStyle>
 #include <random>
 #include <algorithm>
 #include <ctime>
+#include <cmath>
+
+namespace {
+// Whole days since the card's last review: its interval plus however long it has been overdue
+double elapsedDaysSinceReview(const DataBase::DueCard& card)
+{
+    struct tm due = {};
+    if (card.next_review_date.empty() || !strptime(card.next_review_date.c_str(), "%Y-%m-%d %H:%M:%S", &due)) {
+        return card.interval_days;
+    }
+    double overdueDays = std::difftime(std::time(nullptr), timegm(&due)) / 86400.0;
+    return std::floor(card.interval_days + std::max(0.0, overdueDays));
+}
+}
 
 StudyPanel::StudyPanel(DataBase* database, QWidget *parent)
     : QWidget(parent)
@@ -50,6 +68,7 @@ StudyPanel::~StudyPanel()
 
 void StudyPanel::setStudyCards(const std::vector<DataBase::DueCard>& cards, StudyMode mode)
 {
+    TRACE_SCOPE("StudyPanel::setStudyCards");
     studyCards = cards;
     studyMode = mode;
     currentCardIndex = 0;
@@ -60,6 +79,18 @@ void StudyPanel::setStudyCards(const std::vector<DataBase::DueCard>& cards, Stud
     }
 }
 
+void StudyPanel::setFsrsParams(const Fsrs::Params& params)
+{
+    fsrs = Fsrs::Scheduler(params);
+}
+
+void StudyPanel::setDeckScheduling(int listID, bool useFsrs, const Scheduling::PolicyConfig& sm2Policy)
+{
+    DeckScheduling &deck = deckScheduling[listID];
+    deck.useFsrs = useFsrs;
+    deck.sm2Policy = sm2Policy;
+}
+
 void StudyPanel::showCurrentCard()
 {
     if (currentCardIndex >= studyCards.size()) {
@@ -68,6 +99,9 @@ void StudyPanel::showCurrentCard()
         emit studyCompleted();
         return;
     }
+    // Timed after the completion dialog so a modal wait is not counted
+    METRICS_SCOPE("ui.study.showCurrentCard");
+    TRACE_SCOPE("StudyPanel::showCurrentCard");
 
     const auto &c = studyCards[currentCardIndex];
     ui->studyWordLabel->setText(QString::fromStdString(c.word));
@@ -123,7 +157,18 @@ void StudyPanel::showCurrentCard()
         options.push_back(correctText);
 
         try {
-            auto distractors = db->getRandomWordsInList(currentStudyListID, c.word_id, 3);
+            // Prefer the precomputed confusable distractors; fall back to random words while
+            // the background builder has not covered this word yet.
+            auto distractors = db->getDistractors(currentStudyListID, c.word_id, 3);
+            if (distractors.size() < 3) {
+                auto randomWords = db->getRandomWordsInList(currentStudyListID, c.word_id, 3);
+                for (auto &p : randomWords) {
+                    if (distractors.size() >= 3) break;
+                    bool alreadyUsed = std::any_of(distractors.begin(), distractors.end(),
+                                                   [&p](const std::pair<int, std::string>& d) { return d.first == p.first; });
+                    if (!alreadyUsed) distractors.push_back(p);
+                }
+            }
             for (auto &p : distractors) {
                 std::string d = p.second.empty() ? std::string("") : p.second;
                 if (d.empty()) d = std::to_string(p.first);
@@ -187,6 +232,7 @@ void StudyPanel::showCurrentCard()
 
 void StudyPanel::updateAdditionalInfo(int word_id)
 {
+    TRACE_SCOPE("StudyPanel::updateAdditionalInfo");
     try {
         // Get examples and notes
         auto examples = db->getWordExamples(word_id);
@@ -219,21 +265,49 @@ void StudyPanel::updateAdditionalInfo(int word_id)
 
 void StudyPanel::applyRating(int quality)
 {
+    METRICS_SCOPE("ui.study.applyRating");
+    TRACE_SCOPE("StudyPanel::applyRating");
     if (currentCardIndex >= studyCards.size()) return;
     const auto &c = studyCards[currentCardIndex];
 
     // In random practice mode, don't update review schedule
     if (!isRandomPractice) {
+        auto deckIt = deckScheduling.find(c.list_id);
+        DeckScheduling deck = deckIt != deckScheduling.end() ? deckIt->second : DeckScheduling();
+
         // prepare calculator with current schedule
         SpacedRepetitionCalculator calc;
+        calc.setPolicy(deck.sm2Policy);
         calc.setEasinessFactor(c.ease_factor);
         calc.setRepetitions(c.repetition_count);
         calc.setInterval(c.interval_days);
 
         calc.calculateNextReview(quality);
+        int repetitions = calc.getRepetitions();
+        int interval = calc.getInterval();
+
+        // The memory state is tracked on SM-2 decks too, so switching a deck to FSRS keeps its history
+        Fsrs::MemoryState state = fsrs.nextState({c.fsrs_stability, c.fsrs_difficulty}, elapsedDaysSinceReview(c),
+                                                 Fsrs::ratingFromQuality(quality));
+        if (deck.useFsrs) {
+            interval = fsrs.nextIntervalDays(state.stability);
+            repetitions = quality < 3 ? 0 : c.repetition_count + 1;
+        }
+
+        // Move the review to the least busy day near the interval so cards learned together drift apart
+        time_t now = std::time(nullptr);
+        Scheduling::FuzzWindow window = Scheduling::fuzzWindow(interval);
+        if (window.size() > 1) {
+            try {
+                long long today = static_cast<long long>(now) / 86400;
+                interval = Scheduling::leastLoadedInterval(interval, window, db->getDueLoad(today + window.minDays, window.size()));
+            } catch (const std::exception &ex) {
+                qWarning() << "Due load unavailable, keeping the exact interval:" << ex.what();
+            }
+        }
+        time_t nextT = now + static_cast<time_t>(interval) * 86400;
 
         // build next_review datetime string in format YYYY-MM-DD HH:MM:SS
-        time_t nextT = calc.getNextReview();
         struct tm tm;
         gmtime_r(&nextT, &tm);
         char buf[64];
@@ -243,7 +317,8 @@ void StudyPanel::applyRating(int quality)
         // update DB
         bool was_correct = quality >= 3;
         try {
-            db->updateReviewScheduleForWord(c.word_id, c.list_id, calc.getRepetitions(), calc.getInterval(), calc.getEasinessFactor(), nextReviewStr);
+            db->updateReviewScheduleForWord(c.word_id, c.list_id, repetitions, interval, calc.getEasinessFactor(), nextReviewStr,
+                                            state.stability, state.difficulty);
             std::string modeStr = (studyMode == StudyMode::Flashcard) ? "flashcard" : "multiple_choice";
             db->recordStudySession(c.word_id, c.list_id, was_correct, quality, modeStr);
         } catch (const std::exception &ex) {
@@ -254,7 +329,7 @@ void StudyPanel::applyRating(int quality)
         bool was_correct = quality >= 3;
         try {
             std::string modeStr = (studyMode == StudyMode::Flashcard) ? "flashcard" : "multiple_choice";
-            db->recordStudySession(c.word_id, c.list_id, was_correct, quality, modeStr);
+            db->recordStudySession(c.word_id, c.list_id, was_correct, quality, modeStr, false);
         } catch (const std::exception &ex) {
             QMessageBox::critical(this, "DB Error", QString::fromStdString(ex.what()));
         }
@@ -3,8 +3,11 @@
 
 #include <QWidget>
 #include <QPushButton>
+#include <map>
 #include <vector>
 #include "database.h"
+#include "fsrs.h"
+#include "schedulerpolicy.h"
 
 namespace Ui {
 class StudyPanel;
@@ -27,6 +30,11 @@ public:
     void setStudyCards(const std::vector<DataBase::DueCard>& cards, StudyMode mode);
     void showCurrentCard();
     void setRandomPracticeMode(bool isRandom) { isRandomPractice = isRandom; }
+    // Weights used for cards of decks on FSRS
+    void setFsrsParams(const Fsrs::Params& params);
+    // A session may mix decks (catch-up); each card is scheduled by its own deck's choice.
+    // Decks not set here use classic SM-2.
+    void setDeckScheduling(int listID, bool useFsrs, const Scheduling::PolicyConfig& sm2Policy);
 
 signals:
     void studyCompleted();
@@ -56,6 +64,12 @@ private:
     int typingAttempts;
     bool showingExample;
     int currentStudyListID;
+    struct DeckScheduling {
+        bool useFsrs = false;
+        Scheduling::PolicyConfig sm2Policy;
+    };
+    std::map<int, DeckScheduling> deckScheduling;
+    Fsrs::Scheduler fsrs;
 };
 
 #endif // STUDYPANEL_H
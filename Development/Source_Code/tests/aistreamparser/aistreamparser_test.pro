@@ -0,0 +1,17 @@
+QT       += core testlib
+QT       -= gui
+
+CONFIG += c++17 console testcase
+CONFIG -= app_bundle
+
+TARGET = aistreamparser_test
+
+APP_SRC = $$PWD/../..
+INCLUDEPATH += $$APP_SRC
+
+SOURCES += \
+    tst_aistreamparser.cpp \
+    $$APP_SRC/aistreamparser.cpp
+
+HEADERS += \
+    $$APP_SRC/aistreamparser.h
@@ -0,0 +1,194 @@
+#include <QtTest>
+#include "aistreamparser.h"
+
+// Covers the pieces of the streaming response path that have to cope with arbitrary read
+// boundaries: the server-sent events framing and the JSON array the model writes token by token.
+// Run with `qmake && make check` from this directory.
+class AiStreamParserTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void sseSingleEvent();
+    void sseEventSplitAcrossReads();
+    void sseEveryByteSeparately();
+    void sseCrlfLineEndings();
+    void sseMultiLineData();
+    void sseIgnoresCommentsAndOtherFields();
+    void sseDonePassesThrough();
+    void sseReset();
+
+    void jsonObjectsFromArray();
+    void jsonBracesInsideStrings();
+    void jsonEscapedQuotes();
+    void jsonObjectSplitAcrossDeltas();
+    void jsonEveryCharacterSeparately();
+    void jsonNestedObjectsStayWhole();
+    void jsonSkipsProseAroundArray();
+    void jsonReset();
+};
+
+namespace {
+// Feeds the pieces in order and collects everything the parser returned
+QList<QByteArray> feedAll(SseParser& parser, const QList<QByteArray>& pieces) {
+    QList<QByteArray> events;
+    for (const QByteArray& piece : pieces) events.append(parser.feed(piece));
+    return events;
+}
+
+QList<QJsonObject> feedAll(JsonObjectStreamExtractor& extractor, const QStringList& pieces) {
+    QList<QJsonObject> objects;
+    for (const QString& piece : pieces) objects.append(extractor.feed(piece));
+    return objects;
+}
+}
+
+void AiStreamParserTest::sseSingleEvent() {
+    SseParser parser;
+    QList<QByteArray> events = parser.feed("data: {\"a\":1}\n\n");
+    QCOMPARE(events.size(), 1);
+    QCOMPARE(events.at(0), QByteArray("{\"a\":1}"));
+}
+
+void AiStreamParserTest::sseEventSplitAcrossReads() {
+    SseParser parser;
+    // Nothing is returned until the blank line that ends the event arrives
+    QVERIFY(parser.feed("da").isEmpty());
+    QVERIFY(parser.feed("ta: {\"x\":").isEmpty());
+    QVERIFY(parser.feed("2}\n").isEmpty());
+    QList<QByteArray> events = parser.feed("\ndata: second\n\nda");
+    QCOMPARE(events.size(), 2);
+    QCOMPARE(events.at(0), QByteArray("{\"x\":2}"));
+    QCOMPARE(events.at(1), QByteArray("second"));
+
+    events = parser.feed("ta: third\n\n");
+    QCOMPARE(events.size(), 1);
+    QCOMPARE(events.at(0), QByteArray("third"));
+}
+
+void AiStreamParserTest::sseEveryByteSeparately() {
+    QByteArray stream = "data: one\r\n\r\ndata: two\n\n";
+    QList<QByteArray> pieces;
+    for (char c : stream) pieces.append(QByteArray(1, c));
+
+    SseParser parser;
+    QCOMPARE(feedAll(parser, pieces), QList<QByteArray>({"one", "two"}));
+}
+
+void AiStreamParserTest::sseCrlfLineEndings() {
+    SseParser parser;
+    // The CR and LF of one line ending arrive in different reads
+    QList<QByteArray> events = feedAll(parser, {"data: first\r", "\n\r", "\ndata: second\r\n\r\n"});
+    QCOMPARE(events, QList<QByteArray>({"first", "second"}));
+}
+
+void AiStreamParserTest::sseMultiLineData() {
+    SseParser parser;
+    QList<QByteArray> events = parser.feed("data: line one\ndata:line two\ndata: \n\n");
+    QCOMPARE(events.size(), 1);
+    // Lines are joined with \n; only a single space after the colon is dropped
+    QCOMPARE(events.at(0), QByteArray("line one\nline two\n"));
+}
+
+void AiStreamParserTest::sseIgnoresCommentsAndOtherFields() {
+    SseParser parser;
+    QList<QByteArray> events = parser.feed(": keep-alive\n\nevent: message\nid: 7\nretry: 100\ndata: payload\n\n");
+    // The comment-only block has no data and dispatches nothing
+    QCOMPARE(events, QList<QByteArray>({"payload"}));
+}
+
+void AiStreamParserTest::sseDonePassesThrough() {
+    SseParser parser;
+    QList<QByteArray> events = feedAll(parser, {"data: {\"choices\":[]}\n\ndata: [DO", "NE]\n\n"});
+    QCOMPARE(events, QList<QByteArray>({"{\"choices\":[]}", "[DONE]"}));
+}
+
+void AiStreamParserTest::sseReset() {
+    SseParser parser;
+    QVERIFY(parser.feed("data: stale\n").isEmpty());
+    parser.reset();
+    QCOMPARE(parser.feed("data: fresh\n\n"), QList<QByteArray>({"fresh"}));
+}
+
+void AiStreamParserTest::jsonObjectsFromArray() {
+    JsonObjectStreamExtractor extractor;
+    QList<QJsonObject> objects = extractor.feed("[{\"word\": \"a\"}, {\"word\": \"b\"}]");
+    QCOMPARE(objects.size(), 2);
+    QCOMPARE(objects.at(0).value("word").toString(), QString("a"));
+    QCOMPARE(objects.at(1).value("word").toString(), QString("b"));
+}
+
+void AiStreamParserTest::jsonBracesInsideStrings() {
+    JsonObjectStreamExtractor extractor;
+    QList<QJsonObject> objects = extractor.feed("[{\"word\": \"}{\", \"definition\": \"a {b} c }\"}]");
+    QCOMPARE(objects.size(), 1);
+    QCOMPARE(objects.at(0).value("word").toString(), QString("}{"));
+    QCOMPARE(objects.at(0).value("definition").toString(), QString("a {b} c }"));
+}
+
+void AiStreamParserTest::jsonEscapedQuotes() {
+    JsonObjectStreamExtractor extractor;
+    // An escaped quote does not end the string, an escaped backslash before a quote does
+    QList<QJsonObject> objects = extractor.feed(R"([{"word": "say \"}\"", "definition": "back\\"}, {"word": "next"}])");
+    QCOMPARE(objects.size(), 2);
+    QCOMPARE(objects.at(0).value("word").toString(), QString("say \"}\""));
+    QCOMPARE(objects.at(0).value("definition").toString(), QString("back\\"));
+    QCOMPARE(objects.at(1).value("word").toString(), QString("next"));
+}
+
+void AiStreamParserTest::jsonObjectSplitAcrossDeltas() {
+    JsonObjectStreamExtractor extractor;
+    // Split inside a key, between a backslash and the quote it escapes, and before the closing brace
+    QVERIFY(extractor.feed("[{\"wo").isEmpty());
+    QVERIFY(extractor.feed("rd\": \"a \\").isEmpty());
+    QVERIFY(extractor.feed("\"b\\\"\", \"definition\": \"{\"").isEmpty());
+    QList<QJsonObject> objects = extractor.feed("}, {\"word\":");
+    QCOMPARE(objects.size(), 1);
+    QCOMPARE(objects.at(0).value("word").toString(), QString("a \"b\""));
+    QCOMPARE(objects.at(0).value("definition").toString(), QString("{"));
+
+    objects = extractor.feed(" \"c\"}]");
+    QCOMPARE(objects.size(), 1);
+    QCOMPARE(objects.at(0).value("word").toString(), QString("c"));
+}
+
+void AiStreamParserTest::jsonEveryCharacterSeparately() {
+    QString text = R"([{"word": "x\"}", "examples": [{"text": "{}"}]}, {"word": "y"}])";
+    QStringList pieces;
+    for (QChar c : text) pieces.append(QString(c));
+
+    JsonObjectStreamExtractor extractor;
+    QList<QJsonObject> objects = feedAll(extractor, pieces);
+    QCOMPARE(objects.size(), 2);
+    QCOMPARE(objects.at(0).value("word").toString(), QString("x\"}"));
+    QCOMPARE(objects.at(1).value("word").toString(), QString("y"));
+}
+
+void AiStreamParserTest::jsonNestedObjectsStayWhole() {
+    JsonObjectStreamExtractor extractor;
+    QList<QJsonObject> objects = extractor.feed(R"([{"id": 1, "examples": [{"text": "a"}, {"text": "b"}]}])");
+    // Only the top-level object is returned, with its nested objects inside it
+    QCOMPARE(objects.size(), 1);
+    QCOMPARE(objects.at(0).value("id").toInt(), 1);
+    QCOMPARE(objects.at(0).value("examples").toArray().size(), 2);
+}
+
+void AiStreamParserTest::jsonSkipsProseAroundArray() {
+    JsonObjectStreamExtractor extractor;
+    QList<QJsonObject> objects = extractor.feed("Here you go: \"list\"\n```json\n[{\"word\": \"a\"}]\n```");
+    QCOMPARE(objects.size(), 1);
+    QCOMPARE(objects.at(0).value("word").toString(), QString("a"));
+}
+
+void AiStreamParserTest::jsonReset() {
+    JsonObjectStreamExtractor extractor;
+    QVERIFY(extractor.feed("[{\"word\": \"unfinished").isEmpty());
+    extractor.reset();
+    QList<QJsonObject> objects = extractor.feed("[{\"word\": \"b\"}]");
+    QCOMPARE(objects.size(), 1);
+    QCOMPARE(objects.at(0).value("word").toString(), QString("b"));
+}
+
+QTEST_APPLESS_MAIN(AiStreamParserTest)
+
+#include "tst_aistreamparser.moc"
@@ -0,0 +1,28 @@
+QT       += core testlib
+QT       -= gui
+
+CONFIG += c++17 console testcase
+CONFIG -= app_bundle
+
+TARGET = listpurge_test
+
+APP_SRC = $$PWD/../..
+INCLUDEPATH += $$APP_SRC
+
+SOURCES += \
+    tst_listpurge.cpp \
+    $$APP_SRC/database.cpp \
+    $$APP_SRC/fsrs.cpp \
+    $$APP_SRC/metrics.cpp \
+    $$APP_SRC/querycache.cpp \
+    $$APP_SRC/sqlprofiler.cpp \
+    $$APP_SRC/tracing.cpp \
+    $$APP_SRC/sqlite3.c
+
+HEADERS += \
+    $$APP_SRC/database.h \
+    $$APP_SRC/fsrs.h \
+    $$APP_SRC/metrics.h \
+    $$APP_SRC/querycache.h \
+    $$APP_SRC/sqlprofiler.h \
+    $$APP_SRC/tracing.h
@@ -0,0 +1,79 @@
+#include <QtTest>
+#include <QTemporaryDir>
+#include "database.h"
+
+// Deleting a list only hides it; ListPurgeWorker removes its rows later in batches.
+// Words added to another list in between must still end up scheduled there.
+// Run with `qmake && make check` from this directory.
+class ListPurgeTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void init();
+    void readdedWordKeepsScheduleAfterPurge();
+    void liveListKeepsItsSchedule();
+
+private:
+    void purge(DataBase& db, int listID);
+
+    QTemporaryDir dir;
+    std::string dbPath;
+};
+
+void ListPurgeTest::init() {
+    QVERIFY(dir.isValid());
+    dbPath = (dir.path() + "/" + QTest::currentTestFunction() + ".db").toStdString();
+}
+
+void ListPurgeTest::purge(DataBase& db, int listID) {
+    bool finished = false;
+    for (int batches = 0; !finished && batches < 100; ++batches) db.purgeDeletedListBatch(listID, 2, finished);
+    QVERIFY(finished);
+}
+
+void ListPurgeTest::readdedWordKeepsScheduleAfterPurge() {
+    DataBase db(dbPath);
+    QVERIFY(db.createNewList("Fruit", "en", ""));
+    int oldList = db.getListId("Fruit");
+    int wordID = db.addWordAndSetup(oldList, "apple", "", "a fruit");
+    db.addWordAndSetup(oldList, "pear", "", "another fruit");
+    // Studied in the old list, so its row is not due
+    db.updateReviewScheduleForWord(wordID, oldList, 3, 10, 2.3, "2099-01-01 00:00:00");
+
+    db.deleteList(oldList);
+    QVERIFY(db.createNewList("Fruit", "en", ""));
+    int newList = db.getListId("Fruit");
+    QVERIFY(newList != oldList);
+    db.addWordAndSetup(newList, "apple", "", "a fruit");
+
+    // Before the purge the row already belongs to the new list, with a fresh schedule
+    QCOMPARE(db.getNewCardCount(newList), 1);
+    QCOMPARE(db.getReviewCardCount(newList), 1);
+
+    purge(db, oldList);
+    QCOMPARE(db.getNewCardCount(newList), 1);
+    QCOMPARE(db.getReviewCardCount(newList), 1);
+    QCOMPARE(static_cast<int>(db.getDueCards(newList).size()), 1);
+    QCOMPARE(db.countListRows(oldList), 0);
+}
+
+void ListPurgeTest::liveListKeepsItsSchedule() {
+    DataBase db(dbPath);
+    QVERIFY(db.createNewList("First", "en", ""));
+    QVERIFY(db.createNewList("Second", "en", ""));
+    int first = db.getListId("First");
+    int second = db.getListId("Second");
+    int wordID = db.addWordAndSetup(first, "apple", "", "a fruit");
+    db.updateReviewScheduleForWord(wordID, first, 3, 10, 2.3, "2099-01-01 00:00:00");
+
+    // A word scheduled in a visible list is not taken over by another one
+    db.addWordAndSetup(second, "apple", "", "a fruit");
+    QCOMPARE(db.getReviewCardCount(second), 0);
+    QCOMPARE(db.getNewCardCount(first), 0);
+    QCOMPARE(db.getNewCardCount(second), 0);
+}
+
+QTEST_APPLESS_MAIN(ListPurgeTest)
+
+#include "tst_listpurge.moc"
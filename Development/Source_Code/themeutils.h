@@ -1,22 +1,35 @@
 #ifndef THEMEUTILS_H
 #define THEMEUTILS_H
 
+#include <QApplication>
+#include <QColor>
+#include <QPalette>
 #include <QString>
 
+// Light and dark themes. Window and text colours live in a QPalette; the stylesheets only
+// hold the rules the palette cannot express. Both are applied once to the whole application,
+// so windows and dialogs inherit them instead of setting (and re-parsing) their own copy.
 class ThemeUtils
 {
 public:
-    static QString getLightTheme() {
-        return R"(
-            QDialog, QMainWindow {
-                background-color: #ffffff;
-            }
-            
-            QWidget {
-                background-color: #ffffff;
-                color: #2c3e50;
-            }
-            
+    static void applyTheme(bool isDark) {
+        qApp->setPalette(isDark ? darkPalette() : lightPalette());
+        qApp->setStyleSheet(isDark ? getDarkTheme() : getLightTheme());
+    }
+
+    static QPalette lightPalette() {
+        return makePalette(QColor("#ffffff"), QColor("#2c3e50"), QColor("#ffffff"), QColor("#ecf0f1"),
+                           QColor("#3498db"), QColor("#95a5a6"));
+    }
+
+    static QPalette darkPalette() {
+        return makePalette(QColor("#1e1e1e"), QColor("#e0e0e0"), QColor("#252526"), QColor("#2d2d30"),
+                           QColor("#007acc"), QColor("#656565"));
+    }
+
+    // Widget-specific rules on top of the palette; built once per process
+    static const QString& getLightTheme() {
+        static const QString sheet = R"(
             QPushButton {
                 background-color: #ecf0f1;
                 color: #2c3e50;
@@ -183,19 +196,11 @@ public:
                 color: #ffffff;
             }
         )";
+        return sheet;
     }
 
-    static QString getDarkTheme() {
-        return R"(
-            QDialog, QMainWindow {
-                background-color: #1e1e1e;
-            }
-            
-            QWidget {
-                background-color: #1e1e1e;
-                color: #e0e0e0;
-            }
-            
+    static const QString& getDarkTheme() {
+        static const QString sheet = R"(
             QPushButton {
                 background-color: #2d2d30;
                 color: #e0e0e0;
@@ -365,6 +370,28 @@ public:
                 color: #ffffff;
             }
         )";
+        return sheet;
+    }
+
+private:
+    static QPalette makePalette(const QColor& window, const QColor& text, const QColor& base,
+                                const QColor& button, const QColor& highlight, const QColor& disabledText) {
+        QPalette p;
+        p.setColor(QPalette::Window, window);
+        p.setColor(QPalette::WindowText, text);
+        p.setColor(QPalette::Base, base);
+        p.setColor(QPalette::AlternateBase, button);
+        p.setColor(QPalette::Text, text);
+        p.setColor(QPalette::Button, button);
+        p.setColor(QPalette::ButtonText, text);
+        p.setColor(QPalette::ToolTipBase, base);
+        p.setColor(QPalette::ToolTipText, text);
+        p.setColor(QPalette::Highlight, highlight);
+        p.setColor(QPalette::HighlightedText, QColor("#ffffff"));
+        p.setColor(QPalette::Disabled, QPalette::WindowText, disabledText);
+        p.setColor(QPalette::Disabled, QPalette::Text, disabledText);
+        p.setColor(QPalette::Disabled, QPalette::ButtonText, disabledText);
+        return p;
     }
 };
 
@@ -0,0 +1,30 @@
+QT       += core network
+QT       -= gui
+
+CONFIG += c++17 console
+CONFIG -= app_bundle
+
+TARGET = ai_generation_bench
+
+APP_SRC = $$PWD/../..
+INCLUDEPATH += $$APP_SRC
+
+SOURCES += \
+    main.cpp \
+    $$APP_SRC/aistreamparser.cpp \
+    $$APP_SRC/aivocabgenerator.cpp \
+    $$APP_SRC/database.cpp \
+    $$APP_SRC/metrics.cpp \
+    $$APP_SRC/querycache.cpp \
+    $$APP_SRC/sqlprofiler.cpp \
+    $$APP_SRC/tracing.cpp \
+    $$APP_SRC/sqlite3.c
+
+HEADERS += \
+    $$APP_SRC/aistreamparser.h \
+    $$APP_SRC/aivocabgenerator.h \
+    $$APP_SRC/database.h \
+    $$APP_SRC/metrics.h \
+    $$APP_SRC/querycache.h \
+    $$APP_SRC/sqlprofiler.h \
+    $$APP_SRC/tracing.h
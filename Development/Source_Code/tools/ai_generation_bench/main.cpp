@@ -0,0 +1,138 @@
+// End-to-end benchmark for AI list generation: request -> words committed in the DataBase.
+// Runs against whatever OPENAI_BASE_URL points at, normally tools/mock_llm_server:
+//
+//   mock_llm_server --latency-ms 300 --tokens-per-sec 400 &
+//   OPENAI_BASE_URL=http://127.0.0.1:8089/v1 ai_generation_bench --words 500 --concurrency 4 --runs 10
+//
+// Every run writes into a fresh temporary database through the same batched
+// DataBase::addWordsAndSetup path as AICreateWindow (INSERT_BATCH_SIZE words per
+// transaction, the rest flushed when the run finishes) and reports time to the first
+// committed word, time to the last one and words/s, followed by p50/p90/p99.
+
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <QEventLoop>
+#include <QTemporaryDir>
+#include <QDebug>
+#include <algorithm>
+#include <vector>
+#include "aivocabgenerator.h"
+#include "database.h"
+
+namespace {
+
+struct RunResult {
+    qint64 firstWordMs = -1;
+    qint64 totalMs = 0;
+    int wordsInDb = 0;
+};
+
+double percentile(std::vector<double> values, double p) {
+    if (values.empty()) return 0.0;
+    std::sort(values.begin(), values.end());
+    size_t idx = static_cast<size_t>(p * (values.size() - 1) + 0.5);
+    return values[std::min(idx, values.size() - 1)];
+}
+
+RunResult runOnce(DataBase& db, int run, int words, int concurrency, int chunkSize, bool stream) {
+    RunResult result;
+    std::string listName = "bench-" + std::to_string(run);
+    db.createNewList(listName, "", "benchmark");
+    int listID = db.getListId(listName);
+
+    AIVocabGenerator generator;
+    generator.setApiKey("benchmark");
+    generator.setMaxConcurrentRequests(concurrency);
+    generator.setChunkSize(chunkSize);
+    generator.setBaseBackoffMs(100);
+
+    QElapsedTimer timer;
+    QEventLoop loop;
+    std::vector<DataBase::NewWord> pending;
+    auto flush = [&]() {
+        if (pending.empty()) return;
+        db.addWordsAndSetup(listID, pending);
+        pending.clear();
+        if (result.firstWordMs < 0) result.firstWordMs = timer.elapsed();
+    };
+    QObject::connect(&generator, &AIVocabGenerator::entriesReady, [&](const QVector<AIVocabEntry>& entries) {
+        for (const auto &e : entries) {
+            pending.push_back(DataBase::NewWord{e.word.toStdString(), "", e.definition.toStdString(), ""});
+        }
+        if (pending.size() >= static_cast<size_t>(AIVocabGenerator::INSERT_BATCH_SIZE)) flush();
+    });
+    QObject::connect(&generator, &AIVocabGenerator::finished, [&](bool success, const QString& error) {
+        flush();
+        result.totalMs = timer.elapsed();
+        if (!success || !error.isEmpty()) qWarning() << "run" << run << "error:" << error;
+        loop.quit();
+    });
+
+    AIVocabRequest request;
+    request.model = "gpt-4o-mini";
+    request.listName = QString::fromStdString(listName);
+    request.wordCount = words;
+    request.stream = stream;
+
+    timer.start();
+    generator.start(request);
+    loop.exec();
+
+    result.wordsInDb = static_cast<int>(db.getWordsInList(listID).size());
+    return result;
+}
+
+}
+
+int main(int argc, char *argv[]) {
+    QCoreApplication app(argc, argv);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("End-to-end AI generation benchmark (request -> words in DB)");
+    parser.addHelpOption();
+    QCommandLineOption runsOpt("runs", "Number of generations.", "n", "10");
+    QCommandLineOption wordsOpt("words", "Words requested per generation.", "n", "500");
+    QCommandLineOption concurrencyOpt("concurrency", "Parallel requests (at most 6).", "n", QString::number(AIVocabGenerator::DEFAULT_MAX_CONCURRENT));
+    QCommandLineOption chunkOpt("chunk-size", "Words per request.", "n", QString::number(AIVocabGenerator::DEFAULT_CHUNK_SIZE));
+    QCommandLineOption noStreamOpt("no-stream", "Use non-streaming requests.");
+    parser.addOptions({runsOpt, wordsOpt, concurrencyOpt, chunkOpt, noStreamOpt});
+    parser.process(app);
+
+    int runs = parser.value(runsOpt).toInt();
+    int words = parser.value(wordsOpt).toInt();
+    int concurrency = parser.value(concurrencyOpt).toInt();
+    int chunkSize = parser.value(chunkOpt).toInt();
+    bool stream = !parser.isSet(noStreamOpt);
+
+    QTemporaryDir dir;
+    if (!dir.isValid()) {
+        qCritical() << "Cannot create temporary directory";
+        return 1;
+    }
+    DataBase db(dir.filePath("bench.db").toStdString());
+
+    qInfo().noquote() << "Endpoint:" << AIVocabGenerator::defaultEndpoint().toString()
+                      << QString("| %1 words, concurrency %2, chunk %3, %4").arg(words).arg(concurrency).arg(chunkSize).arg(stream ? "streaming" : "non-streaming");
+
+    std::vector<double> firstWord, total, throughput;
+    for (int run = 0; run < runs; ++run) {
+        RunResult r = runOnce(db, run, words, concurrency, chunkSize, stream);
+        double wps = r.totalMs > 0 ? 1000.0 * r.wordsInDb / r.totalMs : 0.0;
+        qInfo().noquote() << QString("run %1: first word %2 ms, complete %3 ms, %4 words in DB, %5 words/s")
+                             .arg(run).arg(r.firstWordMs).arg(r.totalMs).arg(r.wordsInDb).arg(wps, 0, 'f', 1);
+        if (r.firstWordMs >= 0) firstWord.push_back(static_cast<double>(r.firstWordMs));
+        total.push_back(static_cast<double>(r.totalMs));
+        throughput.push_back(wps);
+    }
+
+    auto report = [](const char* name, const std::vector<double>& v) {
+        qInfo().noquote() << QString("%1: p50 %2  p90 %3  p99 %4")
+                             .arg(name).arg(percentile(v, 0.50), 0, 'f', 1).arg(percentile(v, 0.90), 0, 'f', 1).arg(percentile(v, 0.99), 0, 'f', 1);
+    };
+    report("time to first word (ms)", firstWord);
+    report("time to complete (ms)  ", total);
+    report("throughput (words/s)   ", throughput);
+
+    return 0;
+}
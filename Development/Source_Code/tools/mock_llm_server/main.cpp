@@ -0,0 +1,221 @@
+// Local stand-in for the chat-completions endpoint used by AIVocabGenerator, so AI
+// generation can be load-tested and regression-tested offline.
+//
+//   mock_llm_server [--port 8089] [--latency-ms 300] [--tokens-per-sec 400]
+//                   [--fail-rate 0.0] [--canned entries.json]
+//
+// Point the app (or tools/ai_generation_bench) at it with
+//   OPENAI_BASE_URL=http://127.0.0.1:8089/v1
+//
+// Requests with "stream": true are answered as server-sent events, one delta per token
+// (~4 characters) at --tokens-per-sec; other requests get the whole body once the same
+// amount of "generation time" has passed. --latency-ms is added before the first byte.
+// Words are synthetic and unique ("mockword123") unless --canned gives a JSON array of
+// {"word", "definition"} objects to serve round-robin.
+
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QTimer>
+#include <QFile>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonArray>
+#include <QRegularExpression>
+#include <QRandomGenerator>
+#include <QDebug>
+#include <memory>
+
+namespace {
+
+struct Options {
+    int latencyMs = 300;
+    double tokensPerSec = 400.0;
+    double failRate = 0.0;
+    QJsonArray canned;
+};
+
+const int kCharsPerToken = 4;
+const int kTickMs = 20;
+
+class MockServer
+{
+public:
+    explicit MockServer(const Options& options) : opts(options) {}
+
+    bool listen(quint16 port) {
+        QObject::connect(&server, &QTcpServer::newConnection, [this]() {
+            while (QTcpSocket* socket = server.nextPendingConnection()) {
+                accept(socket);
+            }
+        });
+        return server.listen(QHostAddress::LocalHost, port);
+    }
+
+private:
+    void accept(QTcpSocket* socket) {
+        auto buffer = std::make_shared<QByteArray>();
+        auto handled = std::make_shared<bool>(false);
+        QObject::connect(socket, &QTcpSocket::disconnected, socket, &QObject::deleteLater);
+        QObject::connect(socket, &QTcpSocket::readyRead, socket, [this, socket, buffer, handled]() {
+            // One request per connection; the response always closes it
+            if (*handled) return;
+            buffer->append(socket->readAll());
+            int headerEnd = buffer->indexOf("\r\n\r\n");
+            if (headerEnd < 0) return;
+
+            QRegularExpression lengthRe("content-length:\\s*(\\d+)", QRegularExpression::CaseInsensitiveOption);
+            auto match = lengthRe.match(QString::fromLatin1(buffer->left(headerEnd)));
+            int contentLength = match.hasMatch() ? match.captured(1).toInt() : 0;
+            if (buffer->size() < headerEnd + 4 + contentLength) return;
+
+            QByteArray body = buffer->mid(headerEnd + 4, contentLength);
+            buffer->clear();
+            *handled = true;
+            respond(socket, QJsonDocument::fromJson(body).object());
+        });
+    }
+
+    QString nextContent(int count) {
+        QJsonArray entries;
+        for (int i = 0; i < count; ++i) {
+            if (!opts.canned.isEmpty()) {
+                entries.append(opts.canned.at(cannedCursor++ % opts.canned.size()));
+            } else {
+                int n = ++wordCounter;
+                QJsonObject o;
+                o["word"] = QString("mockword%1").arg(n);
+                o["definition"] = QString("definition of mock word %1").arg(n);
+                entries.append(o);
+            }
+        }
+        return QString::fromUtf8(QJsonDocument(entries).toJson(QJsonDocument::Compact));
+    }
+
+    static int requestedCount(const QJsonObject& body) {
+        QRegularExpression countRe("Generate (\\d+) ");
+        for (const QJsonValue &m : body.value("messages").toArray()) {
+            auto match = countRe.match(m.toObject().value("content").toString());
+            if (match.hasMatch()) return match.captured(1).toInt();
+        }
+        return 10;
+    }
+
+    static QByteArray sseEvent(const QString& delta) {
+        QJsonObject deltaObj;
+        deltaObj["content"] = delta;
+        QJsonObject choice;
+        choice["delta"] = deltaObj;
+        QJsonObject chunk;
+        chunk["choices"] = QJsonArray{choice};
+        return "data: " + QJsonDocument(chunk).toJson(QJsonDocument::Compact) + "\n\n";
+    }
+
+    void respond(QTcpSocket* socket, const QJsonObject& body) {
+        if (QRandomGenerator::global()->generateDouble() < opts.failRate) {
+            QByteArray err = "{\"error\":{\"message\":\"mock overload\"}}";
+            socket->write("HTTP/1.1 503 Service Unavailable\r\nContent-Type: application/json\r\nConnection: close\r\n"
+                          "Content-Length: " + QByteArray::number(err.size()) + "\r\n\r\n" + err);
+            socket->disconnectFromHost();
+            return;
+        }
+
+        QString content = nextContent(requestedCount(body));
+        bool stream = body.value("stream").toBool();
+
+        QTimer::singleShot(opts.latencyMs, socket, [this, socket, content, stream]() {
+            if (stream) streamResponse(socket, content);
+            else delayedResponse(socket, content);
+        });
+    }
+
+    void delayedResponse(QTcpSocket* socket, const QString& content) {
+        int tokens = (content.size() + kCharsPerToken - 1) / kCharsPerToken;
+        int generationMs = opts.tokensPerSec > 0 ? static_cast<int>(1000.0 * tokens / opts.tokensPerSec) : 0;
+
+        QTimer::singleShot(generationMs, socket, [socket, content]() {
+            QJsonObject message;
+            message["role"] = "assistant";
+            message["content"] = content;
+            QJsonObject choice;
+            choice["message"] = message;
+            QJsonObject root;
+            root["choices"] = QJsonArray{choice};
+            QByteArray payload = QJsonDocument(root).toJson(QJsonDocument::Compact);
+
+            socket->write("HTTP/1.1 200 OK\r\nContent-Type: application/json\r\nConnection: close\r\n"
+                          "Content-Length: " + QByteArray::number(payload.size()) + "\r\n\r\n" + payload);
+            socket->disconnectFromHost();
+        });
+    }
+
+    void streamResponse(QTcpSocket* socket, const QString& content) {
+        socket->write("HTTP/1.1 200 OK\r\nContent-Type: text/event-stream\r\nCache-Control: no-cache\r\nConnection: close\r\n\r\n");
+
+        auto position = std::make_shared<int>(0);
+        auto budget = std::make_shared<double>(0.0);
+        double tokensPerTick = opts.tokensPerSec > 0 ? opts.tokensPerSec * kTickMs / 1000.0 : 1e9;
+
+        QTimer* timer = new QTimer(socket);
+        QObject::connect(timer, &QTimer::timeout, socket, [socket, timer, content, position, budget, tokensPerTick]() {
+            *budget += tokensPerTick;
+            while (*budget >= 1.0 && *position < content.size()) {
+                socket->write(sseEvent(content.mid(*position, kCharsPerToken)));
+                *position += kCharsPerToken;
+                *budget -= 1.0;
+            }
+            if (*position >= content.size()) {
+                timer->stop();
+                socket->write("data: [DONE]\n\n");
+                socket->disconnectFromHost();
+            }
+        });
+        timer->start(kTickMs);
+    }
+
+    Options opts;
+    QTcpServer server;
+    int wordCounter = 0;
+    int cannedCursor = 0;
+};
+
+}
+
+int main(int argc, char *argv[]) {
+    QCoreApplication app(argc, argv);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Local stand-in for the chat-completions API");
+    parser.addHelpOption();
+    QCommandLineOption portOpt("port", "Port to listen on.", "port", "8089");
+    QCommandLineOption latencyOpt("latency-ms", "Delay before the first byte.", "ms", "300");
+    QCommandLineOption rateOpt("tokens-per-sec", "Generation speed (0 = instant).", "rate", "400");
+    QCommandLineOption failOpt("fail-rate", "Fraction of requests answered with 503.", "fraction", "0");
+    QCommandLineOption cannedOpt("canned", "JSON array of {word, definition} entries to serve.", "file");
+    parser.addOptions({portOpt, latencyOpt, rateOpt, failOpt, cannedOpt});
+    parser.process(app);
+
+    Options opts;
+    opts.latencyMs = parser.value(latencyOpt).toInt();
+    opts.tokensPerSec = parser.value(rateOpt).toDouble();
+    opts.failRate = parser.value(failOpt).toDouble();
+    if (parser.isSet(cannedOpt)) {
+        QFile f(parser.value(cannedOpt));
+        if (!f.open(QIODevice::ReadOnly)) {
+            qCritical() << "Cannot open canned entries file:" << f.fileName();
+            return 1;
+        }
+        opts.canned = QJsonDocument::fromJson(f.readAll()).array();
+    }
+
+    MockServer server(opts);
+    quint16 port = static_cast<quint16>(parser.value(portOpt).toUInt());
+    if (!server.listen(port)) {
+        qCritical() << "Cannot listen on port" << port;
+        return 1;
+    }
+    qInfo().noquote() << QString("Mock LLM endpoint: http://127.0.0.1:%1/v1/chat/completions").arg(port);
+
+    return app.exec();
+}
@@ -0,0 +1,148 @@
+// Microbenchmark for the scheduling policies in schedulerpolicy.h:
+//
+//   scheduler_bench --cards 100000 --updates 10000000 --runs 5
+//
+// Every variant applies the same pseudo-random ratings to the same cards, one pass over the
+// card array after another until --updates updates are done, and reports the best run in
+// ns/update. Besides the batch loops instantiated per policy it times the alternatives they
+// replace: a runtime switch per card, a virtual call per card and SpacedRepetitionCalculator.
+// The interval checksum printed per variant must agree between variants of the same policy.
+
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <QDebug>
+#include <memory>
+#include <random>
+#include <type_traits>
+#include <vector>
+#include "schedulerpolicy.h"
+#include "spacedrepetitioncalculator.h"
+
+namespace {
+
+using Scheduling::CardSchedule;
+
+// Per-card dynamic dispatch, the design the templates avoid
+struct VirtualPolicy {
+    virtual ~VirtualPolicy() {}
+    virtual void review(CardSchedule& card, int quality) const = 0;
+};
+
+template <typename Policy>
+struct VirtualAdapter : VirtualPolicy {
+    explicit VirtualAdapter(const Policy& p) : policy(p) {}
+    void review(CardSchedule& card, int quality) const override { policy.review(card, quality); }
+    Policy policy;
+};
+
+// Built from the runtime config so the compiler cannot see the concrete type at the call site
+std::unique_ptr<VirtualPolicy> makeVirtualPolicy(const Scheduling::PolicyConfig& config) {
+    return Scheduling::dispatch(config, [](const auto& policy) -> std::unique_ptr<VirtualPolicy> {
+        return std::unique_ptr<VirtualPolicy>(new VirtualAdapter<std::decay_t<decltype(policy)>>(policy));
+    });
+}
+
+struct Workload {
+    std::vector<uint8_t> qualities;     // one per update, cycling over the cards
+    size_t cards = 0;
+};
+
+long long checksum(const std::vector<CardSchedule>& cards) {
+    long long sum = 0;
+    for (const auto &c : cards) sum += c.intervalDays + c.repetitions;
+    return sum;
+}
+
+// Runs update(cards, first, count) over the workload in card-sized chunks; returns the best ns/update
+template <typename Update>
+double timeVariant(const char* name, const Workload& work, int runs, Update update) {
+    double best = 0.0;
+    long long sum = 0;
+    for (int run = 0; run < runs; ++run) {
+        std::vector<CardSchedule> cards(work.cards);
+        QElapsedTimer timer;
+        timer.start();
+        for (size_t done = 0; done < work.qualities.size(); done += work.cards) {
+            size_t count = std::min(work.cards, work.qualities.size() - done);
+            update(cards.data(), work.qualities.data() + done, count);
+        }
+        double ns = static_cast<double>(timer.nsecsElapsed()) / static_cast<double>(work.qualities.size());
+        if (run == 0 || ns < best) best = ns;
+        sum = checksum(cards);
+    }
+    qInfo().noquote() << QString("%1 %2 ns/update  %3 M updates/s  checksum %4")
+                         .arg(name, -34).arg(best, 7, 'f', 2).arg(1000.0 / best, 7, 'f', 1).arg(sum);
+    return best;
+}
+
+}
+
+int main(int argc, char *argv[]) {
+    QCoreApplication app(argc, argv);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Scheduling policy microbenchmark");
+    parser.addHelpOption();
+    QCommandLineOption cardsOpt("cards", "Cards in the working set.", "n", "100000");
+    QCommandLineOption updatesOpt("updates", "Card updates per run.", "n", "10000000");
+    QCommandLineOption runsOpt("runs", "Runs per variant (best is reported).", "n", "5");
+    QCommandLineOption firstOpt("first", "First interval of the steps policy.", "days", "2");
+    QCommandLineOption secondOpt("second", "Second interval of the steps policy.", "days", "5");
+    parser.addOptions({cardsOpt, updatesOpt, runsOpt, firstOpt, secondOpt});
+    parser.process(app);
+
+    Workload work;
+    work.cards = static_cast<size_t>(qMax(1, parser.value(cardsOpt).toInt()));
+    long long updates = qMax(1LL, parser.value(updatesOpt).toLongLong());
+    int runs = qMax(1, parser.value(runsOpt).toInt());
+    Scheduling::PolicyConfig sm2;
+    Scheduling::PolicyConfig steps = Scheduling::PolicyConfig::forSteps(parser.value(firstOpt).toInt(), parser.value(secondOpt).toInt());
+
+    // Mostly passes, as in real review logs: 15% again, 15% hard, 50% good, 20% easy
+    std::mt19937 rng(42);
+    std::discrete_distribution<int> rating({15, 0, 0, 15, 50, 20});
+    work.qualities.resize(static_cast<size_t>(updates));
+    for (auto &q : work.qualities) q = static_cast<uint8_t>(rating(rng));
+
+    qInfo().noquote() << QString("%1 updates over %2 cards, best of %3 runs").arg(updates).arg(work.cards).arg(runs);
+
+    timeVariant("sm2: batch (template)", work, runs, [](CardSchedule* cards, const uint8_t* q, size_t n) {
+        Scheduling::reviewBatch(Scheduling::Sm2Policy(), cards, q, n);
+    });
+    timeVariant("sm2: batch (config, one dispatch)", work, runs, [&](CardSchedule* cards, const uint8_t* q, size_t n) {
+        Scheduling::reviewBatch(sm2, cards, q, n);
+    });
+    timeVariant("sm2: dispatch per card", work, runs, [&](CardSchedule* cards, const uint8_t* q, size_t n) {
+        for (size_t i = 0; i < n; ++i) Scheduling::review(sm2, cards[i], q[i]);
+    });
+    std::unique_ptr<VirtualPolicy> virtualSm2 = makeVirtualPolicy(sm2);
+    timeVariant("sm2: virtual call per card", work, runs, [&](CardSchedule* cards, const uint8_t* q, size_t n) {
+        for (size_t i = 0; i < n; ++i) virtualSm2->review(cards[i], q[i]);
+    });
+    timeVariant("sm2: SpacedRepetitionCalculator", work, runs, [](CardSchedule* cards, const uint8_t* q, size_t n) {
+        for (size_t i = 0; i < n; ++i) {
+            SpacedRepetitionCalculator calc;
+            calc.setEasinessFactor(cards[i].easeFactor);
+            calc.setRepetitions(cards[i].repetitions);
+            calc.setInterval(cards[i].intervalDays);
+            calc.calculateNextReview(q[i]);
+            cards[i].easeFactor = calc.getEasinessFactor();
+            cards[i].repetitions = calc.getRepetitions();
+            cards[i].intervalDays = calc.getInterval();
+        }
+    });
+
+    timeVariant("steps: batch (config, one dispatch)", work, runs, [&](CardSchedule* cards, const uint8_t* q, size_t n) {
+        Scheduling::reviewBatch(steps, cards, q, n);
+    });
+    timeVariant("steps: dispatch per card", work, runs, [&](CardSchedule* cards, const uint8_t* q, size_t n) {
+        for (size_t i = 0; i < n; ++i) Scheduling::review(steps, cards[i], q[i]);
+    });
+    std::unique_ptr<VirtualPolicy> virtualSteps = makeVirtualPolicy(steps);
+    timeVariant("steps: virtual call per card", work, runs, [&](CardSchedule* cards, const uint8_t* q, size_t n) {
+        for (size_t i = 0; i < n; ++i) virtualSteps->review(cards[i], q[i]);
+    });
+
+    return 0;
+}
@@ -0,0 +1,18 @@
+QT       += core
+QT       -= gui
+
+CONFIG += c++17 console
+CONFIG -= app_bundle
+
+TARGET = scheduler_bench
+
+APP_SRC = $$PWD/../..
+INCLUDEPATH += $$APP_SRC
+
+SOURCES += \
+    main.cpp \
+    $$APP_SRC/spacedrepetitioncalculator.cpp
+
+HEADERS += \
+    $$APP_SRC/schedulerpolicy.h \
+    $$APP_SRC/spacedrepetitioncalculator.h
@@ -0,0 +1,131 @@
+#include "tracing.h"
+#include <algorithm>
+#include <cstdio>
+#include <sstream>
+
+std::atomic<bool> Tracer::enabledFlag{false};
+std::atomic<Tracer::ActivityStack*> Tracer::watchedStack{nullptr};
+
+namespace {
+void appendJsonString(std::ostringstream& out, const std::string& s) {
+    out << '"';
+    for (char ch : s) {
+        if (ch == '"' || ch == '\\') out << '\\' << ch;
+        else if (static_cast<unsigned char>(ch) < 0x20) out << ' ';
+        else out << ch;
+    }
+    out << '"';
+}
+
+std::string formatMicros(uint64_t ns) {
+    char buf[32];
+    std::snprintf(buf, sizeof(buf), "%.3f", ns / 1000.0);
+    return buf;
+}
+}
+
+Tracer& Tracer::instance() {
+    static Tracer tracer;
+    return tracer;
+}
+
+Tracer::ThreadBuffer& Tracer::localBuffer() {
+    thread_local std::shared_ptr<ThreadBuffer> buffer;
+    if (!buffer) {
+        buffer = std::make_shared<ThreadBuffer>();
+        Tracer &tracer = instance();
+        std::lock_guard<std::mutex> lock(tracer.mutex);
+        buffer->tid = tracer.nextTid++;
+        buffer->name = "thread " + std::to_string(buffer->tid);
+        tracer.buffers.push_back(buffer);
+    }
+    return *buffer;
+}
+
+void Tracer::setEnabled(bool on) {
+    if (on) {
+        clear();
+        std::lock_guard<std::mutex> lock(mutex);
+        recordingStartNs = nowNs();
+    }
+    enabledFlag.store(on, std::memory_order_relaxed);
+}
+
+void Tracer::clear() {
+    std::lock_guard<std::mutex> lock(mutex);
+    for (const auto &buffer : buffers) {
+        std::lock_guard<std::mutex> bufferLock(buffer->mutex);
+        buffer->events.clear();
+        buffer->next = 0;
+        buffer->wrapped = false;
+    }
+}
+
+void Tracer::setThreadName(const std::string& name) {
+    ThreadBuffer &buffer = localBuffer();
+    std::lock_guard<std::mutex> lock(buffer.mutex);
+    buffer.name = name;
+}
+
+void Tracer::record(const char* name, const char* category, uint64_t startNs, uint64_t endNs) {
+    ThreadBuffer &buffer = localBuffer();
+    // Only the exporter ever competes for this lock
+    std::lock_guard<std::mutex> lock(buffer.mutex);
+    Event event{name, category, startNs, endNs > startNs ? endNs - startNs : 0};
+    if (buffer.events.size() < RING_CAPACITY) {
+        buffer.events.push_back(event);
+        return;
+    }
+    buffer.events[buffer.next] = event;
+    buffer.next = (buffer.next + 1) % RING_CAPACITY;
+    buffer.wrapped = true;
+}
+
+std::string Tracer::toChromeJson() const {
+    std::ostringstream out;
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    out << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"tid\":0,\"args\":{\"name\":\"IA_Project\"}}";
+
+    std::lock_guard<std::mutex> lock(mutex);
+    for (const auto &buffer : buffers) {
+        std::lock_guard<std::mutex> bufferLock(buffer->mutex);
+        out << ",{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << buffer->tid << ",\"args\":{\"name\":";
+        appendJsonString(out, buffer->name);
+        out << "}}";
+
+        // Oldest first: after wrapping, the oldest event sits at next
+        size_t count = buffer->events.size();
+        size_t first = buffer->wrapped ? buffer->next : 0;
+        for (size_t i = 0; i < count; ++i) {
+            const Event &e = buffer->events[(first + i) % count];
+            uint64_t start = e.startNs > recordingStartNs ? e.startNs - recordingStartNs : 0;
+            out << ",{\"name\":";
+            appendJsonString(out, e.name);
+            out << ",\"cat\":";
+            appendJsonString(out, e.category);
+            out << ",\"ph\":\"X\",\"pid\":1,\"tid\":" << buffer->tid
+                << ",\"ts\":" << formatMicros(start) << ",\"dur\":" << formatMicros(e.durationNs) << "}";
+        }
+    }
+    out << "]}";
+    return out.str();
+}
+
+void Tracer::watchActivityOfThisThread() {
+    watchedStack.store(&activityStack(), std::memory_order_release);
+}
+
+std::vector<std::string> Tracer::watchedActivity() {
+    std::vector<std::string> names;
+    ActivityStack* stack = watchedStack.load(std::memory_order_acquire);
+    if (!stack) return names;
+
+    // The owner keeps pushing and popping meanwhile, so this is a best-effort snapshot
+    int depth = std::min(stack->depth.load(std::memory_order_acquire), static_cast<int>(ActivityStack::MAX_DEPTH));
+    for (int i = 0; i < depth; ++i) {
+        const char* name = stack->names[i].load(std::memory_order_relaxed);
+        if (name) names.push_back(name);
+    }
+    if (stack->depth.load(std::memory_order_relaxed) > ActivityStack::MAX_DEPTH) names.push_back("...");
+    return names;
+}
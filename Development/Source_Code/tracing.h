@@ -0,0 +1,129 @@
+#ifndef TRACING_H
+#define TRACING_H
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Span tracing exported as Chrome trace-event JSON (chrome://tracing, ui.perfetto.dev).
+// Off by default, where TRACE_SCOPE only pushes its name on the thread's activity stack (read by
+// the stall watchdog). While on, each thread appends complete events to its own ring buffer,
+// overwriting its oldest events once RING_CAPACITY is reached.
+class Tracer
+{
+public:
+    static constexpr size_t RING_CAPACITY = 1 << 15;
+
+    struct Event {
+        const char* name;       // string literals only: events keep the pointer
+        const char* category;
+        uint64_t startNs;
+        uint64_t durationNs;
+    };
+
+    static Tracer& instance();
+
+    static bool enabled() { return enabledFlag.load(std::memory_order_relaxed); }
+    // Turning tracing on starts a fresh recording
+    void setEnabled(bool on);
+    void clear();
+
+    // Names the calling thread in the exported timeline
+    static void setThreadName(const std::string& name);
+
+    static uint64_t nowNs() {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+    }
+    static void record(const char* name, const char* category, uint64_t startNs, uint64_t endNs);
+
+    std::string toChromeJson() const;
+
+    // Names of the spans open on a thread, kept whether or not tracing is enabled
+    struct ActivityStack {
+        static constexpr int MAX_DEPTH = 32;
+        std::atomic<int> depth{0};
+        std::array<std::atomic<const char*>, MAX_DEPTH> names{};
+    };
+
+    static ActivityStack& activityStack() {
+        thread_local ActivityStack stack;
+        return stack;
+    }
+
+    static void pushActivity(const char* name) {
+        ActivityStack &stack = activityStack();
+        int depth = stack.depth.load(std::memory_order_relaxed);
+        if (depth < ActivityStack::MAX_DEPTH) stack.names[depth].store(name, std::memory_order_relaxed);
+        stack.depth.store(depth + 1, std::memory_order_release);
+    }
+
+    static void popActivity() {
+        ActivityStack &stack = activityStack();
+        stack.depth.store(stack.depth.load(std::memory_order_relaxed) - 1, std::memory_order_release);
+    }
+
+    // Makes the calling thread's activity stack readable from other threads via watchedActivity()
+    static void watchActivityOfThisThread();
+    // Open spans of the watched thread, outermost first (empty when no thread is watched)
+    static std::vector<std::string> watchedActivity();
+
+private:
+    struct ThreadBuffer {
+        std::mutex mutex;
+        std::vector<Event> events;
+        size_t next = 0;
+        bool wrapped = false;
+        uint64_t tid = 0;
+        std::string name;
+    };
+
+    Tracer() = default;
+    static ThreadBuffer& localBuffer();
+
+    static std::atomic<bool> enabledFlag;
+    static std::atomic<ActivityStack*> watchedStack;
+
+    mutable std::mutex mutex;
+    std::vector<std::shared_ptr<ThreadBuffer>> buffers;  // kept after their thread exits
+    uint64_t nextTid = 1;
+    uint64_t recordingStartNs = 0;
+};
+
+class TraceSpan
+{
+public:
+    TraceSpan(const char* name, const char* category)
+        : name(name)
+        , category(category)
+        , startNs(Tracer::enabled() ? Tracer::nowNs() : 0) {
+        Tracer::pushActivity(name);
+    }
+
+    ~TraceSpan() {
+        Tracer::popActivity();
+        if (startNs != 0) Tracer::record(name, category, startNs, Tracer::nowNs());
+    }
+
+    TraceSpan(const TraceSpan&) = delete;
+    TraceSpan& operator=(const TraceSpan&) = delete;
+
+private:
+    const char* name;
+    const char* category;
+    uint64_t startNs;
+};
+
+#define TRACE_CONCAT_INNER(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_INNER(a, b)
+
+// Traces the rest of the enclosing scope as `name` (a string literal) in `category`
+#define TRACE_SCOPE_CAT(category, name) TraceSpan TRACE_CONCAT(traceSpan_, __LINE__)(name, category)
+#define TRACE_SCOPE(name) TRACE_SCOPE_CAT("ui", name)
+
+#endif // TRACING_H
@@ -0,0 +1,39 @@
+#include "tracingapplication.h"
+#include "tracing.h"
+#include <QEvent>
+
+namespace {
+// Span name for the event types worth seeing next to the application spans
+const char* spanName(QEvent::Type type) {
+    switch (type) {
+    case QEvent::LayoutRequest: return "qt.layout";
+    case QEvent::Polish:
+    case QEvent::PolishRequest: return "qt.polish";
+    case QEvent::Resize: return "qt.resize";
+    case QEvent::Show: return "qt.show";
+    case QEvent::Paint: return "qt.paint";
+    case QEvent::UpdateRequest: return "qt.updateRequest";
+    case QEvent::MouseButtonPress:
+    case QEvent::MouseButtonRelease:
+    case QEvent::MouseButtonDblClick: return "qt.mouse";
+    case QEvent::KeyPress:
+    case QEvent::KeyRelease: return "qt.key";
+    default: return nullptr;
+    }
+}
+}
+
+TracingApplication::TracingApplication(int &argc, char **argv)
+    : QApplication(argc, argv) {
+    Tracer::setThreadName("UI");
+}
+
+bool TracingApplication::notify(QObject *receiver, QEvent *event) {
+    if (!Tracer::enabled()) return QApplication::notify(receiver, event);
+
+    const char* name = spanName(event->type());
+    if (!name) return QApplication::notify(receiver, event);
+
+    TRACE_SCOPE_CAT("qt", name);
+    return QApplication::notify(receiver, event);
+}
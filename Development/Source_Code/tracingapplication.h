@@ -0,0 +1,18 @@
+#ifndef TRACINGAPPLICATION_H
+#define TRACINGAPPLICATION_H
+
+#include <QApplication>
+
+// QApplication that adds Qt's own work to the trace timeline: layout, polish, resize,
+// paint and input events become "qt" spans while tracing is enabled.
+class TracingApplication : public QApplication
+{
+    Q_OBJECT
+
+public:
+    TracingApplication(int &argc, char **argv);
+
+    bool notify(QObject *receiver, QEvent *event) override;
+};
+
+#endif // TRACINGAPPLICATION_H